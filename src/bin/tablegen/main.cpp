@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file tablegen/main.cpp
+ * @short Main file of the table generator
+ */
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+#include <logic/evaluatortable.h>
+#include <logic/preflopequitytable.h>
+
+/**
+ * @brief Print the usage of the tool
+ * @param stream stream used to print.
+ */
+static void printUsage(QTextStream &stream)
+{
+    stream << "Usage: pokqt-tablegen [--preflop] [--verify] [file]" << endl;
+    stream << "Generate or verify the precomputed evaluator table." << endl;
+    stream << "The default file is " << EvaluatorTable::defaultFileName() << endl;
+    stream << "With --preflop, generate or verify the preflop equity table instead." << endl;
+    stream << "The default file is preflopequity.table" << endl;
+}
+
+/**
+ * @brief Table generator main
+ * @param argc argc.
+ * @param argv argv.
+ * @return exit code.
+ */
+int main(int argc, char **argv)
+{
+    QCoreApplication app (argc, argv);
+    QTextStream out (stdout);
+
+    bool verify = false;
+    bool preflop = false;
+    QString fileName;
+    QStringList arguments = app.arguments();
+    arguments.removeFirst();
+    foreach (const QString &argument, arguments) {
+        if (argument == QLatin1String("--verify")) {
+            verify = true;
+        } else if (argument == QLatin1String("--preflop")) {
+            preflop = true;
+        } else if (argument.startsWith(QLatin1String("-"))) {
+            printUsage(out);
+            return argument == QLatin1String("--help") ? 0 : 1;
+        } else {
+            fileName = argument;
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (preflop) {
+        if (fileName.isEmpty()) {
+            fileName = QLatin1String("preflopequity.table");
+        }
+
+        if (verify) {
+            if (!PreflopEquityTable::verify(fileName)) {
+                out << fileName << " is not a valid preflop equity table" << endl;
+                return 1;
+            }
+            out << fileName << " verified in " << timer.elapsed() << " ms" << endl;
+            return 0;
+        }
+
+        out << "Generating the preflop equities of " << PreflopEquityTable::ClassCount
+            << " classes in " << fileName << endl;
+        if (!PreflopEquityTable::generate(fileName)) {
+            out << "Failed to generate " << fileName << endl;
+            return 1;
+        }
+        out << "Generated in " << timer.elapsed() << " ms" << endl;
+        return 0;
+    }
+
+    if (fileName.isEmpty()) {
+        fileName = EvaluatorTable::defaultFileName();
+    }
+
+    if (verify) {
+        if (!EvaluatorTable::verify(fileName)) {
+            out << fileName << " is not a valid evaluator table" << endl;
+            return 1;
+        }
+        out << fileName << " verified in " << timer.elapsed() << " ms" << endl;
+        return 0;
+    }
+
+    out << "Generating " << EvaluatorTable::EntryCount << " entries in " << fileName << endl;
+    if (!EvaluatorTable::generate(fileName)) {
+        out << "Failed to generate " << fileName << endl;
+        return 1;
+    }
+    out << "Generated in " << timer.elapsed() << " ms" << endl;
+    return 0;
+}
@@ -0,0 +1,11 @@
+TEMPLATE = app
+TARGET = pokqt-tablegen
+
+QT = core
+CONFIG += console c++11
+INCLUDEPATH+=../../lib/
+unix: LIBS+=-L../../lib/ -lpokqt
+win32: LIBS+=-L../../lib/release -lpokqt
+
+SOURCES += \
+    main.cpp
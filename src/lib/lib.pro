@@ -2,6 +2,7 @@ TEMPLATE = lib
 TARGET = pokqt
 
 QT = core network
+CONFIG += c++11
 
 DEFINES += POKQT_LIBRARY
 
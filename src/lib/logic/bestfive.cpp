@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file bestfive.cpp
+ * @short Implementation of BestFive
+ */
+
+#include "bestfive.h"
+#include "bitops.h"
+#include "handkernels.h"
+
+BestFive::BestFive()
+    : m_count(0), m_category(HandEvaluator::HighCard)
+{
+}
+
+BestFive::BestFive(CardSet cards)
+    : m_count(0), m_category(HandEvaluator::HighCard)
+{
+    for (int category = HandEvaluator::StraightFlush; category > HandEvaluator::HighCard;
+         category--) {
+        if (extract(cards, HandEvaluator::Category(category))) {
+            appendKickers(cards);
+            return;
+        }
+    }
+
+    extract(cards, HandEvaluator::HighCard);
+    appendKickers(cards);
+}
+
+BestFive BestFive::combo(CardSet cards, HandEvaluator::Category category)
+{
+    BestFive bestFive;
+    bestFive.extract(cards, category);
+    return bestFive;
+}
+
+CardSet BestFive::cardSet() const
+{
+    CardSet cards;
+    for (int i = 0; i < m_count; i++) {
+        cards.insert(m_cards[i]);
+    }
+    return cards;
+}
+
+QList<Card> BestFive::toList() const
+{
+    QList<Card> cards;
+    cards.reserve(m_count);
+    for (int i = 0; i < m_count; i++) {
+        cards.append(m_cards[i].toCard());
+    }
+    return cards;
+}
+
+bool BestFive::extract(CardSet cards, HandEvaluator::Category category)
+{
+    m_count = 0;
+    m_category = category;
+
+    const quint16 clubs = cards.suitMask(0);
+    const quint16 diamonds = cards.suitMask(1);
+    const quint16 hearts = cards.suitMask(2);
+    const quint16 spades = cards.suitMask(3);
+
+    // Ranks that are present in at least one, two, three and four suits
+    const quint16 ranks = clubs | diamonds | hearts | spades;
+    const quint16 pairs = (clubs & (diamonds | hearts | spades))
+                          | (diamonds & (hearts | spades)) | (hearts & spades);
+    const quint16 threes = ((clubs & diamonds) & (hearts | spades))
+                           | ((hearts & spades) & (clubs | diamonds));
+    const quint16 fours = clubs & diamonds & hearts & spades;
+
+    switch (category) {
+    case HandEvaluator::StraightFlush: {
+        // Suits are checked from the highest, so that the highest
+        // suit is kept if two suits have the same straight
+        int bestHigh = -1;
+        int bestSuit = -1;
+        int suits = flushSuits(cards.mask());
+        while (suits != 0) {
+            int suit = highestBit(suits);
+            int high = straightHighCard(cards.suitMask(suit));
+            if (high > bestHigh) {
+                bestHigh = high;
+                bestSuit = suit;
+            }
+            suits &= ~(1 << suit);
+        }
+        if (bestHigh == -1) {
+            return false;
+        }
+        for (int i = 0; i < 5; i++) {
+            int rank = bestHigh - i >= 0 ? bestHigh - i : 12;
+            m_cards[m_count++] = PackedCard(Card::Suit(bestSuit + Card::Club), rank);
+        }
+        return true;
+    }
+    case HandEvaluator::Four:
+        if (fours == 0) {
+            return false;
+        }
+        appendRank(cards, highestBit(fours), 4);
+        return true;
+    case HandEvaluator::FullHouse: {
+        if (threes == 0) {
+            return false;
+        }
+        int three = highestBit(threes);
+        const quint16 otherPairs = pairs & ~(1 << three);
+        if (otherPairs == 0) {
+            return false;
+        }
+        appendRank(cards, three, 3);
+        appendRank(cards, highestBit(otherPairs), 2);
+        return true;
+    }
+    case HandEvaluator::Flush: {
+        // The highest flush is the one with the highest five cards
+        quint16 bestMask = 0;
+        int bestSuit = -1;
+        int suits = flushSuits(cards.mask());
+        while (suits != 0) {
+            int suit = highestBit(suits);
+            quint16 mask = cards.suitMask(suit);
+            while (bitCount(mask) > 5) {
+                mask &= mask - 1;
+            }
+            if (mask > bestMask) {
+                bestMask = mask;
+                bestSuit = suit;
+            }
+            suits &= ~(1 << suit);
+        }
+        if (bestSuit == -1) {
+            return false;
+        }
+        while (bestMask != 0) {
+            int rank = highestBit(bestMask);
+            m_cards[m_count++] = PackedCard(Card::Suit(bestSuit + Card::Club), rank);
+            bestMask &= ~(1 << rank);
+        }
+        return true;
+    }
+    case HandEvaluator::Straight: {
+        int high = straightHighCard(ranks);
+        if (high == -1) {
+            return false;
+        }
+        for (int i = 0; i < 5; i++) {
+            appendRank(cards, high - i >= 0 ? high - i : 12, 1);
+        }
+        return true;
+    }
+    case HandEvaluator::Three:
+        if (threes == 0) {
+            return false;
+        }
+        appendRank(cards, highestBit(threes), 3);
+        return true;
+    case HandEvaluator::TwoPairs: {
+        if (bitCount(pairs) < 2) {
+            return false;
+        }
+        int firstPair = highestBit(pairs);
+        appendRank(cards, firstPair, 2);
+        appendRank(cards, highestBit(pairs & ~(1 << firstPair)), 2);
+        return true;
+    }
+    case HandEvaluator::Pair:
+        if (pairs == 0) {
+            return false;
+        }
+        appendRank(cards, highestBit(pairs), 2);
+        return true;
+    case HandEvaluator::HighCard:
+        if (ranks == 0) {
+            return false;
+        }
+        appendRank(cards, highestBit(ranks), 1);
+        return true;
+    }
+    return false;
+}
+
+void BestFive::appendRank(CardSet cards, int rank, int n)
+{
+    for (int suit = Card::Spade; suit >= Card::Club && n > 0; suit--) {
+        PackedCard card(Card::Suit(suit), rank);
+        if (cards.contains(card)) {
+            m_cards[m_count++] = card;
+            n--;
+        }
+    }
+}
+
+void BestFive::appendKickers(CardSet cards)
+{
+    quint16 usedRanks = 0;
+    for (int i = 0; i < m_count; i++) {
+        usedRanks |= 1 << m_cards[i].rank();
+    }
+
+    quint16 kickers = cards.rankMask() & ~usedRanks;
+    while (m_count < MaxCardCount && kickers != 0) {
+        int rank = highestBit(kickers);
+        appendRank(cards, rank, 1);
+        kickers &= ~(1 << rank);
+    }
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef BESTFIVE_H
+#define BESTFIVE_H
+
+/**
+ * @file bestfive.h
+ * @short Definition of BestFive
+ */
+
+#include "pokqt_global.h"
+#include <QtCore/QList>
+#include "card.h"
+#include "cardset.h"
+#include "handevaluator.h"
+#include "packedcard.h"
+
+/**
+ * @brief The best five cards of a hand
+ *
+ * This class extracts the cards that make a poker hand,
+ * together with the category of the hand. The cards are
+ * computed from the rank masks of the suits of a CardSet,
+ * and are stored in a fixed-size array, so extracting them
+ * do not allocate memory.
+ *
+ * The cards of the combo come first, followed by the kickers
+ * in descending order. For example, the two pairs 7 7 4 4 with a
+ * K are stored as 7 7 4 4 K. When several cards of the same rank
+ * can be used, the ones with the highest suits are chosen. The
+ * 5432A straight is stored with the ace at the end.
+ *
+ * With at most 7 cards, category() is the same as the category
+ * provided by HandEvaluator.
+ */
+class POKQTSHARED_EXPORT BestFive
+{
+public:
+    enum {
+        /**
+         * @brief Maximum number of cards
+         */
+        MaxCardCount = 5
+    };
+    /**
+     * @brief Default constructor
+     *
+     * This constructor creates an empty set of cards, with
+     * the HandEvaluator::HighCard category.
+     */
+    explicit BestFive();
+    /**
+     * @brief Constructor
+     *
+     * This constructor extracts the best five cards from a set
+     * of cards. If there are less than five cards, all the cards
+     * are used.
+     *
+     * @param cards cards of the hand.
+     */
+    explicit BestFive(CardSet cards);
+    /**
+     * @brief Extract a combo
+     *
+     * Only the cards of the combo are extracted, without kickers. If
+     * the cards contains a better combo, the requested combo is still
+     * extracted if it is present: a four contains a three and a pair,
+     * and a full house contains a three and a pair.
+     *
+     * For HandEvaluator::HighCard, the highest card is extracted.
+     *
+     * @param cards cards of the hand.
+     * @param category category of the combo to extract.
+     * @return the most powerful combo of the given category, or an empty set
+     * of cards if there is no such combo.
+     */
+    static BestFive combo(CardSet cards, HandEvaluator::Category category);
+    /**
+     * @brief Category of the hand
+     * @return category of the hand.
+     */
+    inline HandEvaluator::Category category() const
+    {
+        return HandEvaluator::Category(m_category);
+    }
+    /**
+     * @brief Get if there are no cards
+     * @return if there are no cards.
+     */
+    inline bool isEmpty() const
+    {
+        return m_count == 0;
+    }
+    /**
+     * @brief Number of cards
+     * @return number of cards, between 0 and 5.
+     */
+    inline int count() const
+    {
+        return m_count;
+    }
+    /**
+     * @brief Card at a given position
+     * @param i position of the card, between 0 and count() - 1.
+     * @return card at the given position.
+     */
+    inline PackedCard at(int i) const
+    {
+        Q_ASSERT(i >= 0 && i < m_count);
+        return m_cards[i];
+    }
+    /**
+     * @brief Cards as a CardSet
+     * @return cards, as a CardSet.
+     */
+    CardSet cardSet() const;
+    /**
+     * @brief Cards as a list
+     * @return cards, in the order of this class.
+     */
+    QList<Card> toList() const;
+private:
+    /**
+     * @internal
+     * @brief Extract the cards of a combo
+     * @param cards cards of the hand.
+     * @param category category of the combo to extract.
+     * @return if the combo is present.
+     */
+    bool extract(CardSet cards, HandEvaluator::Category category);
+    /**
+     * @internal
+     * @brief Append cards of a given rank
+     *
+     * The cards with the highest suits are appended first.
+     *
+     * @param cards cards of the hand.
+     * @param rank rank of the cards to append.
+     * @param n maximum number of cards to append.
+     */
+    void appendRank(CardSet cards, int rank, int n);
+    /**
+     * @internal
+     * @brief Append kickers until there are five cards
+     *
+     * The ranks already used by the combo are not used as kickers.
+     *
+     * @param cards cards of the hand.
+     */
+    void appendKickers(CardSet cards);
+    /**
+     * @internal
+     * @brief Cards
+     */
+    PackedCard m_cards[MaxCardCount];
+    /**
+     * @internal
+     * @brief Number of cards
+     */
+    quint8 m_count;
+    /**
+     * @internal
+     * @brief Category
+     */
+    quint8 m_category;
+};
+
+#endif // BESTFIVE_H
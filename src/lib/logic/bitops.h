@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef BITOPS_H
+#define BITOPS_H
+
+/**
+ * @file bitops.h
+ * @short Bit manipulation helpers
+ *
+ * These helpers are used by the card sets and by the
+ * hand evaluators, that work on masks of cards and ranks.
+ * They use the compiler builtins when they are available
+ * and fallback to portable implementations otherwise.
+ */
+
+#include <QtCore/qglobal.h>
+
+/**
+ * @brief Count the bits that are set in a mask
+ * @param mask mask to check.
+ * @return number of bits set.
+ */
+inline int bitCount(quint64 mask)
+{
+#if defined(Q_CC_GNU)
+    return __builtin_popcountll(mask);
+#else
+    mask = mask - ((mask >> 1) & Q_UINT64_C(0x5555555555555555));
+    mask = (mask & Q_UINT64_C(0x3333333333333333)) + ((mask >> 2) & Q_UINT64_C(0x3333333333333333));
+    mask = (mask + (mask >> 4)) & Q_UINT64_C(0x0f0f0f0f0f0f0f0f);
+    return (mask * Q_UINT64_C(0x0101010101010101)) >> 56;
+#endif
+}
+
+/**
+ * @brief Get the index of the lowest bit that is set
+ *
+ * The mask should not be 0.
+ *
+ * @param mask mask to check.
+ * @return index of the lowest bit that is set.
+ */
+inline int lowestBit(quint64 mask)
+{
+    Q_ASSERT(mask != 0);
+#if defined(Q_CC_GNU)
+    return __builtin_ctzll(mask);
+#else
+    return bitCount((mask & (~mask + 1)) - 1);
+#endif
+}
+
+/**
+ * @brief Get the index of the highest bit that is set
+ *
+ * The mask should not be 0.
+ *
+ * @param mask mask to check.
+ * @return index of the highest bit that is set.
+ */
+inline int highestBit(quint64 mask)
+{
+    Q_ASSERT(mask != 0);
+#if defined(Q_CC_GNU)
+    return 63 - __builtin_clzll(mask);
+#else
+    int index = 0;
+    while (mask >>= 1) {
+        ++index;
+    }
+    return index;
+#endif
+}
+
+/**
+ * @brief Get the index of the n-th bit that is set
+ *
+ * The bits are counted from the lowest one, starting from 0,
+ * and the mask should have more than n bits set. The bit is
+ * found with a binary search on the number of bits set in each
+ * half, then by clearing the lowest bits of the remaining byte.
+ *
+ * @param mask mask to check.
+ * @param n index of the bit among the bits that are set.
+ * @return index of the n-th bit that is set.
+ */
+inline int selectBit(quint64 mask, int n)
+{
+    Q_ASSERT(n >= 0 && n < bitCount(mask));
+    int offset = 0;
+    for (int width = 32; width >= 8; width >>= 1) {
+        const int lowCount = bitCount(mask & ((Q_UINT64_C(1) << width) - 1));
+        if (n >= lowCount) {
+            n -= lowCount;
+            mask >>= width;
+            offset += width;
+        }
+    }
+    for (; n > 0; n--) {
+        mask &= mask - 1;
+    }
+    return offset + lowestBit(mask);
+}
+
+/**
+ * @brief Compute a binomial coefficient
+ * @param n number of elements.
+ * @param k number of elements to choose.
+ * @return number of subsets of k elements among n elements.
+ */
+Q_DECL_CONSTEXPR inline quint64 binomial(quint64 n, int k)
+{
+    return k < 0 || quint64(k) > n ? 0 : (k == 0 ? 1 : binomial(n, k - 1) * (n - k + 1) / k);
+}
+
+/**
+ * @brief Get the number of a card from its bit
+ *
+ * In a card mask, each suit uses 16 bits, but only the 13
+ * lowest are used by the ranks. Card numbers are dense, from
+ * 0 to 51 (suit index * 13 + rank), which is better suited
+ * for indexing tables and enumerating combinations.
+ *
+ * @param bit bit of the card in a card mask.
+ * @return number of the card.
+ */
+Q_DECL_CONSTEXPR inline int cardNumber(int bit)
+{
+    return bit - 3 * (bit >> 4);
+}
+
+/**
+ * @brief Get the bit of a card from its number
+ *
+ * This is the opposite of cardNumber().
+ *
+ * @param number number of the card, between 0 and 51.
+ * @return bit of the card in a card mask.
+ */
+Q_DECL_CONSTEXPR inline int cardNumberBit(int number)
+{
+    return number + 3 * (number / 13);
+}
+
+#endif // BITOPS_H
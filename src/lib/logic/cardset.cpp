@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file cardset.cpp
+ * @short Implementation of CardSet
+ */
+
+#include "cardset.h"
+
+const quint16 CardSet::SuitMask;
+const quint64 CardSet::FullMask;
+
+CardSet::CardSet(const QList<Card> &cards)
+    : m_mask(0)
+{
+    foreach (const Card &card, cards) {
+        insert(PackedCard(card));
+    }
+}
+
+QList<Card> CardSet::toList() const
+{
+    QList<Card> cards;
+    for (const_iterator i = begin(); i != end(); ++i) {
+        cards.append((*i).toCard());
+    }
+    return cards;
+}
+
+QDataStream &operator <<(QDataStream &stream, CardSet cardSet)
+{
+    stream << cardSet.mask();
+    return stream;
+}
+
+QDataStream &operator >>(QDataStream &stream, CardSet &cardSet)
+{
+    quint64 mask;
+    stream >> mask;
+    cardSet = CardSet(mask);
+    return stream;
+}
@@ -0,0 +1,474 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef CARDSET_H
+#define CARDSET_H
+
+/**
+ * @file cardset.h
+ * @short Definition of CardSet
+ */
+
+#include "pokqt_global.h"
+#include <QtCore/QDataStream>
+#include <QtCore/QList>
+#include "bitops.h"
+#include "card.h"
+#include "packedcard.h"
+
+/**
+ * @brief A set of cards
+ *
+ * This class represents a set of cards, like the cards
+ * held by a player, the cards in the middle of the table,
+ * or the cards that are known to be dead.
+ *
+ * It is stored as a 64-bit mask, that is divided in four
+ * blocks of 16 bits, one per suit (clubs in the lowest block,
+ * spades in the highest one). In each block, the 13 lowest
+ * bits are used to store the ranks, so the bit of a card is
+ * suitIndex * 16 + rank.
+ *
+ * With this representation, union, intersection, test of
+ * presence and counting cards are done in constant time,
+ * without any allocation, and the ranks of a given suit are
+ * obtained with a shift.
+ *
+ * Iterating over a card set provides the cards by increasing
+ * bit, so all the clubs are provided first, ordered by rank, then
+ * the diamonds etc.
+ */
+class CardSet
+{
+public:
+    /**
+     * @brief Iterator over the cards of a set
+     *
+     * This iterator provides PackedCard objects.
+     */
+    class const_iterator
+    {
+    public:
+        /**
+         * @brief Default constructor
+         * @param mask remaining cards to iterate over.
+         */
+        Q_DECL_CONSTEXPR explicit const_iterator(quint64 mask = 0)
+            : m_mask(mask)
+        {
+        }
+        /**
+         * @brief Get the current card
+         * @return current card.
+         */
+        PackedCard operator*() const
+        {
+            return CardSet::cardAt(lowestBit(m_mask));
+        }
+        /**
+         * @brief Go to the next card
+         * @return reference to this iterator.
+         */
+        const_iterator & operator++()
+        {
+            m_mask &= m_mask - 1;
+            return *this;
+        }
+        /**
+         * @brief Equality
+         * @param other other iterator to compare with.
+         * @return if the two iterators are equal.
+         */
+        Q_DECL_CONSTEXPR bool operator==(const const_iterator &other) const
+        {
+            return m_mask == other.m_mask;
+        }
+        /**
+         * @brief Inequality
+         * @param other other iterator to compare with.
+         * @return if the two iterators are not equal.
+         */
+        Q_DECL_CONSTEXPR bool operator!=(const const_iterator &other) const
+        {
+            return m_mask != other.m_mask;
+        }
+    private:
+        /**
+         * @internal
+         * @brief Remaining cards
+         */
+        quint64 m_mask;
+    };
+    /**
+     * @brief Iterator over the cards of a set
+     *
+     * Card sets can only be iterated in read only mode.
+     */
+    typedef const_iterator iterator;
+    /**
+     * @brief Mask of a suit block
+     */
+    static const quint16 SuitMask = 0x1fff;
+    /**
+     * @brief Mask of all the 52 cards
+     */
+    static const quint64 FullMask = Q_UINT64_C(0x1fff1fff1fff1fff);
+    /**
+     * @brief Default constructor
+     *
+     * This constructor creates an empty set.
+     */
+    Q_DECL_CONSTEXPR CardSet()
+        : m_mask(0)
+    {
+    }
+    /**
+     * @brief Constructor from a mask
+     *
+     * Bits that do not represent a card are ignored.
+     *
+     * @param mask mask to set.
+     */
+    Q_DECL_CONSTEXPR explicit CardSet(quint64 mask)
+        : m_mask(mask & FullMask)
+    {
+    }
+    /**
+     * @brief Constructor from a card
+     *
+     * If the card is invalid, an empty set is created.
+     *
+     * @param card card to put in the set.
+     */
+    Q_DECL_CONSTEXPR explicit CardSet(PackedCard card)
+        : m_mask(cardMask(card))
+    {
+    }
+    /**
+     * @brief Constructor from a list of cards
+     *
+     * Invalid cards are ignored.
+     *
+     * @param cards cards to put in the set.
+     */
+    explicit CardSet(const QList<Card> &cards);
+    /**
+     * @brief Get a set containing all the 52 cards
+     * @return a set containing all the cards.
+     */
+    static Q_DECL_CONSTEXPR CardSet fullDeck()
+    {
+        return CardSet(FullMask);
+    }
+    /**
+     * @brief Get the mask of a card
+     * @param card card.
+     * @return the mask with only the bit of the card set, or 0 if the card is invalid.
+     */
+    static Q_DECL_CONSTEXPR quint64 cardMask(PackedCard card)
+    {
+        return card.isValid() ? Q_UINT64_C(1) << cardBit(card) : 0;
+    }
+    /**
+     * @brief Get the bit of a card
+     *
+     * The card should be valid.
+     *
+     * @param card card.
+     * @return the bit used for the card.
+     */
+    static Q_DECL_CONSTEXPR int cardBit(PackedCard card)
+    {
+        return (card.suitIndex() << 4) | card.rank();
+    }
+    /**
+     * @brief Get the card for a given bit
+     * @param bit bit of the card.
+     * @return the card for this bit.
+     */
+    static Q_DECL_CONSTEXPR PackedCard cardAt(int bit)
+    {
+        return (bit & 0xf) <= 12 ? PackedCard(((bit & 0xf) << 2) | (bit >> 4)) : PackedCard();
+    }
+    /**
+     * @brief Get the mask
+     * @return the mask representing this set.
+     */
+    Q_DECL_CONSTEXPR quint64 mask() const
+    {
+        return m_mask;
+    }
+    /**
+     * @brief Get if the set is empty
+     * @return if the set is empty.
+     */
+    Q_DECL_CONSTEXPR bool isEmpty() const
+    {
+        return m_mask == 0;
+    }
+    /**
+     * @brief Get the number of cards in the set
+     * @return number of cards in the set.
+     */
+    int count() const
+    {
+        return bitCount(m_mask);
+    }
+    /**
+     * @brief Get if the set contains a card
+     * @param card card to check.
+     * @return if the set contains the card.
+     */
+    Q_DECL_CONSTEXPR bool contains(PackedCard card) const
+    {
+        return card.isValid() && (m_mask & cardMask(card)) != 0;
+    }
+    /**
+     * @brief Get if the set contains all the cards of another set
+     * @param other other set.
+     * @return if the other set is included in this set.
+     */
+    Q_DECL_CONSTEXPR bool contains(CardSet other) const
+    {
+        return (m_mask & other.m_mask) == other.m_mask;
+    }
+    /**
+     * @brief Get if the set shares cards with another set
+     * @param other other set.
+     * @return if the two sets have cards in common.
+     */
+    Q_DECL_CONSTEXPR bool intersects(CardSet other) const
+    {
+        return (m_mask & other.m_mask) != 0;
+    }
+    /**
+     * @brief Add a card
+     * @param card card to add.
+     */
+    void insert(PackedCard card)
+    {
+        m_mask |= cardMask(card);
+    }
+    /**
+     * @brief Remove a card
+     * @param card card to remove.
+     */
+    void remove(PackedCard card)
+    {
+        m_mask &= ~cardMask(card);
+    }
+    /**
+     * @brief Remove all the cards
+     */
+    void clear()
+    {
+        m_mask = 0;
+    }
+    /**
+     * @brief Get the ranks of a given suit
+     * @param suitIndex index of the suit, between 0 (club) and 3 (spade).
+     * @return a 13-bit mask of the ranks of the given suit.
+     */
+    Q_DECL_CONSTEXPR quint16 suitMask(int suitIndex) const
+    {
+        return (m_mask >> (suitIndex << 4)) & SuitMask;
+    }
+    /**
+     * @brief Get the ranks of a given suit
+     * @param suit the suit.
+     * @return a 13-bit mask of the ranks of the given suit.
+     */
+    Q_DECL_CONSTEXPR quint16 suitMask(Card::Suit suit) const
+    {
+        return suit >= Card::Club && suit <= Card::Spade ? suitMask(suit - Card::Club) : 0;
+    }
+    /**
+     * @brief Get the ranks of all the cards
+     * @return a 13-bit mask of the ranks that are present in the set.
+     */
+    Q_DECL_CONSTEXPR quint16 rankMask() const
+    {
+        return suitMask(0) | suitMask(1) | suitMask(2) | suitMask(3);
+    }
+    /**
+     * @brief Get the first card
+     *
+     * The first card is the card with the lowest bit.
+     *
+     * @return the first card, or an invalid card if the set is empty.
+     */
+    PackedCard first() const
+    {
+        return isEmpty() ? PackedCard() : cardAt(lowestBit(m_mask));
+    }
+    /**
+     * @brief Take the first card
+     *
+     * The first card is the card with the lowest bit.
+     *
+     * @return the first card, that is removed from the set.
+     */
+    PackedCard takeFirst()
+    {
+        PackedCard card = first();
+        m_mask &= m_mask - 1;
+        return card;
+    }
+    /**
+     * @brief Get the cards as a list
+     * @return list of cards of this set.
+     */
+    QList<Card> toList() const;
+    /**
+     * @brief Get an iterator to the first card
+     * @return an iterator to the first card.
+     */
+    Q_DECL_CONSTEXPR const_iterator begin() const
+    {
+        return const_iterator(m_mask);
+    }
+    /**
+     * @brief Get an iterator past the last card
+     * @return an iterator past the last card.
+     */
+    Q_DECL_CONSTEXPR const_iterator end() const
+    {
+        return const_iterator();
+    }
+    /**
+     * @brief Equality
+     * @param other other CardSet to compare with.
+     * @return if the two CardSet are equal.
+     */
+    Q_DECL_CONSTEXPR bool operator==(CardSet other) const
+    {
+        return m_mask == other.m_mask;
+    }
+    /**
+     * @brief Inequality
+     * @param other other CardSet to compare with.
+     * @return if the two CardSet are not equal.
+     */
+    Q_DECL_CONSTEXPR bool operator!=(CardSet other) const
+    {
+        return m_mask != other.m_mask;
+    }
+    /**
+     * @brief Union
+     * @param other other set.
+     * @return the union of the two sets.
+     */
+    Q_DECL_CONSTEXPR CardSet operator|(CardSet other) const
+    {
+        return CardSet(m_mask | other.m_mask);
+    }
+    /**
+     * @brief Intersection
+     * @param other other set.
+     * @return the intersection of the two sets.
+     */
+    Q_DECL_CONSTEXPR CardSet operator&(CardSet other) const
+    {
+        return CardSet(m_mask & other.m_mask);
+    }
+    /**
+     * @brief Difference
+     * @param other other set.
+     * @return the cards of this set that are not in the other set.
+     */
+    Q_DECL_CONSTEXPR CardSet operator-(CardSet other) const
+    {
+        return CardSet(m_mask & ~other.m_mask);
+    }
+    /**
+     * @brief Complement
+     * @return the cards of the deck that are not in this set.
+     */
+    Q_DECL_CONSTEXPR CardSet operator~() const
+    {
+        return CardSet(~m_mask);
+    }
+    /**
+     * @brief Union
+     * @param other other set.
+     * @return reference to this object.
+     */
+    CardSet & operator|=(CardSet other)
+    {
+        m_mask |= other.m_mask;
+        return *this;
+    }
+    /**
+     * @brief Intersection
+     * @param other other set.
+     * @return reference to this object.
+     */
+    CardSet & operator&=(CardSet other)
+    {
+        m_mask &= other.m_mask;
+        return *this;
+    }
+    /**
+     * @brief Difference
+     * @param other other set.
+     * @return reference to this object.
+     */
+    CardSet & operator-=(CardSet other)
+    {
+        m_mask &= ~other.m_mask;
+        return *this;
+    }
+private:
+    /**
+     * @internal
+     * @brief Mask
+     */
+    quint64 m_mask;
+};
+
+Q_DECLARE_TYPEINFO(CardSet, Q_PRIMITIVE_TYPE);
+
+/**
+ * @brief Serialize a CardSet in a QDataStream
+ * @param stream stream used to serialize.
+ * @param cardSet object to serialize.
+ * @return a reference to the stream with the serialized object.
+ */
+QDataStream &operator <<(QDataStream &stream, CardSet cardSet);
+/**
+ * @brief Deserialize a CardSet from a QDataStream
+ * @param stream stream used to deserialize.
+ * @param cardSet reference to the object that is used to store deserialized data.
+ * @return a reference to the stream without the serialized object.
+ */
+QDataStream &operator >>(QDataStream &stream, CardSet &cardSet);
+
+#endif // CARDSET_H
@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file chachagenerator.cpp
+ * @short Implementation of ChaChaGenerator
+ */
+
+#include "chachagenerator.h"
+#include <QtCore/QFile>
+#include <QtCore/QThreadStorage>
+#include <cstring>
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <bcrypt.h>
+#elif defined(Q_OS_LINUX)
+#include <errno.h>
+#include <sys/random.h>
+#endif
+
+/**
+ * @internal
+ * @brief CHACHA_CONSTANTS
+ *
+ * Constant representing the first words of a ChaCha20
+ * input block, "expand 32-byte k".
+ */
+static const quint32 CHACHA_CONSTANTS[4] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+/**
+ * @internal
+ * @brief BLOCKS_PER_BUFFER
+ *
+ * Constant representing the number of ChaCha20 blocks of a
+ * buffer, a block being 8 64-bit numbers.
+ */
+static const int BLOCKS_PER_BUFFER = ChaChaGenerator::BufferSize / 8;
+
+/**
+ * @internal
+ * @brief Generators of the threads
+ */
+static QThreadStorage<ChaChaGenerator *> threadGenerators;
+
+/**
+ * @internal
+ * @brief Rotate bits to the left
+ * @param value value to rotate.
+ * @param count number of bits.
+ * @return the rotated value.
+ */
+static inline quint32 rotateLeft(quint32 value, int count)
+{
+    return (value << count) | (value >> (32 - count));
+}
+
+/**
+ * @internal
+ * @brief ChaCha20 quarter round
+ * @param x state.
+ * @param a index of the first word.
+ * @param b index of the second word.
+ * @param c index of the third word.
+ * @param d index of the fourth word.
+ */
+static inline void quarterRound(quint32 *x, int a, int b, int c, int d)
+{
+    x[a] += x[b];
+    x[d] = rotateLeft(x[d] ^ x[a], 16);
+    x[c] += x[d];
+    x[b] = rotateLeft(x[b] ^ x[c], 12);
+    x[a] += x[b];
+    x[d] = rotateLeft(x[d] ^ x[a], 8);
+    x[c] += x[d];
+    x[b] = rotateLeft(x[b] ^ x[c], 7);
+}
+
+/**
+ * @internal
+ * @brief Read random bytes from the system
+ *
+ * The bytes are read with BCryptGenRandom on Windows, getrandom
+ * on Linux, and from /dev/urandom on the other systems. There
+ * is no weaker fallback: the application is aborted if the
+ * system can't provide the bytes.
+ *
+ * @param data buffer to fill.
+ * @param size number of bytes.
+ */
+static void systemRandomBytes(char *data, int size)
+{
+#if defined(Q_OS_WIN)
+    if (BCryptGenRandom(NULL, reinterpret_cast<PUCHAR>(data), ULONG(size),
+                        BCRYPT_USE_SYSTEM_PREFERRED_RNG) == 0) {
+        return;
+    }
+#elif defined(Q_OS_LINUX)
+    int read = 0;
+    while (read < size) {
+        ssize_t result = getrandom(data + read, size - read, 0);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        read += int(result);
+    }
+    if (read == size) {
+        return;
+    }
+#else
+    QFile file ("/dev/urandom");
+    if (file.open(QIODevice::ReadOnly) && file.read(data, size) == size) {
+        return;
+    }
+#endif
+
+    qFatal("%s: failed to read random bytes from the system", Q_FUNC_INFO);
+}
+
+ChaChaGenerator::ChaChaGenerator()
+    : m_index(BufferSize), m_bufferCount(0), m_systemSeeded(true)
+{
+    memcpy(m_input, CHACHA_CONSTANTS, sizeof(CHACHA_CONSTANTS));
+    reseed();
+}
+
+ChaChaGenerator::ChaChaGenerator(const quint32 *key, quint64 nonce, quint64 counter)
+    : m_index(BufferSize), m_bufferCount(0), m_systemSeeded(false)
+{
+    memcpy(m_input, CHACHA_CONSTANTS, sizeof(CHACHA_CONSTANTS));
+    memcpy(m_input + 4, key, 8 * sizeof(quint32));
+    m_input[12] = quint32(counter);
+    m_input[13] = quint32(counter >> 32);
+    m_input[14] = quint32(nonce);
+    m_input[15] = quint32(nonce >> 32);
+}
+
+ChaChaGenerator::~ChaChaGenerator()
+{
+    // Volatile writes, so that they are not optimized out
+    volatile quint32 *input = m_input;
+    for (int i = 0; i < 16; i++) {
+        input[i] = 0;
+    }
+    volatile quint64 *buffer = m_buffer;
+    for (int i = 0; i < BufferSize; i++) {
+        buffer[i] = 0;
+    }
+}
+
+quint64 ChaChaGenerator::next()
+{
+    if (m_index == BufferSize) {
+        refill();
+    }
+    return m_buffer[m_index++];
+}
+
+void ChaChaGenerator::reseed()
+{
+    // Key, then nonce, and the counter restarts from 0
+    systemRandomBytes(reinterpret_cast<char *>(m_input + 4), 8 * sizeof(quint32));
+    systemRandomBytes(reinterpret_cast<char *>(m_input + 14), 2 * sizeof(quint32));
+    m_input[12] = 0;
+    m_input[13] = 0;
+    m_index = BufferSize;
+    m_bufferCount = 0;
+    m_systemSeeded = true;
+}
+
+ChaChaGenerator * ChaChaGenerator::threadGenerator()
+{
+    if (!threadGenerators.hasLocalData()) {
+        threadGenerators.setLocalData(new ChaChaGenerator());
+    }
+    return threadGenerators.localData();
+}
+
+void ChaChaGenerator::refill()
+{
+    // A given key always gives the same keystream, so only the
+    // generators seeded by the system are reseeded
+    if (m_systemSeeded) {
+        if (m_bufferCount == ReseedInterval) {
+            reseed();
+        }
+        m_bufferCount++;
+    }
+
+    for (int block = 0; block < BLOCKS_PER_BUFFER; block++) {
+        quint32 x[16];
+        memcpy(x, m_input, sizeof(x));
+        for (int i = 0; i < 10; i++) {
+            quarterRound(x, 0, 4, 8, 12);
+            quarterRound(x, 1, 5, 9, 13);
+            quarterRound(x, 2, 6, 10, 14);
+            quarterRound(x, 3, 7, 11, 15);
+            quarterRound(x, 0, 5, 10, 15);
+            quarterRound(x, 1, 6, 11, 12);
+            quarterRound(x, 2, 7, 8, 13);
+            quarterRound(x, 3, 4, 9, 14);
+        }
+
+        // The words of the keystream are read as little-endian
+        // 64-bit numbers
+        quint64 *output = m_buffer + block * 8;
+        for (int i = 0; i < 8; i++) {
+            output[i] = quint64(x[2 * i] + m_input[2 * i])
+                        | (quint64(x[2 * i + 1] + m_input[2 * i + 1]) << 32);
+        }
+
+        // 64-bit block counter
+        if (++m_input[12] == 0) {
+            m_input[13]++;
+        }
+    }
+    m_index = 0;
+}
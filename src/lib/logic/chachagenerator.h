@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef CHACHAGENERATOR_H
+#define CHACHAGENERATOR_H
+
+/**
+ * @file chachagenerator.h
+ * @short Definition of ChaChaGenerator
+ */
+
+#include "pokqt_global.h"
+#include "randomgenerator.h"
+
+/**
+ * @brief Cryptographically secure random number generator
+ *
+ * This generator returns the keystream of the ChaCha20 stream
+ * cipher, with a key and a nonce read from the system. The
+ * outputs can't be predicted from the previous ones, so it is
+ * used to shuffle the decks of tables where the players should
+ * not be able to guess the cards.
+ *
+ * Reading the system entropy source for each number would be
+ * slow, so the keystream is generated by buffers of BufferSize
+ * numbers, and the generator is reseeded from the system every
+ * ReseedInterval buffers. Generators created with a given key
+ * are not reseeded, so their keystream is reproducible.
+ *
+ * A generator should not be shared between threads.
+ */
+class POKQTSHARED_EXPORT ChaChaGenerator: public RandomGenerator
+{
+public:
+    enum {
+        /**
+         * @brief Number of 64-bit numbers generated at once
+         */
+        BufferSize = 512,
+        /**
+         * @brief Number of buffers generated between two reseeds
+         */
+        ReseedInterval = 256
+    };
+    /**
+     * @brief Default constructor
+     *
+     * The generator is seeded from the system.
+     */
+    explicit ChaChaGenerator();
+    /**
+     * @brief Constructor with a given key
+     *
+     * This constructor is used to check the keystream with known
+     * vectors. The generator is not reseeded automatically, so
+     * it always gives the same keystream, until reseed() is called.
+     *
+     * @param key 256-bit key, as 8 little-endian words.
+     * @param nonce 64-bit nonce.
+     * @param counter index of the first block.
+     */
+    explicit ChaChaGenerator(const quint32 *key, quint64 nonce, quint64 counter = 0);
+    /**
+     * @brief Destructor
+     *
+     * The key and the remaining numbers are erased.
+     */
+    virtual ~ChaChaGenerator();
+    /**
+     * @brief Get the next random number
+     * @return 64 random bits.
+     */
+    quint64 next();
+    /**
+     * @brief Reseed the generator
+     *
+     * A new key and a new nonce are read from the random source
+     * of the system, and the application is aborted if it can't
+     * be read. The remaining numbers of the buffer are dropped, and the
+     * generator is then reseeded every ReseedInterval buffers.
+     */
+    void reseed();
+    /**
+     * @brief Get a generator for the current thread
+     *
+     * Each thread gets its own generator, that is created the
+     * first time it is used, and deleted with the thread.
+     *
+     * @return generator of the current thread.
+     */
+    static ChaChaGenerator * threadGenerator();
+private:
+    Q_DISABLE_COPY(ChaChaGenerator)
+    /**
+     * @internal
+     * @brief Generate the next buffer
+     */
+    void refill();
+    /**
+     * @internal
+     * @brief ChaCha20 input block
+     *
+     * It contains the constants, the key, the counter of the
+     * block, and the nonce.
+     */
+    quint32 m_input[16];
+    /**
+     * @internal
+     * @brief Buffer of numbers
+     */
+    quint64 m_buffer[BufferSize];
+    /**
+     * @internal
+     * @brief Index of the next number in the buffer
+     */
+    int m_index;
+    /**
+     * @internal
+     * @brief Number of buffers generated since the last reseed
+     */
+    int m_bufferCount;
+    /**
+     * @internal
+     * @brief If the key was read from the system
+     */
+    bool m_systemSeeded;
+};
+
+#endif // CHACHAGENERATOR_H
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file dealrecord.cpp
+ * @short Implementation of DealRecord
+ */
+
+#include "dealrecord.h"
+
+DealRecord::DealRecord()
+    : m_count(0), m_mask(0)
+{
+}
+
+bool DealRecord::operator==(const DealRecord &other) const
+{
+    if (m_count != other.m_count) {
+        return false;
+    }
+
+    for (int i = 0; i < m_count; i++) {
+        if (m_cards[i] != other.m_cards[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DealRecord::operator!=(const DealRecord &other) const
+{
+    return !(*this == other);
+}
+
+bool DealRecord::isEmpty() const
+{
+    return m_count == 0;
+}
+
+int DealRecord::count() const
+{
+    return m_count;
+}
+
+PackedCard DealRecord::at(int i) const
+{
+    Q_ASSERT(i >= 0 && i < m_count);
+    return m_cards[i];
+}
+
+CardSet DealRecord::cardSet() const
+{
+    return CardSet(m_mask);
+}
+
+QList<Card> DealRecord::toList() const
+{
+    QList<Card> cards;
+    for (int i = 0; i < m_count; i++) {
+        cards.append(m_cards[i].toCard());
+    }
+    return cards;
+}
+
+bool DealRecord::append(PackedCard card)
+{
+    const quint64 mask = CardSet::cardMask(card);
+    if (!card.isValid() || (m_mask & mask) != 0) {
+        return false;
+    }
+
+    m_cards[m_count] = card;
+    m_count++;
+    m_mask |= mask;
+    return true;
+}
+
+void DealRecord::clear()
+{
+    m_count = 0;
+    m_mask = 0;
+}
+
+QByteArray DealRecord::toByteArray() const
+{
+    QByteArray data;
+    data.reserve(m_count);
+    for (int i = 0; i < m_count; i++) {
+        data.append(char(m_cards[i].index()));
+    }
+    return data;
+}
+
+DealRecord DealRecord::fromByteArray(const QByteArray &data)
+{
+    DealRecord record;
+    for (int i = 0; i < data.size(); i++) {
+        const int index = quint8(data.at(i));
+        if (index >= PackedCard::CardCount || !record.append(PackedCard(index))) {
+            return DealRecord();
+        }
+    }
+    return record;
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef DEALRECORD_H
+#define DEALRECORD_H
+
+/**
+ * @file dealrecord.h
+ * @short Definition of DealRecord
+ */
+
+#include "pokqt_global.h"
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include "cardset.h"
+#include "packedcard.h"
+
+/**
+ * @brief Record of the cards dealt in a round
+ *
+ * This class stores the cards dealt from a Deck, in the order
+ * they were dealt, so that a round can be replayed with the same
+ * cards, see Deck::replay(). The order of the cards is recorded,
+ * instead of the seed of the random generator, so rounds
+ * shuffled with a secure generator can also be replayed.
+ *
+ * The cards are stored in a fixed-size array, and are serialized
+ * as one byte per card, the index of the PackedCard.
+ */
+class POKQTSHARED_EXPORT DealRecord
+{
+public:
+    /**
+     * @brief Default constructor
+     */
+    explicit DealRecord();
+    /**
+     * @brief Check if two records are equal
+     * @param other other record to compare with.
+     * @return if the two records contain the same cards in the same order.
+     */
+    bool operator==(const DealRecord &other) const;
+    /**
+     * @brief Check if two records are different
+     * @param other other record to compare with.
+     * @return if the two records are different.
+     */
+    bool operator!=(const DealRecord &other) const;
+    /**
+     * @brief Get if there are no cards
+     * @return if there are no cards.
+     */
+    bool isEmpty() const;
+    /**
+     * @brief Number of cards
+     * @return number of cards.
+     */
+    int count() const;
+    /**
+     * @brief Card at a given position
+     * @param i position of the card, between 0 and count() - 1.
+     * @return card at the given position.
+     */
+    PackedCard at(int i) const;
+    /**
+     * @brief Get the cards as a CardSet
+     * @return recorded cards.
+     */
+    CardSet cardSet() const;
+    /**
+     * @brief Get the cards as a list
+     * @return recorded cards, in the order they were dealt.
+     */
+    QList<Card> toList() const;
+    /**
+     * @brief Add a card
+     *
+     * Cards that are already recorded, or invalid, are ignored.
+     *
+     * @param card card to add.
+     * @return if the card was added.
+     */
+    bool append(PackedCard card);
+    /**
+     * @brief Remove all the cards
+     */
+    void clear();
+    /**
+     * @brief Serialize the record
+     * @return the indexes of the cards, one byte per card.
+     */
+    QByteArray toByteArray() const;
+    /**
+     * @brief Deserialize a record
+     * @param data data created by toByteArray().
+     * @return the record, or an empty record if the data is invalid.
+     */
+    static DealRecord fromByteArray(const QByteArray &data);
+private:
+    /**
+     * @internal
+     * @brief Cards
+     */
+    PackedCard m_cards[PackedCard::CardCount];
+    /**
+     * @internal
+     * @brief Number of cards
+     */
+    int m_count;
+    /**
+     * @internal
+     * @brief Cards, as a mask
+     *
+     * It is used to check for duplicated cards.
+     */
+    quint64 m_mask;
+};
+
+#endif // DEALRECORD_H
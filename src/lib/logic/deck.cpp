@@ -35,20 +35,30 @@
  */
 
 #include "deck.h"
-#include <QtCore/QDateTime>
+#include "chachagenerator.h"
 
 Deck::Deck()
+    : m_size(0), m_cursor(0), m_generator(0), m_shuffleMode(SeededShuffle)
 {
 }
 
 int Deck::count() const
 {
-    return m_cards.count();
+    return m_size - m_cursor;
 }
 
 bool Deck::isEmpty() const
 {
-    return m_cards.isEmpty();
+    return m_cursor == m_size;
+}
+
+CardSet Deck::cardSet() const
+{
+    CardSet cards;
+    for (int i = m_cursor; i < m_size; i++) {
+        cards.insert(m_cards[i]);
+    }
+    return cards;
 }
 
 Card Deck::draw()
@@ -57,45 +67,108 @@ Card Deck::draw()
         return Card();
     }
 
-    return m_cards.takeFirst();
+    // Step of the Fisher-Yates shuffle: the drawn card is
+    // swapped with a random card that is not drawn yet
+    if (m_generator) {
+        int other = m_cursor + m_generator->bounded(m_size - m_cursor);
+        PackedCard card = m_cards[other];
+        m_cards[other] = m_cards[m_cursor];
+        m_cards[m_cursor] = card;
+    }
+    return m_cards[m_cursor++].toCard();
+}
+
+int Deck::draw(Card *cards, int count)
+{
+    count = qMin(count, this->count());
+    for (int i = 0; i < count; i++) {
+        cards[i] = draw();
+    }
+    return count;
 }
 
 void Deck::clear()
 {
-    m_cards.clear();
+    m_size = 0;
+    m_cursor = 0;
+    m_generator = 0;
 }
 
 void Deck::reset()
 {
-    m_cards.clear();
     // Create a standard 52-cards deck
-    // it is sorted
-    addCards(Card::Spade);
-    addCards(Card::Heart);
-    addCards(Card::Diamond);
-    addCards(Card::Club);
-}
-
-void Deck::shuffle()
-{
-#ifdef CPP11
-    // Profit from C++11 features when available
-    std::shuffle(m_cards.begin(), m_cards.end(), std::default_random_engine(QDateTime::currentMSecsSinceEpoch()));
-#else
-    // Initialize seed
-    qsrand(QDateTime::currentMSecsSinceEpoch());
-
-    // A rather good shuffle algorithm: swap two random entries, n times
-    int size = m_cards.count();
-    for (int i = 0; i < size; ++i) {
-        m_cards.swap(qrand() % size, qrand() % size);
+    reset(CardSet::fullDeck());
+}
+
+void Deck::reset(CardSet cards)
+{
+    clear();
+    // The deck is sorted by suit, then by rank
+    addCards(Card::Spade, cards.suitMask(Card::Spade));
+    addCards(Card::Heart, cards.suitMask(Card::Heart));
+    addCards(Card::Diamond, cards.suitMask(Card::Diamond));
+    addCards(Card::Club, cards.suitMask(Card::Club));
+}
+
+void Deck::rewind()
+{
+    m_cursor = 0;
+}
+
+DealRecord Deck::dealRecord() const
+{
+    DealRecord record;
+    for (int i = 0; i < m_cursor; i++) {
+        record.append(m_cards[i]);
+    }
+    return record;
+}
+
+void Deck::replay(const DealRecord &record)
+{
+    rewind();
+    m_generator = 0;
+
+    // Move each recorded card to the next position
+    int position = 0;
+    for (int i = 0; i < record.count(); i++) {
+        for (int j = position; j < m_size; j++) {
+            if (m_cards[j] == record.at(i)) {
+                PackedCard card = m_cards[j];
+                m_cards[j] = m_cards[position];
+                m_cards[position] = card;
+                position++;
+                break;
+            }
+        }
+    }
+}
+
+void Deck::shuffle(RandomGenerator *generator)
+{
+    if (m_shuffleMode == SecureShuffle) {
+        m_generator = ChaChaGenerator::threadGenerator();
+    } else {
+        m_generator = generator;
     }
-#endif
 }
 
-void Deck::addCards(Card::Suit suit)
+Deck::ShuffleMode Deck::shuffleMode() const
+{
+    return m_shuffleMode;
+}
+
+void Deck::setShuffleMode(ShuffleMode shuffleMode)
+{
+    m_shuffleMode = shuffleMode;
+}
+
+void Deck::addCards(Card::Suit suit, quint16 ranks)
 {
     for (int i = 0; i < 13; i++) {
-        m_cards.append(Card(suit, i));
+        if (ranks & (1 << i)) {
+            m_cards[m_size] = PackedCard(suit, i);
+            m_size++;
+        }
     }
 }
@@ -37,8 +37,12 @@
  * @short Definition of Deck
  */
 
-#include <QtCore/QList>
 #include "card.h"
+#include "cardset.h"
+#include "dealrecord.h"
+#include "packedcard.h"
+
+class RandomGenerator;
 
 /**
  * @brief A deck
@@ -46,10 +50,36 @@
  * This class manages a classic 52-cards. It is able
  * to create a deck, shuffle it, and distribute cards,
  * represented by the Card class.
+ *
+ * The cards are stored in a fixed array, with a cursor on
+ * the next card to draw, so drawing a card and putting the
+ * drawn cards back, with rewind(), do not allocate anything.
+ *
+ * The shuffle is lazy: shuffle() only remembers the random
+ * generator, and each draw picks a random card among the cards
+ * that are still in the deck. This is a Fisher-Yates shuffle
+ * that stops at the last drawn card, so only the cards that
+ * are actually dealt use random numbers.
  */
 class Deck
 {
 public:
+    /**
+     * @brief Source of the random numbers used by shuffles
+     */
+    enum ShuffleMode {
+        /**
+         * @short The generator passed to shuffle() is used
+         */
+        SeededShuffle,
+        /**
+         * @short A cryptographically secure generator is used
+         *
+         * The generator passed to shuffle() is ignored, and the
+         * ChaChaGenerator of the current thread is used instead.
+         */
+        SecureShuffle
+    };
     /**
      * @brief Default constructor
      */
@@ -64,11 +94,23 @@ public:
      * @return if the deck is empty.
      */
     bool isEmpty() const;
+    /**
+     * @brief Get the cards that are still in the deck
+     * @return cards in the deck, as a CardSet.
+     */
+    CardSet cardSet() const;
     /**
      * @brief Draw a card from the deck
-     * @return card drawn from the deck.
+     * @return card drawn from the deck, or an invalid card if the deck is empty.
      */
     Card draw();
+    /**
+     * @brief Draw several cards from the deck
+     * @param cards buffer receiving the drawn cards.
+     * @param count number of cards to draw.
+     * @return number of cards drawn, that is lower than count if the deck is empty.
+     */
+    int draw(Card *cards, int count);
     /**
      * @brief Clear the deck
      *
@@ -84,27 +126,113 @@ public:
      * club.
      */
     void reset();
+    /**
+     * @brief Reset the deck with some cards
+     *
+     * Reset the deck, creating an ordered deck with the
+     * given cards, in the same order as reset(). It is used
+     * by variants that do not use the 52 cards, see gamerules.h.
+     *
+     * @param cards cards of the deck.
+     */
+    void reset(CardSet cards);
+    /**
+     * @brief Put the drawn cards back in the deck
+     *
+     * The cursor is moved back to the first card, so the deck
+     * contains the cards of the last reset again, in the order
+     * they were drawn. If the deck is shuffled, the next draws
+     * are random again.
+     */
+    void rewind();
+    /**
+     * @brief Get the drawn cards
+     * @return cards drawn since the deck was reset or rewound, in the order they were drawn.
+     */
+    DealRecord dealRecord() const;
+    /**
+     * @brief Replay a recorded deal
+     *
+     * The deck is rewound, and its cards are ordered so that the
+     * cards of the record are drawn first, in the same order. They
+     * are followed by the other cards of the deck. The deck is not
+     * shuffled anymore, so draws are not random until shuffle() is
+     * called again.
+     *
+     * Cards of the record that are not in the deck are ignored.
+     *
+     * @param record cards to deal.
+     */
+    void replay(const DealRecord &record);
     /**
      * @brief Shuffle the deck
+     *
+     * The deck is shuffled with a Fisher-Yates shuffle, so that
+     * all the orders have the same probability. The random numbers
+     * are taken from the given generator, so that a deck can be
+     * shuffled again in the same order, and so that the decks of
+     * different tables do not share a generator.
+     *
+     * The cards are only shuffled when they are drawn, so the deck
+     * keeps a pointer to the generator, that it does not own. The
+     * generator should stay valid while cards are drawn, until the
+     * deck is reset or cleared. If the generator is 0, the deck is
+     * not shuffled. A deck in SecureShuffle mode should be drawn
+     * from the thread that shuffled it.
+     *
+     * @param generator random number generator, not owned by the deck.
+     */
+    void shuffle(RandomGenerator *generator);
+    /**
+     * @brief Get the shuffle mode
+     * @return shuffle mode.
      */
-    void shuffle();
+    ShuffleMode shuffleMode() const;
+    /**
+     * @brief Set the shuffle mode
+     * @param shuffleMode shuffle mode.
+     */
+    void setShuffleMode(ShuffleMode shuffleMode);
 private:
     /**
      * @internal
      * @brief Method used to create a deck
      *
      * This method is used to create a deck, by
-     * adding all the cards of a given suit to
+     * adding the cards of a given suit to
      * the deck.
      *
      * @param suit suit used.
+     * @param ranks rank mask of the cards to add.
+     */
+    void addCards(Card::Suit suit, quint16 ranks);
+    /**
+     * @internal
+     * @brief Cards of the deck
+     *
+     * The cards before the cursor are drawn.
+     */
+    PackedCard m_cards[PackedCard::CardCount];
+    /**
+     * @internal
+     * @brief Number of cards of the deck, including the drawn ones
+     */
+    int m_size;
+    /**
+     * @internal
+     * @brief Index of the next card to draw
+     */
+    int m_cursor;
+    /**
+     * @internal
+     * @brief Generator used to draw the cards, or 0 if the deck is not shuffled
      */
-    void addCards(Card::Suit suit);
+    RandomGenerator *m_generator;
     /**
      * @internal
-     * @brief Cards in the deck
+     * @brief Shuffle mode
      */
-    QList<Card> m_cards;
+    ShuffleMode m_shuffleMode;
 };
 
 #endif // DECK_H
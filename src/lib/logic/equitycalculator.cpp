@@ -0,0 +1,804 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file equitycalculator.cpp
+ * @short Implementation of EquityCalculator
+ */
+
+#include "equitycalculator.h"
+#include <QtCore/QRunnable>
+#include <QtCore/qmath.h>
+#include <climits>
+#include <cstring>
+#include "gamerules.h"
+#include "handevaluator.h"
+#include "randomgenerator.h"
+
+/**
+ * @internal
+ * @brief BATCH_SIZE
+ *
+ * Constant representing the number of trials done in a batch.
+ */
+static const int BATCH_SIZE = 4096;
+/**
+ * @internal
+ * @brief MINIMUM_TRIAL_COUNT
+ *
+ * Constant representing the number of trials to do before
+ * checking the target error, so that the variance is
+ * reliably estimated.
+ */
+static const qint64 MINIMUM_TRIAL_COUNT = 4 * BATCH_SIZE;
+/**
+ * @internal
+ * @brief DEFAULT_TRIAL_COUNT
+ *
+ * Constant representing the default maximum number of trials.
+ */
+static const qint64 DEFAULT_TRIAL_COUNT = 1000000;
+/**
+ * @internal
+ * @brief CONFIDENCE_FACTOR
+ *
+ * Constant representing the factor applied to the standard
+ * error to get a 95% confidence interval.
+ */
+static const double CONFIDENCE_FACTOR = 1.96;
+
+/**
+ * @internal
+ * @brief Task running batches of trials
+ *
+ * Each task copies the parameters of the calculator, then
+ * runs batches until the simulation is finished.
+ */
+class EquityTask: public QRunnable
+{
+public:
+    /**
+     * @internal
+     * @brief Default constructor
+     * @param calculator calculator that runs the task.
+     */
+    explicit EquityTask(EquityCalculator *calculator);
+    /**
+     * @internal
+     * @brief Run batches
+     */
+    void run();
+private:
+    /**
+     * @internal
+     * @brief Run batches with the rules of a game variant
+     */
+    template <typename Rules>
+    void runBatches();
+    /**
+     * @internal
+     * @brief Draw a card
+     *
+     * This is a step of a partial Fisher-Yates shuffle of
+     * the available cards.
+     *
+     * @param generator random number generator.
+     * @param index number of cards already drawn in this trial.
+     * @return mask of the drawn card.
+     */
+    inline quint64 draw(RandomGenerator &generator, int index);
+    /**
+     * @internal
+     * @brief Calculator
+     */
+    EquityCalculator *m_calculator;
+    /**
+     * @internal
+     * @brief Hole cards of the players, as masks
+     */
+    QVector<quint64> m_players;
+    /**
+     * @internal
+     * @brief Board, as a mask
+     */
+    quint64 m_board;
+    /**
+     * @internal
+     * @brief Number of board cards to deal
+     */
+    int m_missingBoardCount;
+    /**
+     * @internal
+     * @brief Cards that can be dealt, as masks
+     */
+    quint64 m_deck[PackedCard::CardCount];
+    /**
+     * @internal
+     * @brief Cards that can be dealt, shuffled during the batch
+     */
+    quint64 m_cards[PackedCard::CardCount];
+    /**
+     * @internal
+     * @brief Number of cards that can be dealt
+     */
+    int m_cardCount;
+};
+
+EquityTask::EquityTask(EquityCalculator *calculator)
+    : m_calculator(calculator), m_board(calculator->m_board.mask())
+    , m_missingBoardCount(5 - calculator->m_board.count()), m_cardCount(0)
+{
+    CardSet used = calculator->m_board | calculator->m_deadCards;
+    foreach (CardSet player, calculator->m_players) {
+        m_players.append(player.mask());
+        used |= player;
+    }
+
+    foreach (PackedCard card, ~used) {
+        m_deck[m_cardCount] = CardSet::cardMask(card);
+        m_cardCount++;
+    }
+}
+
+quint64 EquityTask::draw(RandomGenerator &generator, int index)
+{
+    int other = index + generator.bounded(m_cardCount - index);
+    quint64 card = m_cards[other];
+    m_cards[other] = m_cards[index];
+    m_cards[index] = card;
+    return card;
+}
+
+void EquityTask::run()
+{
+    switch (m_calculator->m_variant) {
+    case EquityCalculator::Omaha:
+        runBatches<OmahaRules>();
+        break;
+    default:
+        runBatches<HoldemRules>();
+        break;
+    }
+}
+
+template <typename Rules>
+void EquityTask::runBatches()
+{
+    const int playerCount = m_players.count();
+    QVector<qint64> shares (playerCount * (playerCount + 1));
+    QVector<quint16> strengths (playerCount);
+
+    int batch;
+    while ((batch = m_calculator->nextBatch()) != -1) {
+        // Each batch has its own random stream, and starts from
+        // the same order of the cards, so it doesn't depend on
+        // the batches previously run by the task
+        memcpy(m_cards, m_deck, m_cardCount * sizeof(quint64));
+        XoshiroGenerator generator (m_calculator->m_seed, batch);
+
+        qint64 trialCount = qMin<qint64>(BATCH_SIZE,
+                                         m_calculator->m_maximumTrialCount - qint64(batch) * BATCH_SIZE);
+        shares.fill(0);
+        for (qint64 trial = 0; trial < trialCount; trial++) {
+            int drawn = 0;
+            quint64 board = m_board;
+            for (int i = 0; i < m_missingBoardCount; i++) {
+                board |= draw(generator, drawn++);
+            }
+
+            quint16 best = 0;
+            int winnerCount = 0;
+            for (int i = 0; i < playerCount; i++) {
+                quint64 hand = m_players.at(i);
+                if (hand == 0) {
+                    for (int j = 0; j < Rules::HoleCardCount; j++) {
+                        hand |= draw(generator, drawn++);
+                    }
+                }
+                quint16 strength = Rules::evaluate(CardSet(hand), CardSet(board));
+                strengths[i] = strength;
+                if (strength > best) {
+                    best = strength;
+                    winnerCount = 1;
+                } else if (strength == best) {
+                    winnerCount++;
+                }
+            }
+
+            for (int i = 0; i < playerCount; i++) {
+                if (strengths.at(i) == best) {
+                    shares[i * (playerCount + 1) + winnerCount]++;
+                }
+            }
+        }
+
+        m_calculator->addBatch(trialCount, shares.constData());
+    }
+}
+
+/**
+ * @internal
+ * @brief Runouts to enumerate for the exact equity
+ *
+ * A runout is described by the ranks dealt in each suit. The
+ * suits are ordered so that the suits that play the same role
+ * are next to each other, and a runout is only enumerated if
+ * the masks of these suits are sorted in decreasing order.
+ */
+struct ExactEnumeration
+{
+    /**
+     * @internal
+     * @brief Suits, ordered by class
+     */
+    int suits[4];
+    /**
+     * @internal
+     * @brief If a suit plays the same role than the previous one
+     */
+    bool sameClass[4];
+    /**
+     * @internal
+     * @brief Subsets of the available ranks of each suit, by size
+     *
+     * The subsets are sorted in increasing order.
+     */
+    QVector<quint16> subsets[4][6];
+    /**
+     * @internal
+     * @brief Subsets of the first suit, of all the sizes
+     *
+     * Each of them is a batch.
+     */
+    QVector<quint16> firstSubsets;
+    /**
+     * @internal
+     * @brief Number of board cards to deal
+     */
+    int missingBoardCount;
+};
+
+/**
+ * @internal
+ * @brief Task enumerating runouts
+ *
+ * Each batch is a subset of ranks of the first suit, and all
+ * the runouts starting with this subset are enumerated.
+ */
+class ExactEquityTask: public QRunnable
+{
+public:
+    /**
+     * @internal
+     * @brief Default constructor
+     * @param calculator calculator that runs the task.
+     * @param enumeration runouts to enumerate.
+     */
+    explicit ExactEquityTask(EquityCalculator *calculator, const ExactEnumeration *enumeration);
+    /**
+     * @internal
+     * @brief Run batches
+     */
+    void run();
+private:
+    /**
+     * @internal
+     * @brief Enumerate the ranks of a suit
+     * @param position position of the suit in the enumeration order.
+     * @param remaining number of cards to deal.
+     */
+    template <typename Rules>
+    void enumerate(int position, int remaining);
+    /**
+     * @internal
+     * @brief Evaluate the current runout
+     */
+    template <typename Rules>
+    void evaluate();
+    /**
+     * @internal
+     * @brief Calculator
+     */
+    EquityCalculator *m_calculator;
+    /**
+     * @internal
+     * @brief Runouts to enumerate
+     */
+    const ExactEnumeration *m_enumeration;
+    /**
+     * @internal
+     * @brief Hole cards of the players, as masks
+     */
+    QVector<quint64> m_players;
+    /**
+     * @internal
+     * @brief Board, as a mask
+     */
+    quint64 m_board;
+    /**
+     * @internal
+     * @brief Ranks dealt in each suit, in the enumeration order
+     */
+    quint16 m_ranks[4];
+    /**
+     * @internal
+     * @brief Number of boards of the batch
+     */
+    qint64 m_boardCount;
+    /**
+     * @internal
+     * @brief Number of showdowns won by each player, see EquityCalculator::m_shares
+     */
+    QVector<qint64> m_shares;
+    /**
+     * @internal
+     * @brief Strengths of the players
+     */
+    QVector<quint16> m_strengths;
+};
+
+ExactEquityTask::ExactEquityTask(EquityCalculator *calculator, const ExactEnumeration *enumeration)
+    : m_calculator(calculator), m_enumeration(enumeration), m_board(calculator->m_board.mask())
+    , m_boardCount(0)
+{
+    foreach (CardSet player, calculator->m_players) {
+        m_players.append(player.mask());
+    }
+    m_shares.fill(0, m_players.count() * (m_players.count() + 1));
+    m_strengths.fill(0, m_players.count());
+}
+
+void ExactEquityTask::run()
+{
+    int batch;
+    while ((batch = m_calculator->nextBatch()) != -1) {
+        m_boardCount = 0;
+        m_shares.fill(0);
+        m_ranks[0] = m_enumeration->firstSubsets.at(batch);
+        const int remaining = m_enumeration->missingBoardCount - bitCount(m_ranks[0]);
+        switch (m_calculator->m_variant) {
+        case EquityCalculator::Omaha:
+            enumerate<OmahaRules>(1, remaining);
+            break;
+        default:
+            enumerate<HoldemRules>(1, remaining);
+            break;
+        }
+        m_calculator->addBatch(m_boardCount, m_shares.constData());
+    }
+}
+
+template <typename Rules>
+void ExactEquityTask::enumerate(int position, int remaining)
+{
+    if (position == 4) {
+        if (remaining == 0) {
+            evaluate<Rules>();
+        }
+        return;
+    }
+
+    // The last suit gets all the remaining cards
+    int minimumSize = position == 3 ? remaining : 0;
+    for (int size = minimumSize; size <= remaining; size++) {
+        const QVector<quint16> &subsets = m_enumeration->subsets[position][size];
+        for (int i = 0; i < subsets.count(); i++) {
+            quint16 ranks = subsets.at(i);
+            if (m_enumeration->sameClass[position] && ranks > m_ranks[position - 1]) {
+                break;
+            }
+            m_ranks[position] = ranks;
+            enumerate<Rules>(position + 1, remaining - size);
+        }
+    }
+}
+
+template <typename Rules>
+void ExactEquityTask::evaluate()
+{
+    // The number of boards represented by this runout is the number of
+    // different permutations of the ranks of the suits in each class
+    quint64 board = m_board;
+    int weight = 1;
+    int classSize = 0;
+    int equalCount = 0;
+    for (int i = 0; i < 4; i++) {
+        board |= quint64(m_ranks[i]) << (16 * m_enumeration->suits[i]);
+        if (i > 0 && m_enumeration->sameClass[i]) {
+            classSize++;
+            equalCount = m_ranks[i] == m_ranks[i - 1] ? equalCount + 1 : 1;
+        } else {
+            classSize = 1;
+            equalCount = 1;
+        }
+        weight = weight * classSize / equalCount;
+    }
+
+    const int playerCount = m_players.count();
+    quint16 best = 0;
+    int winnerCount = 0;
+    for (int i = 0; i < playerCount; i++) {
+        quint16 strength = Rules::evaluate(CardSet(m_players.at(i)), CardSet(board));
+        m_strengths[i] = strength;
+        if (strength > best) {
+            best = strength;
+            winnerCount = 1;
+        } else if (strength == best) {
+            winnerCount++;
+        }
+    }
+
+    for (int i = 0; i < playerCount; i++) {
+        if (m_strengths.at(i) == best) {
+            m_shares[i * (playerCount + 1) + winnerCount] += weight;
+        }
+    }
+    m_boardCount += weight;
+}
+
+Equity::Equity()
+    : m_win(0), m_tie(0), m_equity(0), m_error(0)
+{
+}
+
+Equity::Equity(double win, double tie, double equity, double error)
+    : m_win(win), m_tie(tie), m_equity(equity), m_error(error)
+{
+}
+
+double Equity::win() const
+{
+    return m_win;
+}
+
+double Equity::tie() const
+{
+    return m_tie;
+}
+
+double Equity::equity() const
+{
+    return m_equity;
+}
+
+double Equity::error() const
+{
+    return m_error;
+}
+
+EquityCalculator::EquityCalculator()
+    : m_variant(Holdem), m_maximumTrialCount(DEFAULT_TRIAL_COUNT), m_targetError(0), m_seed(0)
+    , m_batchCount(0), m_exact(false), m_trialCount(0)
+{
+}
+
+EquityCalculator::~EquityCalculator()
+{
+}
+
+QList<CardSet> EquityCalculator::players() const
+{
+    return m_players;
+}
+
+void EquityCalculator::setPlayers(const QList<CardSet> &players)
+{
+    m_players = players;
+}
+
+EquityCalculator::Variant EquityCalculator::variant() const
+{
+    return m_variant;
+}
+
+void EquityCalculator::setVariant(Variant variant)
+{
+    m_variant = variant;
+}
+
+CardSet EquityCalculator::board() const
+{
+    return m_board;
+}
+
+void EquityCalculator::setBoard(CardSet board)
+{
+    m_board = board;
+}
+
+CardSet EquityCalculator::deadCards() const
+{
+    return m_deadCards;
+}
+
+void EquityCalculator::setDeadCards(CardSet deadCards)
+{
+    m_deadCards = deadCards;
+}
+
+qint64 EquityCalculator::maximumTrialCount() const
+{
+    return m_maximumTrialCount;
+}
+
+void EquityCalculator::setMaximumTrialCount(qint64 maximumTrialCount)
+{
+    m_maximumTrialCount = maximumTrialCount;
+}
+
+double EquityCalculator::targetError() const
+{
+    return m_targetError;
+}
+
+void EquityCalculator::setTargetError(double targetError)
+{
+    m_targetError = targetError;
+}
+
+quint64 EquityCalculator::seed() const
+{
+    return m_seed;
+}
+
+void EquityCalculator::setSeed(quint64 seed)
+{
+    m_seed = seed;
+}
+
+int EquityCalculator::threadCount() const
+{
+    return m_threadPool.maxThreadCount();
+}
+
+void EquityCalculator::setThreadCount(int threadCount)
+{
+    m_threadPool.setMaxThreadCount(threadCount);
+}
+
+bool EquityCalculator::isValid() const
+{
+    if (m_players.count() < 2 || m_board.count() > 5) {
+        return false;
+    }
+
+    const int holeCardCount = m_variant == Omaha ? int(OmahaRules::HoleCardCount)
+                                                 : int(HoldemRules::HoleCardCount);
+    int count = m_board.count() + m_deadCards.count();
+    int missingCount = 5 - m_board.count();
+    CardSet used = m_board | m_deadCards;
+    foreach (CardSet player, m_players) {
+        if (player.isEmpty()) {
+            missingCount += holeCardCount;
+        } else if (player.count() != holeCardCount) {
+            return false;
+        }
+        count += player.count();
+        used |= player;
+    }
+
+    // The same card is used twice
+    if (used.count() != count) {
+        return false;
+    }
+
+    return PackedCard::CardCount - used.count() >= missingCount;
+}
+
+bool EquityCalculator::calculate()
+{
+    m_exact = false;
+    m_trialCount = 0;
+    m_shares.fill(0, m_players.count() * (m_players.count() + 1));
+    if (!isValid() || m_maximumTrialCount <= 0) {
+        return false;
+    }
+
+    qint64 batchCount = (m_maximumTrialCount + BATCH_SIZE - 1) / BATCH_SIZE;
+    m_batchCount = int(qMin<qint64>(batchCount, INT_MAX));
+    m_nextBatch.store(0);
+    m_stopped.store(0);
+
+    int taskCount = qMin(qMax(m_threadPool.maxThreadCount(), 1), m_batchCount);
+    for (int i = 0; i < taskCount; i++) {
+        m_threadPool.start(new EquityTask(this));
+    }
+    m_threadPool.waitForDone();
+    return true;
+}
+
+bool EquityCalculator::calculateExact()
+{
+    m_exact = true;
+    m_trialCount = 0;
+    m_shares.fill(0, m_players.count() * (m_players.count() + 1));
+    if (!isValid()) {
+        return false;
+    }
+
+    foreach (CardSet player, m_players) {
+        if (player.isEmpty()) {
+            return false;
+        }
+    }
+
+    // Two suits play the same role if the players, the board and the
+    // dead cards have the same ranks in these suits
+    QList<CardSet> owners = m_players;
+    owners << m_board << m_deadCards;
+    int classes[4];
+    for (int suit = 0; suit < 4; suit++) {
+        classes[suit] = suit;
+        for (int other = 0; other < suit; other++) {
+            bool same = true;
+            foreach (CardSet owner, owners) {
+                if (owner.suitMask(suit) != owner.suitMask(other)) {
+                    same = false;
+                    break;
+                }
+            }
+            if (same) {
+                classes[suit] = classes[other];
+                break;
+            }
+        }
+    }
+
+    // Order the suits by class, and list the subsets of the
+    // available ranks of each suit
+    ExactEnumeration enumeration;
+    enumeration.missingBoardCount = 5 - m_board.count();
+    CardSet used = m_board | m_deadCards;
+    foreach (CardSet player, m_players) {
+        used |= player;
+    }
+
+    int position = 0;
+    for (int suitClass = 0; suitClass < 4; suitClass++) {
+        for (int suit = 0; suit < 4; suit++) {
+            if (classes[suit] != suitClass) {
+                continue;
+            }
+            enumeration.suits[position] = suit;
+            enumeration.sameClass[position] = position > 0
+                                              && classes[enumeration.suits[position - 1]] == suitClass;
+
+            const quint16 available = ~used.suitMask(suit) & CardSet::SuitMask;
+            for (int ranks = 0; ranks <= CardSet::SuitMask; ranks++) {
+                int size = bitCount(ranks);
+                if ((ranks & ~available) == 0 && size <= enumeration.missingBoardCount) {
+                    enumeration.subsets[position][size].append(ranks);
+                }
+            }
+            position++;
+        }
+    }
+
+    for (int size = 0; size <= enumeration.missingBoardCount; size++) {
+        enumeration.firstSubsets += enumeration.subsets[0][size];
+    }
+
+    m_batchCount = enumeration.firstSubsets.count();
+    m_nextBatch.store(0);
+    m_stopped.store(0);
+
+    int taskCount = qMin(qMax(m_threadPool.maxThreadCount(), 1), m_batchCount);
+    for (int i = 0; i < taskCount; i++) {
+        m_threadPool.start(new ExactEquityTask(this, &enumeration));
+    }
+    m_threadPool.waitForDone();
+    return true;
+}
+
+bool EquityCalculator::isExact() const
+{
+    return m_exact;
+}
+
+QList<Equity> EquityCalculator::results() const
+{
+    QList<Equity> results;
+    if (m_trialCount == 0) {
+        return results;
+    }
+
+    const int playerCount = m_players.count();
+    for (int i = 0; i < playerCount; i++) {
+        const qint64 *shares = m_shares.constData() + i * (playerCount + 1);
+        qint64 ties = 0;
+        double equity = shares[1];
+        for (int k = 2; k <= playerCount; k++) {
+            ties += shares[k];
+            equity += double(shares[k]) / k;
+        }
+        results.append(Equity(double(shares[1]) / m_trialCount, double(ties) / m_trialCount,
+                              equity / m_trialCount, error(i)));
+    }
+    return results;
+}
+
+qint64 EquityCalculator::trialCount() const
+{
+    return m_trialCount;
+}
+
+void EquityCalculator::addBatch(qint64 trialCount, const qint64 *shares)
+{
+    QMutexLocker locker (&m_mutex);
+    m_trialCount += trialCount;
+    for (int i = 0; i < m_shares.count(); i++) {
+        m_shares[i] += shares[i];
+    }
+
+    if (m_exact || m_targetError <= 0 || m_trialCount < MINIMUM_TRIAL_COUNT) {
+        return;
+    }
+
+    for (int i = 0; i < m_players.count(); i++) {
+        if (error(i) > m_targetError) {
+            return;
+        }
+    }
+    m_stopped.store(1);
+}
+
+int EquityCalculator::nextBatch()
+{
+    if (m_stopped.load() != 0) {
+        return -1;
+    }
+
+    int batch = m_nextBatch.fetchAndAddRelaxed(1);
+    return batch < m_batchCount ? batch : -1;
+}
+
+double EquityCalculator::error(int player) const
+{
+    if (m_exact) {
+        return 0;
+    }
+
+    // The equity of a trial is 1 / k when the showdown is won
+    // and shared by k players, and 0 otherwise
+    const int playerCount = m_players.count();
+    const qint64 *shares = m_shares.constData() + player * (playerCount + 1);
+    double mean = 0;
+    double squaredMean = 0;
+    for (int k = 1; k <= playerCount; k++) {
+        mean += double(shares[k]) / k;
+        squaredMean += double(shares[k]) / (k * k);
+    }
+    mean /= m_trialCount;
+    squaredMean /= m_trialCount;
+
+    double variance = qMax(squaredMean - mean * mean, 0.);
+    return CONFIDENCE_FACTOR * qSqrt(variance / m_trialCount);
+}
@@ -0,0 +1,416 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef EQUITYCALCULATOR_H
+#define EQUITYCALCULATOR_H
+
+/**
+ * @file equitycalculator.h
+ * @short Definition of EquityCalculator
+ */
+
+#include "pokqt_global.h"
+#include <QtCore/QAtomicInt>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+#include "cardset.h"
+
+/**
+ * @brief Equity of a player
+ *
+ * This class contains the probability of winning and of
+ * tying of a player, and its equity, that is the part of the
+ * pot that the player wins on average. Ties count as a share
+ * of the pot.
+ *
+ * The equity is estimated, and error() provides the half-width
+ * of its 95% confidence interval. It is 0 for exact results.
+ */
+class POKQTSHARED_EXPORT Equity
+{
+public:
+    /**
+     * @brief Default constructor
+     */
+    explicit Equity();
+    /**
+     * @brief Constructor
+     * @param win probability of winning alone.
+     * @param tie probability of sharing the pot.
+     * @param equity equity.
+     * @param error half-width of the 95% confidence interval of the equity.
+     */
+    explicit Equity(double win, double tie, double equity, double error);
+    /**
+     * @brief Probability of winning alone
+     * @return probability of winning alone.
+     */
+    double win() const;
+    /**
+     * @brief Probability of sharing the pot
+     * @return probability of sharing the pot.
+     */
+    double tie() const;
+    /**
+     * @brief Equity
+     * @return equity.
+     */
+    double equity() const;
+    /**
+     * @brief Half-width of the 95% confidence interval of the equity
+     * @return half-width of the confidence interval.
+     */
+    double error() const;
+private:
+    /**
+     * @internal
+     * @brief Probability of winning alone
+     */
+    double m_win;
+    /**
+     * @internal
+     * @brief Probability of sharing the pot
+     */
+    double m_tie;
+    /**
+     * @internal
+     * @brief Equity
+     */
+    double m_equity;
+    /**
+     * @internal
+     * @brief Half-width of the confidence interval
+     */
+    double m_error;
+};
+
+/**
+ * @brief Monte Carlo equity calculator
+ *
+ * This class estimates the equity of players in a Texas
+ * Hold'em or an Omaha hand, by dealing random boards (and random
+ * hole cards for the players whose cards are unknown) and
+ * counting the showdowns won by each player.
+ *
+ * The hole cards of each player are either 2 known cards
+ * (4 in Omaha), or an empty set for a player whose cards are
+ * unknown.
+ * A partial board, and dead cards, that can't be dealt,
+ * can also be provided.
+ *
+ * The trials are done by batches, on a thread pool. Each
+ * batch uses its own random stream, derived from the seed and
+ * the index of the batch, and draws the cards from a fixed
+ * array with a partial Fisher-Yates shuffle, so trials do not
+ * allocate anything.
+ *
+ * The simulation stops when the maximum number of trials is
+ * reached or, if a target error is set, as soon as the error
+ * of every player is below the target.
+ *
+ * Without a target error, the results only depend on the seed,
+ * and not on the number of threads.
+ *
+ * When the hole cards of all the players are known, the exact
+ * equity can also be computed with calculateExact(), that
+ * enumerates all the remaining boards.
+ */
+class POKQTSHARED_EXPORT EquityCalculator
+{
+public:
+    /**
+     * @brief Game variant
+     */
+    enum Variant {
+        /**
+         * @short Texas Hold'em
+         */
+        Holdem,
+        /**
+         * @short Omaha, where hands use exactly two hole cards
+         */
+        Omaha
+    };
+    /**
+     * @brief Default constructor
+     */
+    explicit EquityCalculator();
+    /**
+     * @brief Destructor
+     */
+    virtual ~EquityCalculator();
+    /**
+     * @brief Get the hole cards of the players
+     * @return hole cards of the players.
+     */
+    QList<CardSet> players() const;
+    /**
+     * @brief Get the game variant
+     * @return game variant.
+     */
+    Variant variant() const;
+    /**
+     * @brief Set the game variant
+     * @param variant game variant.
+     */
+    void setVariant(Variant variant);
+    /**
+     * @brief Set the hole cards of the players
+     * @param players hole cards of the players, empty for unknown cards.
+     */
+    void setPlayers(const QList<CardSet> &players);
+    /**
+     * @brief Get the board
+     * @return cards of the board.
+     */
+    CardSet board() const;
+    /**
+     * @brief Set the board
+     * @param board cards of the board, up to 5.
+     */
+    void setBoard(CardSet board);
+    /**
+     * @brief Get the dead cards
+     * @return dead cards.
+     */
+    CardSet deadCards() const;
+    /**
+     * @brief Set the dead cards
+     * @param deadCards cards that can't be dealt.
+     */
+    void setDeadCards(CardSet deadCards);
+    /**
+     * @brief Get the maximum number of trials
+     * @return maximum number of trials.
+     */
+    qint64 maximumTrialCount() const;
+    /**
+     * @brief Set the maximum number of trials
+     * @param maximumTrialCount maximum number of trials.
+     */
+    void setMaximumTrialCount(qint64 maximumTrialCount);
+    /**
+     * @brief Get the target error
+     * @return target error.
+     */
+    double targetError() const;
+    /**
+     * @brief Set the target error
+     *
+     * The simulation stops when the error of all the players
+     * is below the target. 0 disables the early stop.
+     *
+     * @param targetError target error.
+     */
+    void setTargetError(double targetError);
+    /**
+     * @brief Get the seed
+     * @return seed of the random streams.
+     */
+    quint64 seed() const;
+    /**
+     * @brief Set the seed
+     * @param seed seed of the random streams.
+     */
+    void setSeed(quint64 seed);
+    /**
+     * @brief Get the number of threads
+     * @return number of threads used for the simulation.
+     */
+    int threadCount() const;
+    /**
+     * @brief Set the number of threads
+     * @param threadCount number of threads used for the simulation.
+     */
+    void setThreadCount(int threadCount);
+    /**
+     * @brief Check if the parameters are valid
+     *
+     * There should be at least 2 players, each player should have 0 or 2
+     * cards (4 in Omaha), the board should have at most 5 cards, the same card
+     * should not be used twice and there should be enough cards to deal.
+     *
+     * @return if the parameters are valid.
+     */
+    bool isValid() const;
+    /**
+     * @brief Run the simulation
+     *
+     * This method blocks until the simulation is finished.
+     *
+     * @return if the simulation succeeded.
+     */
+    bool calculate();
+    /**
+     * @brief Compute the exact equity
+     *
+     * All the remaining boards are enumerated instead of being
+     * sampled. Suits where each player, the board and the dead cards
+     * have the same ranks play the same role, so boards that only differ
+     * by a permutation of these suits give the same results: only one of
+     * them is evaluated, and it is weighted by the number of such boards.
+     *
+     * The hole cards of all the players should be known. The first
+     * level of the enumeration is split between the threads.
+     *
+     * @return if the enumeration succeeded.
+     */
+    bool calculateExact();
+    /**
+     * @brief Check if the results are exact
+     * @return if the last results were computed with calculateExact().
+     */
+    bool isExact() const;
+    /**
+     * @brief Get the results of the last simulation
+     * @return the equity of each player.
+     */
+    QList<Equity> results() const;
+    /**
+     * @brief Get the number of trials of the last simulation
+     *
+     * For exact results, this is the number of boards.
+     *
+     * @return number of trials.
+     */
+    qint64 trialCount() const;
+private:
+    Q_DISABLE_COPY(EquityCalculator)
+    friend class EquityTask;
+    friend class ExactEquityTask;
+    /**
+     * @internal
+     * @brief Add the results of a batch
+     *
+     * This method is called by the tasks when a batch is done,
+     * and checks if the simulation should stop.
+     *
+     * @param trialCount number of trials of the batch.
+     * @param shares number of showdowns won by each player, see m_shares.
+     */
+    void addBatch(qint64 trialCount, const qint64 *shares);
+    /**
+     * @internal
+     * @brief Get the index of the next batch to run
+     * @return index of the next batch, or -1 if the simulation is finished.
+     */
+    int nextBatch();
+    /**
+     * @internal
+     * @brief Half-width of the confidence interval of a player
+     * @param player index of the player.
+     * @return half-width of the confidence interval.
+     */
+    double error(int player) const;
+    /**
+     * @internal
+     * @brief Hole cards of the players
+     */
+    QList<CardSet> m_players;
+    /**
+     * @internal
+     * @brief Game variant
+     */
+    Variant m_variant;
+    /**
+     * @internal
+     * @brief Board
+     */
+    CardSet m_board;
+    /**
+     * @internal
+     * @brief Dead cards
+     */
+    CardSet m_deadCards;
+    /**
+     * @internal
+     * @brief Maximum number of trials
+     */
+    qint64 m_maximumTrialCount;
+    /**
+     * @internal
+     * @brief Target error
+     */
+    double m_targetError;
+    /**
+     * @internal
+     * @brief Seed
+     */
+    quint64 m_seed;
+    /**
+     * @internal
+     * @brief Thread pool running the batches
+     */
+    QThreadPool m_threadPool;
+    /**
+     * @internal
+     * @brief Mutex protecting the results
+     */
+    QMutex m_mutex;
+    /**
+     * @internal
+     * @brief Index of the next batch
+     */
+    QAtomicInt m_nextBatch;
+    /**
+     * @internal
+     * @brief Number of batches
+     */
+    int m_batchCount;
+    /**
+     * @internal
+     * @brief If the target error is reached
+     */
+    QAtomicInt m_stopped;
+    /**
+     * @internal
+     * @brief If the results are exact
+     */
+    bool m_exact;
+    /**
+     * @internal
+     * @brief Number of trials done
+     */
+    qint64 m_trialCount;
+    /**
+     * @internal
+     * @brief Number of showdowns won by each player
+     *
+     * The entry player * (playerCount + 1) + k is the number of
+     * showdowns won by the player and shared by k players, so
+     * the equity is computed exactly from integer counts.
+     */
+    QVector<qint64> m_shares;
+};
+
+#endif // EQUITYCALCULATOR_H
@@ -0,0 +1,398 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file evaluatortable.cpp
+ * @short Implementation of EvaluatorTable
+ */
+
+#include "evaluatortable.h"
+#include <string.h>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QVector>
+#include "handevaluator.h"
+
+const quint32 EvaluatorTable::Version;
+const quint32 EvaluatorTable::EntryCount;
+
+/**
+ * @internal
+ * @brief MAGIC
+ *
+ * Constant representing the magic string at the beginning of the file.
+ */
+static const char MAGIC[8] = {'P', 'K', 'Q', 'T', 'E', 'V', 'A', 'L'};
+/**
+ * @internal
+ * @brief CHUNK_SIZE
+ *
+ * Constant representing the number of entries that are written at once
+ * when generating the table.
+ */
+static const int CHUNK_SIZE = 1 << 20;
+
+/**
+ * @internal
+ * @brief Header of the table file
+ *
+ * The header and the entries are stored in the byte
+ * order of the machine.
+ */
+struct EvaluatorTableHeader
+{
+    /**
+     * @internal
+     * @brief Magic string
+     */
+    char magic[8];
+    /**
+     * @internal
+     * @brief Version of the file format
+     */
+    quint32 version;
+    /**
+     * @internal
+     * @brief Size of the header, the entries are stored after the header
+     */
+    quint32 headerSize;
+    /**
+     * @internal
+     * @brief Number of entries
+     */
+    quint64 entryCount;
+    /**
+     * @internal
+     * @brief Checksum of the entries
+     */
+    quint64 checksum;
+};
+
+Q_STATIC_ASSERT(sizeof(EvaluatorTableHeader) == 32);
+
+/**
+ * @internal
+ * @brief Get the size of a table file
+ * @param entryCount number of entries of the table.
+ * @return size of a valid table file.
+ */
+static qint64 fileSize(quint32 entryCount)
+{
+    return sizeof(EvaluatorTableHeader) + qint64(entryCount) * sizeof(quint16);
+}
+
+/**
+ * @internal
+ * @brief Binomial coefficients used to compute the index of a hand
+ *
+ * These coefficients are indexed by the bit of a card in
+ * a CardSet, that is converted to a card number between 0
+ * and 51 (see cardNumber()).
+ */
+struct EvaluatorTableBinomials
+{
+    /**
+     * @internal
+     * @brief Constructor, that fills the coefficients
+     */
+    EvaluatorTableBinomials()
+    {
+        for (int bit = 0; bit < 64; bit++) {
+            for (int k = 0; k < 8; k++) {
+                values[bit][k] = (bit & 0xf) <= 12 ? binomial(cardNumber(bit), k) : 0;
+            }
+        }
+    }
+    /**
+     * @internal
+     * @brief Coefficients
+     */
+    quint32 values[64][8];
+};
+
+/**
+ * @internal
+ * @brief Binomial coefficients
+ */
+static const EvaluatorTableBinomials BINOMIALS;
+
+/**
+ * @internal
+ * @brief Update the checksum of the entries
+ *
+ * This is a FNV-1a hash, computed on 64-bit words. The last
+ * word is padded with zeros if needed, so only the last update
+ * can have a number of entries that is not a multiple of 4.
+ *
+ * @param checksum current checksum.
+ * @param entries entries.
+ * @param count number of entries.
+ * @return updated checksum.
+ */
+static quint64 updateChecksum(quint64 checksum, const quint16 *entries, qint64 count)
+{
+    for (qint64 i = 0; i < count; i += 4) {
+        quint64 word = 0;
+        memcpy(&word, entries + i, qMin<qint64>(4, count - i) * sizeof(quint16));
+        checksum = (checksum ^ word) * Q_UINT64_C(0x100000001b3);
+    }
+    return checksum;
+}
+
+/**
+ * @internal
+ * @brief Initial value of the checksum
+ */
+static const quint64 CHECKSUM_SEED = Q_UINT64_C(0xcbf29ce484222325);
+
+/**
+ * @internal
+ * @brief Check the header of a table file
+ * @param header header to check.
+ * @param entryCount expected number of entries.
+ * @return if the header is valid.
+ */
+static bool checkHeader(const EvaluatorTableHeader *header, quint32 entryCount)
+{
+    return memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0
+           && header->version == EvaluatorTable::Version
+           && header->headerSize == sizeof(EvaluatorTableHeader)
+           && header->entryCount == entryCount;
+}
+
+/**
+ * @internal
+ * @brief Map a table file
+ * @param file file to map, that will be opened.
+ * @param entryCount expected number of entries.
+ * @return the mapped header, or 0 if the file is not a valid table file.
+ */
+static const EvaluatorTableHeader * mapFile(QFile &file, quint32 entryCount)
+{
+    if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+
+    if (file.size() != fileSize(entryCount)) {
+        qDebug() << Q_FUNC_INFO << "Invalid evaluator table size for" << file.fileName();
+        file.close();
+        return 0;
+    }
+
+    const uchar *data = file.map(0, fileSize(entryCount));
+    if (!data) {
+        qDebug() << Q_FUNC_INFO << "Failed to map evaluator table" << file.fileName();
+        file.close();
+        return 0;
+    }
+
+    const EvaluatorTableHeader *header = reinterpret_cast<const EvaluatorTableHeader *>(data);
+    if (!checkHeader(header, entryCount)) {
+        qDebug() << Q_FUNC_INFO << "Invalid evaluator table header for" << file.fileName();
+        file.close();
+        return 0;
+    }
+
+    return header;
+}
+
+/**
+ * @internal
+ * @brief Table file mapped by the process
+ *
+ * The file is mapped when the table is first used, and
+ * kept mapped until the end of the process.
+ */
+class EvaluatorTableFile
+{
+public:
+    /**
+     * @internal
+     * @brief Constructor, that maps the default table file
+     */
+    EvaluatorTableFile()
+        : entries(0)
+    {
+        QString fileName = EvaluatorTable::defaultFileName();
+        if (fileName.isEmpty()) {
+            return;
+        }
+
+        file.setFileName(fileName);
+        const EvaluatorTableHeader *header = mapFile(file, EvaluatorTable::EntryCount);
+        if (header) {
+            entries = reinterpret_cast<const quint16 *>(header + 1);
+        }
+    }
+    /**
+     * @internal
+     * @brief Mapped file
+     */
+    QFile file;
+    /**
+     * @internal
+     * @brief Entries, or 0 if the file is not mapped
+     */
+    const quint16 *entries;
+};
+
+Q_GLOBAL_STATIC(EvaluatorTableFile, tableFile)
+
+quint16 EvaluatorTable::evaluate(CardSet cards)
+{
+    const quint16 *entries = tableFile()->entries;
+    if (entries && cards.count() == 7) {
+        return entries[index(cards)];
+    }
+    return HandEvaluator::evaluate(cards);
+}
+
+bool EvaluatorTable::isAvailable()
+{
+    return tableFile()->entries != 0;
+}
+
+QString EvaluatorTable::defaultFileName()
+{
+    QByteArray fileName = qgetenv("POKQT_EVALUATOR_TABLE");
+    if (!fileName.isEmpty()) {
+        return QString::fromLocal8Bit(fileName);
+    }
+
+    if (QCoreApplication::instance()) {
+        return QCoreApplication::applicationDirPath() + QLatin1String("/pokqt-evaluator.table");
+    }
+
+    return QString();
+}
+
+quint32 EvaluatorTable::index(CardSet cards)
+{
+    quint64 mask = cards.mask();
+    quint32 index = 0;
+    for (int k = 1; mask != 0; k++) {
+        index += BINOMIALS.values[lowestBit(mask)][k];
+        mask &= mask - 1;
+    }
+    return index;
+}
+
+bool EvaluatorTable::generate(const QString &fileName, quint32 entryCount)
+{
+    // The table is written in a temporary file that atomically
+    // replaces the old one when committed. Processes that mapped
+    // the old file are not affected, and processes that map the
+    // file during the generation see the old one.
+    QSaveFile file (fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << Q_FUNC_INFO << "Failed to open" << fileName;
+        return false;
+    }
+
+    EvaluatorTableHeader header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = Version;
+    header.headerSize = sizeof(EvaluatorTableHeader);
+    entryCount = qMin(entryCount, EntryCount);
+    header.entryCount = entryCount;
+    header.checksum = CHECKSUM_SEED;
+    if (file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != sizeof(header)) {
+        qDebug() << Q_FUNC_INFO << "Failed to write" << fileName;
+        return false;
+    }
+
+    // We enumerate all the hands in colexicographical order, which is
+    // the order of the indexes. Cards are numbered between 0 and 51.
+    int cards[8] = {0, 1, 2, 3, 4, 5, 6, PackedCard::CardCount};
+    QVector<quint16> chunk (CHUNK_SIZE);
+    quint16 *entries = chunk.data();
+    quint32 written = 0;
+    while (written < entryCount) {
+        int count = qMin<quint32>(CHUNK_SIZE, entryCount - written);
+        for (int i = 0; i < count; i++) {
+            quint64 mask = 0;
+            for (int j = 0; j < 7; j++) {
+                mask |= Q_UINT64_C(1) << cardNumberBit(cards[j]);
+            }
+            Q_ASSERT(index(CardSet(mask)) == written + i);
+            entries[i] = HandEvaluator::evaluate(CardSet(mask));
+
+            // Next hand: increment the first card that can be incremented
+            // and reset the cards before it. The cards of the last hand
+            // are all consecutive, up to the sentinel, so the loop below
+            // would read past the end of the array.
+            if (written + i + 1 == EntryCount) {
+                break;
+            }
+            int j = 0;
+            while (cards[j] + 1 == cards[j + 1]) {
+                cards[j] = j;
+                j++;
+            }
+            cards[j]++;
+        }
+
+        header.checksum = updateChecksum(header.checksum, entries, count);
+        if (file.write(reinterpret_cast<const char *>(entries),
+                       count * sizeof(quint16)) != qint64(count * sizeof(quint16))) {
+            qDebug() << Q_FUNC_INFO << "Failed to write" << fileName;
+            return false;
+        }
+        written += count;
+    }
+
+    // The checksum is only known at the end, so the header is written again
+    if (!file.seek(0)
+        || file.write(reinterpret_cast<const char *>(&header), sizeof(header)) != sizeof(header)) {
+        qDebug() << Q_FUNC_INFO << "Failed to write the header of" << fileName;
+        return false;
+    }
+
+    if (!file.commit()) {
+        qDebug() << Q_FUNC_INFO << "Failed to save" << fileName;
+        return false;
+    }
+    return true;
+}
+
+bool EvaluatorTable::verify(const QString &fileName, quint32 entryCount)
+{
+    QFile file (fileName);
+    const EvaluatorTableHeader *header = mapFile(file, entryCount);
+    if (!header) {
+        return false;
+    }
+
+    const quint16 *entries = reinterpret_cast<const quint16 *>(header + 1);
+    return updateChecksum(CHECKSUM_SEED, entries, entryCount) == header->checksum;
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef EVALUATORTABLE_H
+#define EVALUATORTABLE_H
+
+/**
+ * @file evaluatortable.h
+ * @short Definition of EvaluatorTable
+ */
+
+#include "pokqt_global.h"
+#include <QtCore/QString>
+#include "cardset.h"
+
+/**
+ * @brief Precomputed 7-card evaluation table
+ *
+ * This class provides the strength of 7-card hands, as computed
+ * by HandEvaluator, with a direct lookup in a precomputed table.
+ * The table contains one 16-bit entry for each of the 133784560
+ * 7-card hands, indexed by the combinatorial index of the hand
+ * (see index()).
+ *
+ * This table is too big to be created when the process starts,
+ * so it is generated once with generate() (the pokqt-tablegen tool
+ * does this), and stored in a binary file. This file contains a
+ * header, with a magic string, a version, the number of entries
+ * and a checksum of the entries, followed by the entries.
+ *
+ * The file is memory-mapped in read only mode the first time
+ * the table is used. Only the header is checked when mapping the
+ * file, so the table is ready almost instantly, and the entries
+ * are loaded from the disk by the system when they are needed. As
+ * the mapping is shared, all the processes that use the table
+ * share the same physical copy, in the page cache. The whole file
+ * can be checked with verify().
+ *
+ * The file is the one given by the POKQT_EVALUATOR_TABLE environment
+ * variable, or pokqt-evaluator.table in the application directory.
+ * If the file is absent or invalid, or if the hand don't have 7 cards,
+ * evaluate() fallbacks to HandEvaluator.
+ */
+class POKQTSHARED_EXPORT EvaluatorTable
+{
+public:
+    /**
+     * @brief Version of the file format
+     */
+    static const quint32 Version = 1;
+    /**
+     * @brief Number of entries in the table
+     */
+    static const quint32 EntryCount = 133784560;
+    /**
+     * @brief Evaluate a hand
+     *
+     * The strength is the same as the one computed by
+     * HandEvaluator::evaluate().
+     *
+     * @param cards cards of the hand.
+     * @return strength of the hand.
+     */
+    static quint16 evaluate(CardSet cards);
+    /**
+     * @brief Get if the table is available
+     *
+     * If the table is not available, evaluate() uses HandEvaluator.
+     *
+     * @return if the table file is mapped.
+     */
+    static bool isAvailable();
+    /**
+     * @brief Get the default file of the table
+     * @return default path of the file of the table.
+     */
+    static QString defaultFileName();
+    /**
+     * @brief Get the index of a 7-card hand
+     *
+     * The index is the position of the hand among all the
+     * 7-card hands, sorted in colexicographical order. The hand
+     * should contain 7 cards.
+     *
+     * @param cards cards of the hand.
+     * @return index of the hand, between 0 and EntryCount - 1.
+     */
+    static quint32 index(CardSet cards);
+    /**
+     * @brief Generate the table
+     *
+     * A table with less entries than EntryCount only contains the
+     * first hands. It is never used by evaluate(), but it is faster
+     * to generate, which is useful to test the file format.
+     *
+     * @param fileName file to write.
+     * @param entryCount number of entries to generate, at most EntryCount.
+     * @return if the generation succeeded.
+     */
+    static bool generate(const QString &fileName, quint32 entryCount = EntryCount);
+    /**
+     * @brief Verify a table file
+     *
+     * This method checks the header and the checksum of
+     * the entries.
+     *
+     * @param fileName file to verify.
+     * @param entryCount expected number of entries.
+     * @return if the file is valid.
+     */
+    static bool verify(const QString &fileName, quint32 entryCount = EntryCount);
+};
+
+#endif // EVALUATORTABLE_H
@@ -36,8 +36,10 @@
 
 #include "gamemanager.h"
 #include <QtCore/QDebug>
-#include <QtCore/QDateTime>
+#include <type_traits>
 #include "betmanager.h"
+#include "gamerules.h"
+#include "showdown.h"
 
 /**
  * @internal
@@ -60,6 +62,17 @@ static const int SMALL_BLIND = 10;
  * Constant representing the amount to pay for the big blind.
  */
 static const int BIG_BLIND = 20;
+/**
+ * @internal
+ * @brief GameRules
+ *
+ * Rules of the variant played by the game manager. Only Texas
+ * Hold'em is supported: the table evaluator and the hands use
+ * the evaluation of Texas Hold'em, and the flop, turn and river
+ * are dealt as 3, 1 and 1 cards.
+ */
+typedef HoldemRules GameRules;
+Q_STATIC_ASSERT((std::is_same<GameRules, HoldemRules>::value));
 /**
  * @todo TODO: We shouldn't put blinds and token count as constant.
  * @todo TODO: Send some messages to describe the game (like: \<player\> raise for 50 tokens)
@@ -68,8 +81,73 @@ static const int BIG_BLIND = 20;
  */
 GameManager::GameManager(QObject *parent) :
     QObject(parent), m_status(Invalid), m_distributedCardsStatus(Initial), m_initialPlayer(-1)
-    , m_currentPlayer(-1), m_pot(0) , m_betManager(new BetManager(this)), m_maxBetHandle(0)
+    , m_currentPlayer(-1), m_defaultGenerator(RandomGenerator::systemSeed())
+    , m_generator(&m_defaultGenerator), m_pot(0) , m_betManager(new BetManager(this)), m_maxBetHandle(0)
+{
+}
+
+quint16 GameManager::handStrength(QObject *handle) const
+{
+    int seat = m_seats.value(handle, -1);
+    if (seat == -1) {
+        return 0;
+    }
+    return m_tableEvaluator.strength(seat);
+}
+
+HandEvaluator::Category GameManager::handCategory(QObject *handle) const
+{
+    return HandEvaluator::category(handStrength(handle));
+}
+
+EvaluationCache * GameManager::evaluationCache() const
 {
+    return m_tableEvaluator.cache();
+}
+
+void GameManager::setEvaluationCache(EvaluationCache *cache)
+{
+    m_tableEvaluator.setCache(cache);
+}
+
+RandomGenerator * GameManager::randomGenerator() const
+{
+    return m_generator;
+}
+
+void GameManager::setRandomGenerator(RandomGenerator *generator)
+{
+    m_generator = generator != 0 ? generator : &m_defaultGenerator;
+}
+
+void GameManager::setSeed(quint64 seed, quint64 stream)
+{
+    m_defaultGenerator.seed(seed, stream);
+}
+
+Deck::ShuffleMode GameManager::shuffleMode() const
+{
+    return m_deck.shuffleMode();
+}
+
+void GameManager::setShuffleMode(Deck::ShuffleMode shuffleMode)
+{
+    m_deck.setShuffleMode(shuffleMode);
+}
+
+DealRecord GameManager::dealRecord() const
+{
+    return m_deck.dealRecord();
+}
+
+void GameManager::replayDeals(const QList<DealRecord> &records)
+{
+    m_replayedDeals = records;
+}
+
+bool GameManager::isReplaying() const
+{
+    return !m_replayedDeals.isEmpty();
 }
 
 void GameManager::start()
@@ -79,9 +157,8 @@ void GameManager::start()
 
 void GameManager::startGame()
 {
-    qsrand(QDateTime::currentMSecsSinceEpoch());
     m_status = Gaming;
-    m_initialPlayer = qrand() % m_handles.count();
+    m_initialPlayer = m_generator->bounded(m_handles.count());
     prepareRound();
 }
 
@@ -175,9 +252,17 @@ void GameManager::prepareRound()
 {
     emit newRoundBroadcasted();
 
-    if (2 * m_handles.count() + 5 > m_deck.count()) {
-        m_deck.reset();
-        m_deck.shuffle();
+    // The cards dealt in the previous round are put back in the
+    // deck, and they are shuffled again while they are dealt,
+    // unless a recorded deal is replayed
+    m_deck.rewind();
+    if (m_deck.cardSet() != CardSet(GameRules::deckMask())) {
+        m_deck.reset(CardSet(GameRules::deckMask()));
+    }
+    if (!m_replayedDeals.isEmpty()) {
+        m_deck.replay(m_replayedDeals.takeFirst());
+    } else {
+        m_deck.shuffle(m_generator);
     }
 
     m_distributedCardsStatus = Initial;
@@ -187,12 +272,18 @@ void GameManager::prepareRound()
         m_playerProperties[handle].setInGame(true);
     }
 
-    // Distribute 2 cards to everybody
-    foreach (QObject *handle, m_handles) {
+    // Distribute the hole cards to everybody
+    m_seats.clear();
+    m_tableEvaluator.reset(m_handles.count());
+    for (int i = 0; i < m_handles.count(); i++) {
+        QObject *handle = m_handles.at(i);
         QList<Card> cards;
-        cards.append(m_deck.draw());
-        cards.append(m_deck.draw());
+        for (int j = 0; j < GameRules::HoleCardCount; j++) {
+            cards.append(m_deck.draw());
+        }
         m_hands[handle].addCards(cards);
+        m_seats.insert(handle, i);
+        m_tableEvaluator.setHoleCards(i, CardSet(cards));
         emit cardsDistributed(handle, cards);
     }
 
@@ -244,7 +335,13 @@ void GameManager::nextTurn()
 
     // Only one player left: he / she wins
     if (inGameCount == 1) {
-        cleanUpRound();
+        QList<QObject *> winners;
+        foreach (QObject *handle, m_handles) {
+            if (m_playerProperties.value(handle).isInGame()) {
+                winners.append(handle);
+            }
+        }
+        cleanUpRound(winners);
     }
 
     // Compute best player
@@ -304,11 +401,14 @@ void GameManager::nextTurn()
     emit playerTurnSelected(m_handles[m_currentPlayer]);
 }
 
-void GameManager::cleanUpRound()
+void GameManager::cleanUpRound(const QList<QObject *> &winners)
 {
-    // Give pot to winner
-    PlayerProperties &player = m_playerProperties[m_maxBetHandle];
-    player.setTokenCount(player.tokenCount() + m_pot);
+    // Split the pot between the winners
+    QList<int> shares = Showdown::splitPot(m_pot, winners.count());
+    for (int i = 0; i < winners.count(); i++) {
+        PlayerProperties &player = m_playerProperties[winners.at(i)];
+        player.setTokenCount(player.tokenCount() + shares.at(i));
+    }
 
     m_pot = 0;
 
@@ -320,6 +420,7 @@ void GameManager::cleanUpRound()
     // Cleanup hands
     m_hands.clear();
     emit endRoundBroadcasted();
+    emit dealRecorded(m_deck.dealRecord());
 
     performGamePropertiesBroadcast();
 
@@ -343,23 +444,27 @@ void GameManager::manageDraw()
 
     emit allCardsBroadcasted(hands);
 
-    // Let's compare all the hands
-    QMap<Hand, QObject *> handsHandle;
-
-    // We use a QMap that automatically sorts by key,
-    // so the last element of handsHandle is the winner
+    // Let's rank the hands of the players who are still in game
+    // The strengths are already computed by the table evaluator, and
+    // players whose hands have the same strength share the pot
+    QList<QObject *> handles;
+    QVector<quint16> strengths;
     foreach (QObject *handle, m_handles) {
-        const Hand &hand = m_hands.value(handle);
-        handsHandle.insert(hand, handle);
+        if (m_playerProperties.value(handle).isInGame()) {
+            handles.append(handle);
+            strengths.append(handStrength(handle));
+        }
     }
 
-    QObject *winner = handsHandle.value(handsHandle.keys().last());
+    QList<QObject *> winners;
+    QList<QList<int> > ranking = Showdown::rank(strengths);
+    if (!ranking.isEmpty()) {
+        foreach (int index, ranking.first()) {
+            winners.append(handles.at(index));
+        }
+    }
 
-    // We cheat: we pass winner as m_maxBetHandle, so cleanUpRound
-    // will give the tokens to the winner, and not the the one who has
-    // the highest bet
-    m_maxBetHandle = winner;
-    cleanUpRound();
+    cleanUpRound(winners);
 }
 
 void GameManager::distributeMiddleCards(int count)
@@ -372,6 +477,7 @@ void GameManager::distributeMiddleCards(int count)
     foreach (QObject *handle, m_handles) {
         m_hands[handle].addCards(cards);
     }
+    m_tableEvaluator.addBoardCards(CardSet(cards));
 
     emit cardsDistributed(cards);
 }
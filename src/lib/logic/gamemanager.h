@@ -43,6 +43,8 @@
 #include "playerproperties.h"
 #include "deck.h"
 #include "hand.h"
+#include "randomgenerator.h"
+#include "tableevaluator.h"
 
 class BetManager;
 
@@ -54,6 +56,8 @@ class BetManager;
  * conditions. It communicates with the NetworkServer via a set
  * of signals and recive orders from slots.
  *
+ * The game manager only plays Texas Hold'em.
+ *
  * Note that the GameManager don't know about the way to communicate
  * with the players. Instead, it uses handles to identify players.
  * These handles are provided as pointers to QObject from the
@@ -87,6 +91,109 @@ public:
      * @param parent parent object.
      */
     explicit GameManager(QObject *parent = 0);
+    /**
+     * @brief Current strength of the hand of a player
+     *
+     * The strength is updated each time cards are distributed,
+     * and it is computed with the hole cards of the player and
+     * the cards in the middle of the table.
+     *
+     * @param handle handle of the player.
+     * @return strength of the hand of the player, or 0 if the player is not in the round.
+     */
+    quint16 handStrength(QObject *handle) const;
+    /**
+     * @brief Current category of the hand of a player
+     * @param handle handle of the player.
+     * @return category of the hand of the player.
+     */
+    HandEvaluator::Category handCategory(QObject *handle) const;
+    /**
+     * @brief Cache of the strengths of the hands
+     * @return cache of the strengths of the hands, or 0 if there is no cache.
+     */
+    EvaluationCache * evaluationCache() const;
+    /**
+     * @brief Set the cache of the strengths of the hands
+     *
+     * The cache can be shared between several game managers,
+     * even if they run in different threads. It is not owned by
+     * the game manager.
+     *
+     * @param cache cache of the strengths of the hands, or 0 to not use a cache.
+     */
+    void setEvaluationCache(EvaluationCache *cache);
+    /**
+     * @brief Random number generator
+     * @return random number generator used to shuffle the deck.
+     */
+    RandomGenerator * randomGenerator() const;
+    /**
+     * @brief Set the random number generator
+     *
+     * The generator is not owned by the game manager, and it
+     * should not be shared with other game managers that run
+     * in other threads.
+     *
+     * @param generator random number generator, or 0 to use the default one.
+     */
+    void setRandomGenerator(RandomGenerator *generator);
+    /**
+     * @brief Seed the default random number generator
+     *
+     * By default, the generator is seeded by the system. Tables
+     * that are seeded with the same master seed, but different
+     * streams, deal independent cards, and a table seeded again
+     * with the same seed and stream deals the same cards.
+     *
+     * @param seed master seed.
+     * @param stream index of the stream, like the index of the table.
+     */
+    void setSeed(quint64 seed, quint64 stream = 0);
+    /**
+     * @brief Get the shuffle mode of the deck
+     * @return shuffle mode of the deck.
+     */
+    Deck::ShuffleMode shuffleMode() const;
+    /**
+     * @brief Set the shuffle mode of the deck
+     *
+     * Tables where the players should not be able to guess
+     * the cards should use Deck::SecureShuffle. The random
+     * generator is then only used to select the first player.
+     *
+     * @param shuffleMode shuffle mode of the deck.
+     */
+    void setShuffleMode(Deck::ShuffleMode shuffleMode);
+    /**
+     * @brief Cards dealt in the current round
+     *
+     * The record is complete at the end of the round, when
+     * dealRecorded() is emitted.
+     *
+     * @return cards dealt in the current round, in the order they were dealt.
+     */
+    DealRecord dealRecord() const;
+    /**
+     * @brief Replay recorded deals
+     *
+     * The next rounds deal the cards of the records, in the same
+     * order, instead of shuffling the deck, one record per round.
+     * When all the records are used, the deck is shuffled again.
+     *
+     * The records only contain the cards, so the same players should
+     * be seated in the same order, and the same player should start,
+     * to get the same hands. The first player is selected with the
+     * random generator, see setSeed().
+     *
+     * @param records records of the rounds to replay.
+     */
+    void replayDeals(const QList<DealRecord> &records);
+    /**
+     * @brief Get if recorded deals are replayed
+     * @return if there are recorded deals that are not replayed yet.
+     */
+    bool isReplaying() const;
 public slots:
     /**
      * @brief Starts the server
@@ -199,6 +306,15 @@ signals:
      * @param hands list of hands for all players.
      */
     void allCardsBroadcasted(const QList<Hand> &hands);
+    /**
+     * @brief The cards of a round are recorded
+     *
+     * This signal is emitted at the end of each round, so that
+     * the round can be replayed with replayDeals().
+     *
+     * @param record cards dealt in the round, in the order they were dealt.
+     */
+    void dealRecorded(const DealRecord &record);
 private:
     /**
      * @internal
@@ -257,8 +373,12 @@ private:
     /**
      * @internal
      * @brief Cleanup a round
+     *
+     * The pot is split between the winners.
+     *
+     * @param winners handles of the winners.
      */
-    void cleanUpRound();
+    void cleanUpRound(const QList<QObject *> &winners);
     /**
      * @internal
      * @brief Manage the draw (two people bet the same amount of tokens at the end)
@@ -309,11 +429,36 @@ private:
      * @brief Map that maps a handle to a player's hand
      */
     QMap<QObject *, Hand> m_hands;
+    /**
+     * @internal
+     * @brief Map that maps a handle to the seat of a player in the table evaluator
+     */
+    QMap<QObject *, int> m_seats;
+    /**
+     * @internal
+     * @brief Table evaluator, that keeps the strength of the hands of the round
+     */
+    TableEvaluator m_tableEvaluator;
     /**
      * @internal
      * @brief Deck
      */
     Deck m_deck;
+    /**
+     * @internal
+     * @brief Default random number generator
+     */
+    XoshiroGenerator m_defaultGenerator;
+    /**
+     * @internal
+     * @brief Random number generator used to shuffle the deck
+     */
+    RandomGenerator *m_generator;
+    /**
+     * @internal
+     * @brief Recorded deals to replay in the next rounds
+     */
+    QList<DealRecord> m_replayedDeals;
     /**
      * @internal
      * @brief Pot
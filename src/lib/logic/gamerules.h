@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef GAMERULES_H
+#define GAMERULES_H
+
+/**
+ * @file gamerules.h
+ * @short Definition of the rule policies of the game variants
+ *
+ * A rule policy describes a poker variant: the number of hole
+ * cards, the number of hole cards that must be used, the cards of
+ * the deck, and how hands are evaluated. Policies are classes
+ * with only enums and static methods, that are used as template
+ * parameters, so that each variant gets its own code, without
+ * checking the variant at runtime.
+ *
+ * A rule policy provides:
+ * - HoleCardCount: number of hole cards dealt to each player.
+ * - UsedHoleCardCount: number of hole cards that must be used
+ *   in the five cards of a hand, or 0 if any cards can be used.
+ * - BoardCardCount: number of cards of the board.
+ * - deckMask(): mask of the CardSet of the deck.
+ * - evaluate(): strength of the hand of a player, from the hole
+ *   cards and the board. Strengths of a variant can be compared
+ *   between each other.
+ * - category(): category of a strength.
+ */
+
+#include "pokqt_global.h"
+#include "bitops.h"
+#include "cardset.h"
+#include "handevaluator.h"
+#include "omahaevaluator.h"
+
+/**
+ * @brief Evaluate a hand that must use a given number of hole cards
+ *
+ * The best hand is searched among the hands made of exactly
+ * UsedHoleCardCount hole cards and 5 - UsedHoleCardCount cards of
+ * the board. If the board do not have enough cards yet, all the
+ * cards of the board are used.
+ *
+ * The subsets of cards are enumerated as submasks of the masks of
+ * the hole cards and of the board.
+ *
+ * @param holeCards hole cards.
+ * @param board cards of the board.
+ * @return strength of the best hand, as returned by HandEvaluator.
+ */
+template <int UsedHoleCardCount>
+quint16 evaluateUsingHoleCards(CardSet holeCards, CardSet board)
+{
+    const quint64 holeMask = holeCards.mask();
+    const quint64 boardMask = board.mask();
+    const int boardCardCount = qMin(5 - UsedHoleCardCount, board.count());
+
+    quint16 best = 0;
+    for (quint64 hole = holeMask; hole != 0; hole = (hole - 1) & holeMask) {
+        if (bitCount(hole) != UsedHoleCardCount) {
+            continue;
+        }
+        if (boardCardCount == 0) {
+            best = qMax(best, HandEvaluator::evaluate(CardSet(hole)));
+            continue;
+        }
+        for (quint64 cards = boardMask; cards != 0; cards = (cards - 1) & boardMask) {
+            if (bitCount(cards) == boardCardCount) {
+                best = qMax(best, HandEvaluator::evaluate(CardSet(hole | cards)));
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Rules of Texas Hold'em
+ *
+ * Two hole cards, and the best five cards among the hole
+ * cards and the board.
+ */
+class HoldemRules
+{
+public:
+    enum {
+        /**
+         * @brief Number of hole cards
+         */
+        HoleCardCount = 2,
+        /**
+         * @brief Number of hole cards that must be used, 0 for any
+         */
+        UsedHoleCardCount = 0,
+        /**
+         * @brief Number of cards of the board
+         */
+        BoardCardCount = 5
+    };
+    /**
+     * @brief Cards of the deck
+     * @return mask of the 52 cards.
+     */
+    static Q_DECL_CONSTEXPR quint64 deckMask()
+    {
+        return CardSet::FullMask;
+    }
+    /**
+     * @brief Evaluate a hand
+     * @param holeCards hole cards.
+     * @param board cards of the board.
+     * @return strength of the hand.
+     */
+    static inline quint16 evaluate(CardSet holeCards, CardSet board)
+    {
+        return HandEvaluator::evaluate(holeCards | board);
+    }
+    /**
+     * @brief Get the category of a strength
+     * @param strength strength returned by evaluate().
+     * @return category of the hand.
+     */
+    static inline HandEvaluator::Category category(quint16 strength)
+    {
+        return HandEvaluator::category(strength);
+    }
+};
+
+/**
+ * @brief Rules of short-deck Hold'em
+ *
+ * The deck has 36 cards, from 6 to ace. A flush beats a
+ * full house, and the ace can be used as a 5 to build
+ * the A6789 straight, that is the lowest straight.
+ *
+ * Strengths use the layout of HandEvaluator, except that the
+ * FullHouse and Flush categories are swapped, so that they
+ * can be compared directly. The A6789 straight is stored as
+ * the 5432A straight of Texas Hold'em, that can't be made with
+ * this deck.
+ */
+class ShortDeckRules
+{
+public:
+    enum {
+        /**
+         * @brief Number of hole cards
+         */
+        HoleCardCount = 2,
+        /**
+         * @brief Number of hole cards that must be used, 0 for any
+         */
+        UsedHoleCardCount = 0,
+        /**
+         * @brief Number of cards of the board
+         */
+        BoardCardCount = 5
+    };
+    /**
+     * @brief Cards of the deck
+     * @return mask of the 36 cards, from 6 to ace.
+     */
+    static Q_DECL_CONSTEXPR quint64 deckMask()
+    {
+        return Q_UINT64_C(0x1ff01ff01ff01ff0);
+    }
+    /**
+     * @brief Evaluate a hand
+     * @param holeCards hole cards.
+     * @param board cards of the board.
+     * @return strength of the hand.
+     */
+    static quint16 evaluate(CardSet holeCards, CardSet board)
+    {
+        // Ranks of the A6789 straight
+        static const quint16 lowStraight = 0x10f0;
+
+        const CardSet cards = holeCards | board;
+        quint16 strength = HandEvaluator::evaluate(cards);
+        int category = strength >> 12;
+
+        if (category < HandEvaluator::StraightFlush) {
+            for (int suit = 0; suit < 4; suit++) {
+                if ((cards.suitMask(suit) & lowStraight) == lowStraight) {
+                    strength = (HandEvaluator::StraightFlush << 12) | 3;
+                    category = HandEvaluator::StraightFlush;
+                }
+            }
+        }
+        if (category < HandEvaluator::Straight && (cards.rankMask() & lowStraight) == lowStraight) {
+            strength = (HandEvaluator::Straight << 12) | 3;
+            category = HandEvaluator::Straight;
+        }
+
+        // The flush beats the full house
+        if (category == HandEvaluator::Flush || category == HandEvaluator::FullHouse) {
+            strength ^= (HandEvaluator::Flush ^ HandEvaluator::FullHouse) << 12;
+        }
+        return strength;
+    }
+    /**
+     * @brief Get the category of a strength
+     * @param strength strength returned by evaluate().
+     * @return category of the hand.
+     */
+    static inline HandEvaluator::Category category(quint16 strength)
+    {
+        const int category = strength >> 12;
+        if (category == HandEvaluator::Flush || category == HandEvaluator::FullHouse) {
+            return HandEvaluator::Category(category ^ HandEvaluator::Flush ^ HandEvaluator::FullHouse);
+        }
+        return HandEvaluator::Category(category);
+    }
+};
+
+/**
+ * @brief Rules of Omaha
+ *
+ * Four hole cards, and the five cards of a hand are made of
+ * exactly two hole cards and three cards of the board.
+ */
+class OmahaRules
+{
+public:
+    enum {
+        /**
+         * @brief Number of hole cards
+         */
+        HoleCardCount = 4,
+        /**
+         * @brief Number of hole cards that must be used, 0 for any
+         */
+        UsedHoleCardCount = 2,
+        /**
+         * @brief Number of cards of the board
+         */
+        BoardCardCount = 5
+    };
+    /**
+     * @brief Cards of the deck
+     * @return mask of the 52 cards.
+     */
+    static Q_DECL_CONSTEXPR quint64 deckMask()
+    {
+        return CardSet::FullMask;
+    }
+    /**
+     * @brief Evaluate a hand
+     * @param holeCards hole cards.
+     * @param board cards of the board.
+     * @return strength of the hand.
+     */
+    static inline quint16 evaluate(CardSet holeCards, CardSet board)
+    {
+        return OmahaEvaluator::evaluate(holeCards, board);
+    }
+    /**
+     * @brief Get the category of a strength
+     * @param strength strength returned by evaluate().
+     * @return category of the hand.
+     */
+    static inline HandEvaluator::Category category(quint16 strength)
+    {
+        return HandEvaluator::category(strength);
+    }
+};
+
+#endif // GAMERULES_H
@@ -35,8 +35,8 @@
  */
 
 #include "hand.h"
+#include "handevaluator.h"
 #include <functional>
-#include <QtCore/QMultiMap>
 
 Hand::Hand()
 {
@@ -68,71 +68,15 @@ bool Hand::operator<(const Hand &other) const
         return true;
     }
 
-    QList<Card> myCards = m_cards;
-    QList<Card> otherCards = other.cards();
-
-    // We get a sorted list of cards (decending order)
-    std::sort(myCards.begin(), myCards.end(), std::greater<Card>());
-    std::sort(otherCards.begin(), otherCards.end(), std::greater<Card>());
-
-    bool equal = false;
-    QList<Card> myCombo = straightFlush(myCards);
-    QList<Card> otherCombo = straightFlush(myCards);
-    bool lesser = compareLesser(myCombo, otherCombo, myCards, otherCards, &equal);
-    if (!equal) {
-        return lesser;
-    }
-
-    myCombo = four(myCards);
-    otherCombo = four(myCards);
-    lesser = compareLesser(myCombo, otherCombo, myCards, otherCards, &equal);
-    if (!equal) {
-        return lesser;
-    }
-
-    myCombo = fullHouse(myCards);
-    otherCombo = fullHouse(myCards);
-    lesser = compareLesser(myCombo, otherCombo, myCards, otherCards, &equal);
-    if (!equal) {
-        return lesser;
-    }
-
-    myCombo = flush(myCards);
-    otherCombo = flush(myCards);
-    lesser = compareLesser(myCombo, otherCombo, myCards, otherCards, &equal);
-    if (!equal) {
-        return lesser;
-    }
-
-    myCombo = straight(myCards);
-    otherCombo = straight(myCards);
-    lesser = compareLesser(myCombo, otherCombo, myCards, otherCards, &equal);
-    if (!equal) {
-        return lesser;
-    }
-
-    myCombo = three(myCards);
-    otherCombo = three(myCards);
-    lesser = compareLesser(myCombo, otherCombo, myCards, otherCards, &equal);
-    if (!equal) {
-        return lesser;
+    quint16 strength = HandEvaluator::evaluate(cardSet());
+    quint16 otherStrength = HandEvaluator::evaluate(other.cardSet());
+    if (strength != otherStrength) {
+        return strength < otherStrength;
     }
 
-    myCombo = twoPairs(myCards);
-    otherCombo = twoPairs(myCards);
-    lesser = compareLesser(myCombo, otherCombo, myCards, otherCards, &equal);
-    if (!equal) {
-        return lesser;
-    }
-
-    myCombo = pair(myCards);
-    otherCombo = pair(myCards);
-    lesser = compareLesser(myCombo, otherCombo, myCards, otherCards, &equal);
-    if (!equal) {
-        return lesser;
-    }
-
-    return highCardLesser(myCards, otherCards);
+    // Both hands have the same value, so we compare the
+    // highest cards, including suits, to always have a winner
+    return highCardLesser(m_cards, other.cards());
 }
 
 bool Hand::isEmpty() const
@@ -145,6 +89,16 @@ QList<Card> Hand::cards() const
     return m_cards;
 }
 
+CardSet Hand::cardSet() const
+{
+    return CardSet(m_cards);
+}
+
+BestFive Hand::bestFive() const
+{
+    return BestFive(cardSet());
+}
+
 void Hand::addCard(const Card &card)
 {
     m_cards.append(card);
@@ -162,212 +116,42 @@ void Hand::clear()
 
 QList<Card> Hand::straightFlush(const QList<Card> &cards)
 {
-    // Straight flush is a straight that is also a flush
-    // Basically, we sort cards by suit and try if there is a straight in them
-    QMultiMap<Card::Suit, Card> cardsBySuit;
-
-    foreach (const Card &card, cards) {
-        cardsBySuit.insert(card.suit(), card);
-    }
-
-    QList<Card> straightCards = straight(cardsBySuit.values(Card::Spade));
-    if (!straightCards.isEmpty()) {
-        return straightCards;
-    }
-    straightCards = straight(cardsBySuit.values(Card::Heart));
-    if (!straightCards.isEmpty()) {
-        return straightCards;
-    }
-    straightCards = straight(cardsBySuit.values(Card::Diamond));
-    if (!straightCards.isEmpty()) {
-        return straightCards;
-    }
-    straightCards = straight(cardsBySuit.values(Card::Club));
-    if (!straightCards.isEmpty()) {
-        return straightCards;
-    }
-
-    return QList<Card>();
+    return BestFive::combo(CardSet(cards), HandEvaluator::StraightFlush).toList();
 }
 
 QList<Card> Hand::four(const QList<Card> &cards)
 {
-    return nCards(cards, 4);
+    return BestFive::combo(CardSet(cards), HandEvaluator::Four).toList();
 }
 
 QList<Card> Hand::fullHouse(const QList<Card> &cards)
 {
-    // Full house is basically a 3 followed by a 2
-    // Note on comparing full houses: we compare the biggest values in
-    // between the 3 before comparing the biggest values between the 2
-    QList<Card> updatedCards = cards;
-    QList<Card> threeCards = three(updatedCards);
-
-    if (threeCards.isEmpty()) {
-        return QList<Card>();
-    }
-
-    foreach (const Card &card, threeCards) {
-        updatedCards.removeAll(card);
-    }
-
-    QList<Card> pairCards = pair(updatedCards);
-
-    if (pairCards.isEmpty()) {
-        return QList<Card>();
-    }
-
-    QList<Card> returnedCards;
-    returnedCards.append(threeCards);
-    returnedCards.append(pairCards);
-
-    return returnedCards;
+    return BestFive::combo(CardSet(cards), HandEvaluator::FullHouse).toList();
 }
 
 QList<Card> Hand::flush(const QList<Card> &cards)
 {
-    // Idea of the algo is
-    // 1. sort the cards by descending order
-    // 2. check if there is a group of exaclty 5 cards in the list
-    // 3. if yes, return the list, if no return an empty list
-    QList<Card> sortedCards = cards;
-    std::sort(sortedCards.begin(), sortedCards.end(), std::greater<Card>());
-
-    Card::Suit currentSuit = Card::Invalid;
-    QList<Card> returnedCards;
-
-    foreach (const Card &card, sortedCards) {
-        if (card.suit() != currentSuit) {
-            currentSuit = card.suit();
-            returnedCards.clear();
-        }
-        returnedCards.append(card);
-
-        if (returnedCards.count() == 5) {
-            return returnedCards;
-        }
-    }
-
-    return QList<Card>();
+    return BestFive::combo(CardSet(cards), HandEvaluator::Flush).toList();
 }
 
 QList<Card> Hand::straight(const QList<Card> &cards)
 {
-    // Idea of the algo is
-    // 1. sort the cards by descending order
-    // 2. check if there is a group of exaclty 5 cards in the list that is decreasing by 1
-    //    each time
-    // 3. if yes, return the list, if no return an empty list
-    // Remark: Aces are both the biggest and smallest card (ie AKQJ10 and 5432A), so
-    // we are cheating by adding aces at the end of the sorted list if there are aces.
-    // Moreover, we will consider that under rank 0 (that is rank of a 2), we have rank
-    // 12 (rank of an ace)
-    // Remark 2: we should also manage cases like AKQJJ10, with two or more cards
-    // having the same rank.
-
-    QList<Card> sortedCards = cards;
-    QList<Card> aces;
-    std::sort(sortedCards.begin(), sortedCards.end(), std::greater<Card>());
-    foreach (const Card &card, sortedCards) {
-        if (card.rank() == 12) { // Ace
-            aces.append(card);
-        }
-    }
-
-    sortedCards.append(aces);
-
-    int currentRank = -1;
-    QList<Card> returnedCards;
-
-    foreach (const Card &card, sortedCards) {
-        if ((card.rank() == currentRank - 1) || (currentRank == 0 && card.rank() == 12)) {
-            // Note that we don't set to the rank of the card
-            // otherwise, we might create stuff like 2AKQJ.
-            // by -- the rank, after an ace, we get rank -1, that
-            // other card can match
-            currentRank --;
-            returnedCards.append(card);
-        } else if (card.rank() != currentRank) {
-            currentRank = card.rank();
-            returnedCards.clear();
-            returnedCards.append(card);
-        }
-        // Do nothing if we find a card with the same rank
-
-        if (returnedCards.count() == 5) {
-            return returnedCards;
-        }
-    }
-
-    return QList<Card>();
+    return BestFive::combo(CardSet(cards), HandEvaluator::Straight).toList();
 }
 
 QList<Card> Hand::three(const QList<Card> &cards)
 {
-    return nCards(cards, 3);
+    return BestFive::combo(CardSet(cards), HandEvaluator::Three).toList();
 }
 
 QList<Card> Hand::twoPairs(const QList<Card> &cards)
 {
-    // Idea of the algo is
-    // 1. search for the first pair (biggest pair)
-    // 2. if not found return, else search for a second pair (second biggest pair)
-    // 3. if not found return, else construct a list of the two pairs
-    QList<Card> updatedCards = cards;
-    QList<Card> firstPair = pair(updatedCards);
-
-    if (firstPair.isEmpty()) {
-        return QList<Card>();
-    }
-
-    foreach (const Card &card, firstPair) {
-        updatedCards.removeAll(card);
-    }
-
-    QList<Card> secondPair = pair(updatedCards);
-
-    if (secondPair.isEmpty()) {
-        return QList<Card>();
-    }
-
-    QList<Card> returnedCards;
-    returnedCards.append(firstPair);
-    returnedCards.append(secondPair);
-
-    return returnedCards;
+    return BestFive::combo(CardSet(cards), HandEvaluator::TwoPairs).toList();
 }
 
 QList<Card> Hand::pair(const QList<Card> &cards)
 {
-    return nCards(cards, 2);
-}
-
-QList<Card> Hand::nCards(const QList<Card> &cards, int n)
-{
-    // The idea of the algo that extract the pair is
-    // 1. sort the cards by descending order
-    // 2. check if there is a group of exaclty n cards in the list
-    // 3. if yes, return the list, if no return an empty list
-
-    QList<Card> sortedCards = cards;
-    std::sort(sortedCards.begin(), sortedCards.end(), std::greater<Card>());
-
-    int currentRank = -1;
-    QList<Card> returnedCards;
-
-    foreach (const Card &card, sortedCards) {
-        if (card.rank() != currentRank) {
-            currentRank = card.rank();
-            returnedCards.clear();
-        }
-        returnedCards.append(card);
-
-        if (returnedCards.count() == n) {
-            return returnedCards;
-        }
-    }
-
-    return QList<Card>();
+    return BestFive::combo(CardSet(cards), HandEvaluator::Pair).toList();
 }
 
 bool Hand::highCardLesser(const QList<Card> &cards1, const QList<Card> cards2)
@@ -393,48 +177,7 @@ bool Hand::highCardLesser(const QList<Card> &cards1, const QList<Card> cards2)
     // All the first cards are equal
     // fallback to checking if one have more cards than
     // the other.
-    return sortedCards1.count() <= sortedCards2.count();
-}
-
-bool Hand::compareLesser(const QList<Card> &combo1, const QList<Card> &combo2,
-                         const QList<Card> &allCards1, const QList<Card> &allCards2, bool *equal)
-{
-    // Note that this function is, at best practical, and could be refactored
-    // as a macro, or as a function with a better behaviour.
-
-    // Set equal to false
-    if (equal) {
-        *equal = false;
-    }
-
-    // Noone have this combo, so we are equal
-    if (combo1.isEmpty() && combo2.isEmpty()) {
-        if (equal) {
-            *equal = true;
-        }
-
-        // Dummy return
-        return true;
-    }
-
-    // 1 don't have the combo, but 2 have
-    if (combo1.isEmpty()) {
-        return true;
-    }
-
-    // 2 don't have the combo, but 1 have
-    if (combo2.isEmpty()) {
-        return false;
-    }
-
-    // Both have, we compare the higest card
-    if (combo1 != combo2) {
-        return highCardLesser(combo1, combo2);
-    }
-
-    // Last resort: the combo are the same, compare
-    // the highest card is all cards.
-    return highCardLesser(allCards1, allCards2);
+    return sortedCards1.count() < sortedCards2.count();
 }
 
 QDataStream &operator <<(QDataStream &stream, const Hand &hand)
@@ -40,6 +40,8 @@
 #include "pokqt_global.h"
 #include <QtCore/QList>
 #include "card.h"
+#include "cardset.h"
+#include "bestfive.h"
 
 /**
  * @brief A hand
@@ -56,11 +58,11 @@
  * This class then groups cards in hand and
  * flop / turn / river together.
  *
- * operator< compares two hands following poker rules. We can
- * determine who is a winner by simply comparing hands with <.
- * Remark that we don't have equality in this version of pokQt:
- * there is always a winner, as we compare the higest card if
- * we don't have a draw.
+ * operator< compares two hands following poker rules, using
+ * HandEvaluator. We can determine who is a winner by simply
+ * comparing hands with <. Remark that we don't have equality in
+ * this version of pokQt: there is always a winner, as we compare
+ * the higest card if we don't have a draw.
  */
 class POKQTSHARED_EXPORT Hand
 {
@@ -109,6 +111,16 @@ public:
      * @return cards in the hand.
      */
     QList<Card> cards() const;
+    /**
+     * @brief Get the cards in the hand as a set
+     * @return cards in the hand, as a CardSet.
+     */
+    CardSet cardSet() const;
+    /**
+     * @brief Get the best five cards of the hand
+     * @return best five cards of the hand, with the category of the hand.
+     */
+    BestFive bestFive() const;
     /**
      * @brief Add a card to the hand
      * @param card card to add.
@@ -125,6 +137,10 @@ public:
     void clear();
     /**
      * @brief Extract a straight flush
+     *
+     * These static methods use BestFive::combo(), and only
+     * return the cards of the combo, without kickers.
+     *
      * @param cards a list of cards.
      * @return the most powerful straight flush from the inputted cards.
      */
@@ -172,14 +188,6 @@ public:
      */
     static QList<Card> pair(const QList<Card> &cards);
 private:
-    /**
-     * @internal
-     * @brief Extract a n-cards
-     * @param cards a list of cards.
-     * @param n a number of identical cards to extract.
-     * @return the most powerful n-cards.
-     */
-    static QList<Card> nCards(const QList<Card> &cards, int n);
     /**
      * @internal
      * @brief Compare high cards
@@ -190,29 +198,14 @@ private:
      *
      * Warning: you can compare two lists with a different number of cards,
      * but it will only compare n cards (n = min(nb cards 1, nb cards 2).
-     * And if the two compared sets are equal, this function returns true.
-     * If not, the number of cards is compared: if nb cards 2 > nb cards 1,
-     * this returns false.
+     * If these cards are equal, the number of cards is compared: this
+     * returns true only if nb cards 1 < nb cards 2.
      *
      * @param cards1 first list of cards.
      * @param cards2 second list of cards
      * @return if the first list of cards is less powerful than the second
      */
     static bool highCardLesser(const QList<Card> &cards1, const QList<Card> cards2);
-    /**
-     * @internal
-     * @brief Helper method used to compare combos
-     * @param combo1 a combo returned by the combo extractors.
-     * @param combo2 a combo returned by the combo extractors.
-     * @param allCards1 all cards for the first player.
-     * @param allCards2 all cards for the second player.
-     * @param equal a pointer to check if the players are equal.
-     * @return if the first player is less powerful or have equal power compared to the second
-     * player.
-     */
-    static bool compareLesser(const QList<Card> &combo1, const QList<Card> &combo2,
-                              const QList<Card> &allCards1, const QList<Card> &allCards2,
-                              bool *equal = 0);
     /**
      * @internal
      * @brief Cards
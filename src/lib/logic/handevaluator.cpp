@@ -0,0 +1,490 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file handevaluator.cpp
+ * @short Implementation of HandEvaluator
+ */
+
+#include "handevaluator.h"
+#include "handkernels.h"
+#include "ranktables.h"
+
+/**
+ * @internal
+ * @brief HANDEVALUATOR_FORCE_INLINE
+ *
+ * Used for the functions shared by the evaluator and the
+ * batch kernels, that are too large to be inlined by default.
+ */
+#if defined(Q_CC_GNU)
+#define HANDEVALUATOR_FORCE_INLINE inline __attribute__((always_inline))
+#elif defined(Q_CC_MSVC)
+#define HANDEVALUATOR_FORCE_INLINE __forceinline
+#else
+#define HANDEVALUATOR_FORCE_INLINE inline
+#endif
+
+/**
+ * @internal
+ * @brief Compute the value of one kicker
+ * @param mask rank mask containing the kicker.
+ * @return the position of the highest rank, among all sets of at most 1 rank.
+ */
+static inline int oneKicker(quint16 mask)
+{
+    return mask != 0 ? highestBit(mask) + 1 : 0;
+}
+
+/**
+ * @internal
+ * @brief Compute the value of two kickers
+ * @param mask rank mask containing the kickers.
+ * @return the position of the two highest ranks, among all sets of at most 2 ranks.
+ */
+static inline int twoKickers(quint16 mask)
+{
+    if (mask == 0) {
+        return 0;
+    }
+
+    int first = highestBit(mask);
+    int position = 1 + first + first * (first - 1) / 2;
+    return position + oneKicker(mask & ~(1 << first));
+}
+
+/**
+ * @internal
+ * @brief Evaluate a hand that contains a flush
+ * @param suitMask rank mask of the suit that have at least 5 cards.
+ * @return strength of the hand.
+ */
+static inline quint16 evaluateFlush(quint16 suitMask)
+{
+    int straight = RankTables::straights[suitMask];
+    if (straight != 0) {
+        return (HandEvaluator::StraightFlush << 12) | (straight - 1);
+    }
+    return (HandEvaluator::Flush << 12) | RankTables::highCards[suitMask];
+}
+
+/**
+ * @internal
+ * @brief Evaluate a hand that do not contain a flush
+ *
+ * The hand is described by the masks of the ranks that are
+ * present in at least one, two, three or four suits.
+ *
+ * @param ranks ranks present in at least one suit.
+ * @param fours ranks present in the four suits.
+ * @param threes ranks present in exactly three suits.
+ * @param pairs ranks present in exactly two suits.
+ * @return strength of the hand.
+ */
+static HANDEVALUATOR_FORCE_INLINE quint16 evaluateCombos(quint16 ranks, quint16 fours, quint16 threes, quint16 pairs)
+{
+    if (fours != 0) {
+        int four = highestBit(fours);
+        return (HandEvaluator::Four << 12) | (four * 14 + oneKicker(ranks & ~(1 << four)));
+    }
+
+    int three = -1;
+    if (threes != 0) {
+        three = highestBit(threes);
+
+        // A second three can be used as a pair
+        const quint16 fullHousePairs = (threes & ~(1 << three)) | pairs;
+        if (fullHousePairs != 0) {
+            return (HandEvaluator::FullHouse << 12) | (three * 13 + highestBit(fullHousePairs));
+        }
+    }
+
+    int straight = RankTables::straights[ranks];
+    if (straight != 0) {
+        return (HandEvaluator::Straight << 12) | (straight - 1);
+    }
+
+    if (three != -1) {
+        return (HandEvaluator::Three << 12) | (three * 92 + twoKickers(ranks & ~(1 << three)));
+    }
+
+    if (pairs != 0) {
+        int firstPair = highestBit(pairs);
+        const quint16 otherPairs = pairs & ~(1 << firstPair);
+        if (otherPairs != 0) {
+            int secondPair = highestBit(otherPairs);
+            const quint16 kickers = ranks & ~(1 << firstPair) & ~(1 << secondPair);
+            return (HandEvaluator::TwoPairs << 12)
+                   | ((firstPair * 13 + secondPair) * 14 + oneKicker(kickers));
+        }
+
+        // The rank of the pair is removed from the kickers mask
+        // so that the kickers fit in 299 values
+        const quint16 lowerKickers = ranks & ((1 << firstPair) - 1);
+        const quint16 higherKickers = (ranks >> (firstPair + 1)) << firstPair;
+        return (HandEvaluator::Pair << 12)
+               | (firstPair * 299 + RankTables::threeKickers[lowerKickers | higherKickers]);
+    }
+
+    return (HandEvaluator::HighCard << 12) | RankTables::highCards[ranks];
+}
+
+quint16 HandEvaluator::evaluate(CardSet cards)
+{
+    const quint16 clubs = cards.suitMask(0);
+    const quint16 diamonds = cards.suitMask(1);
+    const quint16 hearts = cards.suitMask(2);
+    const quint16 spades = cards.suitMask(3);
+
+    // With 7 cards or less, if there is a flush, there can't
+    // be a four or a full house, so the flush is the best
+    // possible combo if it is not a straight flush
+    if (Q_UNLIKELY(hasFlush(cards.mask()))) {
+        if (RankTables::bitCounts[clubs] >= 5) {
+            return evaluateFlush(clubs);
+        }
+        if (RankTables::bitCounts[diamonds] >= 5) {
+            return evaluateFlush(diamonds);
+        }
+        if (RankTables::bitCounts[hearts] >= 5) {
+            return evaluateFlush(hearts);
+        }
+        return evaluateFlush(spades);
+    }
+
+    // Ranks that are present in the four suits, at least three suits,
+    // and at least two suits
+    const quint16 ranks = clubs | diamonds | hearts | spades;
+    const quint16 fours = clubs & diamonds & hearts & spades;
+    const quint16 threes = ((clubs & diamonds) & (hearts | spades))
+                           | ((hearts & spades) & (clubs | diamonds));
+    const quint16 pairs = ((clubs & (diamonds | hearts | spades))
+                           | (diamonds & (hearts | spades)) | (hearts & spades)) & ~threes;
+    return evaluateCombos(ranks, fours, threes, pairs);
+}
+
+quint16 HandEvaluator::evaluateRanks(quint16 ranks, quint16 pairs, quint16 threes, quint16 fours)
+{
+    return evaluateCombos(ranks, fours, threes, pairs & ~threes);
+}
+
+/**
+ * @internal
+ * @brief Evaluate hands with the scalar evaluator
+ * @param cardMasks masks of the cards of the hands.
+ * @param strengths strengths of the hands.
+ * @param count number of hands.
+ */
+static void evaluateBatchScalar(const quint64 *cardMasks, quint16 *strengths, int count)
+{
+    for (int i = 0; i < count; i++) {
+        strengths[i] = HandEvaluator::evaluate(CardSet(cardMasks[i]));
+    }
+}
+
+#if defined(Q_CC_GNU) && defined(Q_PROCESSOR_X86)
+#define HANDEVALUATOR_X86_KERNELS
+
+/*
+ * The x86 kernels do the same computations than evaluate(), but
+ * on the hands of a block in parallel: the masks are transposed, so
+ * that each register contains the ranks of one suit for all the
+ * hands of the block, in 16-bit lanes. The ranks that are present
+ * in one, two, three or four suits, and the ranks of a flush, are
+ * then computed with bitwise operations, and the strengths are
+ * obtained with the same scalar functions than evaluate(), so that
+ * the kernels give exactly the same results.
+ *
+ * These kernels are compiled for their instruction sets with the
+ * target attribute, and are only called if the processor supports
+ * them.
+ */
+
+#include <immintrin.h>
+
+/**
+ * @internal
+ * @brief Compute the strengths of a block of hands
+ * @param ranks ranks present in at least one suit.
+ * @param fours ranks present in the four suits.
+ * @param threes ranks present in exactly three suits.
+ * @param pairs ranks present in exactly two suits.
+ * @param flushes ranks of the suit having at least 5 cards, or 0.
+ * @param strengths strengths of the hands.
+ * @param count number of hands in the block.
+ */
+static inline void evaluateBlock(const quint16 *ranks, const quint16 *fours, const quint16 *threes,
+                                 const quint16 *pairs, const quint16 *flushes,
+                                 quint16 *strengths, int count)
+{
+    for (int i = 0; i < count; i++) {
+        if (Q_UNLIKELY(flushes[i] != 0)) {
+            strengths[i] = evaluateFlush(flushes[i]);
+        } else {
+            strengths[i] = evaluateCombos(ranks[i], fours[i], threes[i], pairs[i]);
+        }
+    }
+}
+
+/**
+ * @internal
+ * @brief Keep the ranks of the suits that have at least 5 cards (SSE4.2)
+ *
+ * The cards are counted with a table of the counts of each 4-bit value.
+ *
+ * @param suit ranks of a suit, for 8 hands.
+ * @return the ranks if there are at least 5 of them, 0 otherwise.
+ */
+__attribute__((target("sse4.2")))
+static inline __m128i flushRanksSse42(__m128i suit)
+{
+    const __m128i nibbleCounts = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i lowNibbles = _mm_set1_epi8(0x0f);
+    __m128i counts = _mm_add_epi8(_mm_shuffle_epi8(nibbleCounts, _mm_and_si128(suit, lowNibbles)),
+                                  _mm_shuffle_epi8(nibbleCounts,
+                                                   _mm_and_si128(_mm_srli_epi16(suit, 4), lowNibbles)));
+    counts = _mm_add_epi16(_mm_and_si128(counts, _mm_set1_epi16(0xff)), _mm_srli_epi16(counts, 8));
+    return _mm_and_si128(suit, _mm_cmpgt_epi16(counts, _mm_set1_epi16(4)));
+}
+
+/**
+ * @internal
+ * @brief Evaluate hands by blocks of 8 (SSE4.2)
+ * @param cardMasks masks of the cards of the hands.
+ * @param strengths strengths of the hands.
+ * @param count number of hands.
+ */
+__attribute__((target("sse4.2")))
+static void evaluateBatchSse42(const quint64 *cardMasks, quint16 *strengths, int count)
+{
+    // Put the suits of the 2 hands of a register next to each other
+    const __m128i suitShuffle = _mm_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15);
+    const __m128i suitMask = _mm_set1_epi16(CardSet::SuitMask);
+    quint16 ranks[8];
+    quint16 fours[8];
+    quint16 threes[8];
+    quint16 pairs[8];
+    quint16 flushes[8];
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i *masks = reinterpret_cast<const __m128i *>(cardMasks + i);
+        const __m128i hands01 = _mm_shuffle_epi8(_mm_loadu_si128(masks), suitShuffle);
+        const __m128i hands23 = _mm_shuffle_epi8(_mm_loadu_si128(masks + 1), suitShuffle);
+        const __m128i hands45 = _mm_shuffle_epi8(_mm_loadu_si128(masks + 2), suitShuffle);
+        const __m128i hands67 = _mm_shuffle_epi8(_mm_loadu_si128(masks + 3), suitShuffle);
+        const __m128i low03 = _mm_unpacklo_epi32(hands01, hands23);
+        const __m128i high03 = _mm_unpackhi_epi32(hands01, hands23);
+        const __m128i low47 = _mm_unpacklo_epi32(hands45, hands67);
+        const __m128i high47 = _mm_unpackhi_epi32(hands45, hands67);
+        const __m128i clubs = _mm_and_si128(_mm_unpacklo_epi64(low03, low47), suitMask);
+        const __m128i diamonds = _mm_and_si128(_mm_unpackhi_epi64(low03, low47), suitMask);
+        const __m128i hearts = _mm_and_si128(_mm_unpacklo_epi64(high03, high47), suitMask);
+        const __m128i spades = _mm_and_si128(_mm_unpackhi_epi64(high03, high47), suitMask);
+
+        const __m128i clubsDiamonds = _mm_and_si128(clubs, diamonds);
+        const __m128i heartsSpades = _mm_and_si128(hearts, spades);
+        const __m128i anyClubsDiamonds = _mm_or_si128(clubs, diamonds);
+        const __m128i anyHeartsSpades = _mm_or_si128(hearts, spades);
+        const __m128i threesVector = _mm_or_si128(_mm_and_si128(clubsDiamonds, anyHeartsSpades),
+                                                  _mm_and_si128(heartsSpades, anyClubsDiamonds));
+        const __m128i pairsVector = _mm_or_si128(_mm_or_si128(clubsDiamonds, heartsSpades),
+                                                 _mm_and_si128(anyClubsDiamonds, anyHeartsSpades));
+        const __m128i flushesVector = _mm_or_si128(_mm_or_si128(flushRanksSse42(clubs),
+                                                                flushRanksSse42(diamonds)),
+                                                   _mm_or_si128(flushRanksSse42(hearts),
+                                                                flushRanksSse42(spades)));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(ranks),
+                         _mm_or_si128(anyClubsDiamonds, anyHeartsSpades));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(fours),
+                         _mm_and_si128(clubsDiamonds, heartsSpades));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(threes), threesVector);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(pairs), _mm_andnot_si128(threesVector, pairsVector));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(flushes), flushesVector);
+        evaluateBlock(ranks, fours, threes, pairs, flushes, strengths + i, 8);
+    }
+
+    evaluateBatchScalar(cardMasks + i, strengths + i, count - i);
+}
+
+/**
+ * @internal
+ * @brief Keep the ranks of the suits that have at least 5 cards (AVX2)
+ * @param suit ranks of a suit, for 16 hands.
+ * @return the ranks if there are at least 5 of them, 0 otherwise.
+ */
+__attribute__((target("avx2")))
+static inline __m256i flushRanksAvx2(__m256i suit)
+{
+    const __m256i nibbleCounts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                  0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibbles = _mm256_set1_epi8(0x0f);
+    __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(nibbleCounts, _mm256_and_si256(suit, lowNibbles)),
+                                     _mm256_shuffle_epi8(nibbleCounts,
+                                                         _mm256_and_si256(_mm256_srli_epi16(suit, 4),
+                                                                          lowNibbles)));
+    counts = _mm256_add_epi16(_mm256_and_si256(counts, _mm256_set1_epi16(0xff)),
+                              _mm256_srli_epi16(counts, 8));
+    return _mm256_and_si256(suit, _mm256_cmpgt_epi16(counts, _mm256_set1_epi16(4)));
+}
+
+/**
+ * @internal
+ * @brief Evaluate hands by blocks of 16 (AVX2)
+ * @param cardMasks masks of the cards of the hands.
+ * @param strengths strengths of the hands.
+ * @param count number of hands.
+ */
+__attribute__((target("avx2")))
+static void evaluateBatchAvx2(const quint64 *cardMasks, quint16 *strengths, int count)
+{
+    // Shuffles and unpacks work on each 128-bit lane, so after the
+    // transposition the pairs of hands are in the order 0 2 4 6 1 3 5 7,
+    // and a permutation of the 32-bit blocks is needed
+    const __m256i suitShuffle = _mm256_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15,
+                                                 0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15);
+    const __m256i handOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    const __m256i suitMask = _mm256_set1_epi16(CardSet::SuitMask);
+    quint16 ranks[16];
+    quint16 fours[16];
+    quint16 threes[16];
+    quint16 pairs[16];
+    quint16 flushes[16];
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m256i *masks = reinterpret_cast<const __m256i *>(cardMasks + i);
+        const __m256i hands03 = _mm256_shuffle_epi8(_mm256_loadu_si256(masks), suitShuffle);
+        const __m256i hands47 = _mm256_shuffle_epi8(_mm256_loadu_si256(masks + 1), suitShuffle);
+        const __m256i hands811 = _mm256_shuffle_epi8(_mm256_loadu_si256(masks + 2), suitShuffle);
+        const __m256i hands1215 = _mm256_shuffle_epi8(_mm256_loadu_si256(masks + 3), suitShuffle);
+        const __m256i low07 = _mm256_unpacklo_epi32(hands03, hands47);
+        const __m256i high07 = _mm256_unpackhi_epi32(hands03, hands47);
+        const __m256i low815 = _mm256_unpacklo_epi32(hands811, hands1215);
+        const __m256i high815 = _mm256_unpackhi_epi32(hands811, hands1215);
+        const __m256i clubs = _mm256_and_si256(_mm256_permutevar8x32_epi32(
+                                                   _mm256_unpacklo_epi64(low07, low815), handOrder),
+                                               suitMask);
+        const __m256i diamonds = _mm256_and_si256(_mm256_permutevar8x32_epi32(
+                                                      _mm256_unpackhi_epi64(low07, low815), handOrder),
+                                                  suitMask);
+        const __m256i hearts = _mm256_and_si256(_mm256_permutevar8x32_epi32(
+                                                    _mm256_unpacklo_epi64(high07, high815), handOrder),
+                                                suitMask);
+        const __m256i spades = _mm256_and_si256(_mm256_permutevar8x32_epi32(
+                                                    _mm256_unpackhi_epi64(high07, high815), handOrder),
+                                                suitMask);
+
+        const __m256i clubsDiamonds = _mm256_and_si256(clubs, diamonds);
+        const __m256i heartsSpades = _mm256_and_si256(hearts, spades);
+        const __m256i anyClubsDiamonds = _mm256_or_si256(clubs, diamonds);
+        const __m256i anyHeartsSpades = _mm256_or_si256(hearts, spades);
+        const __m256i threesVector = _mm256_or_si256(_mm256_and_si256(clubsDiamonds, anyHeartsSpades),
+                                                     _mm256_and_si256(heartsSpades, anyClubsDiamonds));
+        const __m256i pairsVector = _mm256_or_si256(_mm256_or_si256(clubsDiamonds, heartsSpades),
+                                                    _mm256_and_si256(anyClubsDiamonds, anyHeartsSpades));
+        const __m256i flushesVector = _mm256_or_si256(_mm256_or_si256(flushRanksAvx2(clubs),
+                                                                      flushRanksAvx2(diamonds)),
+                                                      _mm256_or_si256(flushRanksAvx2(hearts),
+                                                                      flushRanksAvx2(spades)));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(ranks),
+                            _mm256_or_si256(anyClubsDiamonds, anyHeartsSpades));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(fours),
+                            _mm256_and_si256(clubsDiamonds, heartsSpades));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(threes), threesVector);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(pairs),
+                            _mm256_andnot_si256(threesVector, pairsVector));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(flushes), flushesVector);
+        evaluateBlock(ranks, fours, threes, pairs, flushes, strengths + i, 16);
+    }
+
+    evaluateBatchScalar(cardMasks + i, strengths + i, count - i);
+}
+#endif
+
+/**
+ * @internal
+ * @brief Detect the best kernel supported by the processor
+ * @return the best supported kernel.
+ */
+static HandEvaluator::BatchKernel detectBatchKernel()
+{
+#ifdef HANDEVALUATOR_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return HandEvaluator::Avx2Kernel;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return HandEvaluator::Sse42Kernel;
+    }
+#endif
+    return HandEvaluator::ScalarKernel;
+}
+
+/**
+ * @internal
+ * @brief Kernel used by default
+ */
+static const HandEvaluator::BatchKernel BATCH_KERNEL = detectBatchKernel();
+
+HandEvaluator::BatchKernel HandEvaluator::batchKernel()
+{
+    return BATCH_KERNEL;
+}
+
+bool HandEvaluator::isBatchKernelSupported(BatchKernel kernel)
+{
+    return kernel == AutomaticKernel || kernel <= BATCH_KERNEL;
+}
+
+void HandEvaluator::evaluateBatch(const quint64 *cardMasks, quint16 *strengths, int count,
+                                  BatchKernel kernel)
+{
+    if (kernel == AutomaticKernel || !isBatchKernelSupported(kernel)) {
+        kernel = BATCH_KERNEL;
+    }
+
+    switch (kernel) {
+#ifdef HANDEVALUATOR_X86_KERNELS
+    case Avx2Kernel:
+        evaluateBatchAvx2(cardMasks, strengths, count);
+        break;
+    case Sse42Kernel:
+        evaluateBatchSse42(cardMasks, strengths, count);
+        break;
+#endif
+    default:
+        evaluateBatchScalar(cardMasks, strengths, count);
+        break;
+    }
+}
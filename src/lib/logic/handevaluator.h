@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef HANDEVALUATOR_H
+#define HANDEVALUATOR_H
+
+/**
+ * @file handevaluator.h
+ * @short Definition of HandEvaluator
+ */
+
+#include "pokqt_global.h"
+#include "cardset.h"
+
+/**
+ * @brief Hand evaluator
+ *
+ * This class computes the strength of a poker hand, made
+ * of 5, 6 or 7 cards, stored in a CardSet. The strength is a
+ * 16-bit value that can be directly compared: the stronger
+ * hand has the highest value, and two hands that have the same
+ * value are equal following poker rules.
+ *
+ * The 4 highest bits of the strength contains the category
+ * (see Category), and the 12 lowest bits are used to compare
+ * hands of the same category (rank of the combo, then the kickers).
+ *
+ * The evaluation is done with the rank masks of each suit
+ * provided by the CardSet and precomputed tables indexed by
+ * 13-bit rank masks, so it don't allocate or sort anything.
+ *
+ * Hands with less than 5 cards are also evaluated: only the
+ * available cards are used as kickers, and a missing kicker
+ * is weaker than any kicker. Hands with more than 7 cards are
+ * not supported.
+ *
+ * Many hands can be evaluated at once with evaluateBatch(), that
+ * uses SIMD kernels when the processor supports them. These kernels
+ * provide exactly the same strengths than evaluate().
+ */
+class POKQTSHARED_EXPORT HandEvaluator
+{
+public:
+    /**
+     * @brief Category of a hand
+     */
+    enum Category {
+        /**
+         * @brief No combo, only high cards
+         */
+        HighCard = 0,
+        /**
+         * @brief A pair
+         */
+        Pair = 1,
+        /**
+         * @brief Two pairs
+         */
+        TwoPairs = 2,
+        /**
+         * @brief A three of a kind
+         */
+        Three = 3,
+        /**
+         * @brief A straight
+         */
+        Straight = 4,
+        /**
+         * @brief A flush
+         */
+        Flush = 5,
+        /**
+         * @brief A full house
+         */
+        FullHouse = 6,
+        /**
+         * @brief A four of a kind
+         */
+        Four = 7,
+        /**
+         * @brief A straight flush
+         */
+        StraightFlush = 8
+    };
+    /**
+     * @brief Kernel used to evaluate hands in batch
+     */
+    enum BatchKernel {
+        /**
+         * @brief The best kernel supported by the processor
+         */
+        AutomaticKernel,
+        /**
+         * @brief Portable kernel, that evaluates the hands one by one
+         */
+        ScalarKernel,
+        /**
+         * @brief Kernel using SSE4.2, that evaluates 8 hands at once
+         */
+        Sse42Kernel,
+        /**
+         * @brief Kernel using AVX2, that evaluates 16 hands at once
+         */
+        Avx2Kernel
+    };
+    /**
+     * @brief Evaluate a hand
+     * @param cards cards of the hand.
+     * @return strength of the hand.
+     */
+    static quint16 evaluate(CardSet cards);
+    /**
+     * @brief Evaluate a hand from its ranks, ignoring flushes
+     *
+     * The hand is described by the masks of the ranks that are
+     * present at least once, twice, three times and four times.
+     * This is used by evaluators that build hands from parts, like
+     * OmahaEvaluator, and that check flushes separately.
+     *
+     * @param ranks ranks present at least once.
+     * @param pairs ranks present at least twice.
+     * @param threes ranks present at least three times.
+     * @param fours ranks present four times.
+     * @return strength of the hand, if it is not a flush.
+     */
+    static quint16 evaluateRanks(quint16 ranks, quint16 pairs, quint16 threes, quint16 fours);
+    /**
+     * @brief Evaluate several hands
+     *
+     * The masks are masks of CardSet, and the strengths are
+     * the same than the ones returned by evaluate().
+     *
+     * If the requested kernel is not supported by the
+     * processor, the best supported kernel is used.
+     *
+     * @param cardMasks masks of the cards of each hand.
+     * @param strengths array where the strengths are written.
+     * @param count number of hands.
+     * @param kernel kernel to use.
+     */
+    static void evaluateBatch(const quint64 *cardMasks, quint16 *strengths, int count,
+                              BatchKernel kernel = AutomaticKernel);
+    /**
+     * @brief Get the kernel used by default by evaluateBatch()
+     * @return the best kernel supported by the processor.
+     */
+    static BatchKernel batchKernel();
+    /**
+     * @brief Check if a kernel is supported by the processor
+     * @param kernel kernel to check.
+     * @return if the kernel is supported.
+     */
+    static bool isBatchKernelSupported(BatchKernel kernel);
+    /**
+     * @brief Get the category of a strength
+     * @param strength strength returned by evaluate().
+     * @return category of the hand.
+     */
+    static inline Category category(quint16 strength)
+    {
+        return Category(strength >> 12);
+    }
+};
+
+#endif // HANDEVALUATOR_H
@@ -0,0 +1,396 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file handindexer.cpp
+ * @short Implementation of HandIndexer
+ */
+
+#include "handindexer.h"
+#include <QtCore/QMap>
+#include <algorithm>
+#include "bitops.h"
+
+const quint64 HandIndexer::InvalidIndex;
+
+/**
+ * @internal
+ * @brief STREET_CARD_COUNTS
+ *
+ * Constant representing the number of cards dealt at each street.
+ */
+static const int STREET_CARD_COUNTS[4] = {2, 3, 1, 1};
+/**
+ * @internal
+ * @brief RANK_COUNT
+ *
+ * Constant representing the number of ranks in a suit.
+ */
+static const int RANK_COUNT = 13;
+
+/**
+ * @internal
+ * @brief Tables used to index the ranks of a suit
+ */
+struct HandIndexerTables
+{
+    /**
+     * @internal
+     * @brief Constructor, that fills the tables
+     */
+    HandIndexerTables()
+    {
+        for (int n = 0; n <= RANK_COUNT; n++) {
+            for (int k = 0; k <= RANK_COUNT; k++) {
+                binomials[n][k] = binomial(n, k);
+            }
+        }
+
+        // The colexicographical index of a set of ranks {r0 < r1 < ...}
+        // among the sets of the same size is C(r0, 1) + C(r1, 2) + ...
+        for (int mask = 0; mask < (1 << RANK_COUNT); mask++) {
+            int index = 0;
+            int k = 1;
+            for (int rank = 0; rank < RANK_COUNT; rank++) {
+                if (mask & (1 << rank)) {
+                    index += binomials[rank][k];
+                    k++;
+                }
+            }
+            colexIndexes[mask] = index;
+        }
+    }
+    /**
+     * @internal
+     * @brief Binomial coefficients for the ranks
+     */
+    int binomials[RANK_COUNT + 1][RANK_COUNT + 1];
+    /**
+     * @internal
+     * @brief Colexicographical index of each set of ranks
+     */
+    quint16 colexIndexes[1 << RANK_COUNT];
+};
+
+/**
+ * @internal
+ * @brief Tables
+ */
+static const HandIndexerTables TABLES;
+
+/**
+ * @internal
+ * @brief Key of the configuration of a suit
+ *
+ * The number of cards dealt at the first streets are
+ * the most significant.
+ *
+ * @param counts number of cards dealt at each street for the suit.
+ * @return key of the configuration of the suit, between 0 and 255.
+ */
+static quint32 suitKey(const int *counts)
+{
+    return (counts[0] << 6) | (counts[1] << 4) | (counts[2] << 2) | counts[3];
+}
+
+/**
+ * @internal
+ * @brief Enumerate the configurations of the four suits
+ *
+ * The number of cards dealt at a street is split in all possible
+ * ways between the suits. Configurations that only differ by
+ * the order of the suits are stored once, sorted by decreasing
+ * suit keys.
+ *
+ * @param street street to split.
+ * @param lastStreet last street to split.
+ * @param counts number of cards dealt at each street for each suit.
+ * @param configurations found configurations, mapped by the key of the four suits.
+ */
+static void enumerateConfigurations(int street, int lastStreet, int counts[4][4],
+                                    QMap<quint32, QList<int> > &configurations)
+{
+    if (street > lastStreet) {
+        QList<quint32> keys;
+        for (int suit = 0; suit < 4; suit++) {
+            keys.append(suitKey(counts[suit]));
+        }
+        std::sort(keys.begin(), keys.end(), std::greater<quint32>());
+        configurations.insert((keys.at(0) << 24) | (keys.at(1) << 16) | (keys.at(2) << 8) | keys.at(3),
+                              QList<int>());
+        return;
+    }
+
+    const int cardCount = STREET_CARD_COUNTS[street];
+    for (int club = 0; club <= cardCount; club++) {
+        for (int diamond = 0; diamond <= cardCount - club; diamond++) {
+            for (int heart = 0; heart <= cardCount - club - diamond; heart++) {
+                counts[0][street] = club;
+                counts[1][street] = diamond;
+                counts[2][street] = heart;
+                counts[3][street] = cardCount - club - diamond - heart;
+                enumerateConfigurations(street + 1, lastStreet, counts, configurations);
+            }
+        }
+    }
+    for (int suit = 0; suit < 4; suit++) {
+        counts[suit][street] = 0;
+    }
+}
+
+/**
+ * @internal
+ * @brief Get the size of the group of suits with the same configuration
+ * @param counts number of cards dealt at each street for each suit, sorted.
+ * @param first first suit of the group.
+ * @return index after the last suit of the group.
+ */
+static int groupEnd(const int counts[4][4], int first)
+{
+    int last = first + 1;
+    while (last < 4 && suitKey(counts[last]) == suitKey(counts[first])) {
+        last++;
+    }
+    return last;
+}
+
+HandIndexer::HandIndexer(Street street)
+    : m_street(street), m_indexCount(0)
+{
+    int counts[4][4];
+    memset(counts, 0, sizeof(counts));
+    QMap<quint32, QList<int> > configurations;
+    enumerateConfigurations(0, street, counts, configurations);
+
+    for (QMap<quint32, QList<int> >::const_iterator it = configurations.constBegin();
+         it != configurations.constEnd(); ++it) {
+        Configuration configuration;
+        for (int suit = 0; suit < 4; suit++) {
+            quint32 key = it.key() >> (8 * (3 - suit));
+            int usedCount = 0;
+            configuration.suitSizes[suit] = 1;
+            for (int i = 0; i < 4; i++) {
+                configuration.counts[suit][i] = (key >> (2 * (3 - i))) & 0x3;
+                configuration.suitSizes[suit] *= TABLES.binomials[RANK_COUNT - usedCount]
+                                                                 [configuration.counts[suit][i]];
+                usedCount += configuration.counts[suit][i];
+            }
+        }
+
+        // Suits with the same configuration are a multiset of suit indexes
+        quint64 size = 1;
+        for (int first = 0; first < 4; first = groupEnd(configuration.counts, first)) {
+            int count = groupEnd(configuration.counts, first) - first;
+            size *= binomial(configuration.suitSizes[first] + count - 1, count);
+        }
+
+        configuration.offset = m_indexCount;
+        m_indexCount += size;
+        m_configurationIndexes.insert(it.key(), m_configurations.count());
+        m_configurations.append(configuration);
+    }
+}
+
+HandIndexer::Street HandIndexer::street() const
+{
+    return m_street;
+}
+
+quint64 HandIndexer::indexCount() const
+{
+    return m_indexCount;
+}
+
+int HandIndexer::cardCount(Street street)
+{
+    return STREET_CARD_COUNTS[street];
+}
+
+quint64 HandIndexer::index(const QList<CardSet> &streets) const
+{
+    if (streets.count() != m_street + 1) {
+        return InvalidIndex;
+    }
+
+    CardSet used;
+    for (int i = 0; i < streets.count(); i++) {
+        if (streets.at(i).count() != STREET_CARD_COUNTS[i] || !(used & streets.at(i)).isEmpty()) {
+            return InvalidIndex;
+        }
+        used |= streets.at(i);
+    }
+
+    // Index the ranks of each suit: at each street, the ranks are
+    // numbered among the ranks that are not used yet
+    quint32 keys[4];
+    quint64 suitIndexes[4];
+    for (int suit = 0; suit < 4; suit++) {
+        int counts[4] = {0, 0, 0, 0};
+        quint32 usedRanks = 0;
+        int usedCount = 0;
+        quint64 suitIndex = 0;
+        quint64 multiplier = 1;
+        for (int i = 0; i < streets.count(); i++) {
+            quint32 ranks = streets.at(i).suitMask(suit);
+            quint32 compressed = 0;
+            for (quint32 remaining = ranks; remaining != 0; remaining &= remaining - 1) {
+                int rank = lowestBit(remaining);
+                compressed |= 1 << (rank - bitCount(usedRanks & ((1 << rank) - 1)));
+            }
+            counts[i] = bitCount(ranks);
+            suitIndex += multiplier * TABLES.colexIndexes[compressed];
+            multiplier *= TABLES.binomials[RANK_COUNT - usedCount][counts[i]];
+            usedRanks |= ranks;
+            usedCount += counts[i];
+        }
+        keys[suit] = suitKey(counts);
+        suitIndexes[suit] = suitIndex;
+    }
+
+    // Sort the suits by decreasing keys, and increasing indexes
+    for (int i = 1; i < 4; i++) {
+        for (int j = i; j > 0; j--) {
+            if (keys[j] > keys[j - 1] || (keys[j] == keys[j - 1] && suitIndexes[j] < suitIndexes[j - 1])) {
+                qSwap(keys[j], keys[j - 1]);
+                qSwap(suitIndexes[j], suitIndexes[j - 1]);
+            }
+        }
+    }
+
+    const Configuration &configuration
+            = m_configurations.at(m_configurationIndexes.value((keys[0] << 24) | (keys[1] << 16)
+                                                               | (keys[2] << 8) | keys[3]));
+    quint64 index = configuration.offset;
+    quint64 multiplier = 1;
+    for (int first = 0; first < 4; first = groupEnd(configuration.counts, first)) {
+        // The sorted indexes a0 <= a1 <= ... of a group are ranked
+        // as the combination {a0 < a1 + 1 < a2 + 2 ...}
+        int count = groupEnd(configuration.counts, first) - first;
+        quint64 groupIndex = 0;
+        for (int i = 0; i < count; i++) {
+            groupIndex += binomial(suitIndexes[first + i] + i, i + 1);
+        }
+        index += multiplier * groupIndex;
+        multiplier *= binomial(configuration.suitSizes[first] + count - 1, count);
+    }
+    return index;
+}
+
+quint64 HandIndexer::index(const QList<Card> &holeCards, const QList<Card> &board) const
+{
+    QList<CardSet> streets;
+    streets.append(CardSet(holeCards));
+    int first = 0;
+    for (int i = Flop; i <= m_street; i++) {
+        streets.append(CardSet(board.mid(first, STREET_CARD_COUNTS[i])));
+        first += STREET_CARD_COUNTS[i];
+    }
+
+    if (board.count() != first) {
+        return InvalidIndex;
+    }
+    return index(streets);
+}
+
+QList<CardSet> HandIndexer::cards(quint64 index) const
+{
+    QList<CardSet> streets;
+    if (index >= m_indexCount) {
+        return streets;
+    }
+
+    int configurationIndex = m_configurations.count() - 1;
+    while (m_configurations.at(configurationIndex).offset > index) {
+        configurationIndex--;
+    }
+    const Configuration &configuration = m_configurations.at(configurationIndex);
+
+    // Find the index of each suit
+    quint64 suitIndexes[4];
+    index -= configuration.offset;
+    for (int first = 0; first < 4; first = groupEnd(configuration.counts, first)) {
+        int count = groupEnd(configuration.counts, first) - first;
+        quint64 size = binomial(configuration.suitSizes[first] + count - 1, count);
+        quint64 groupIndex = index % size;
+        index /= size;
+        for (int i = count - 1; i >= 0; i--) {
+            quint64 value = groupIndex;
+            if (i > 0) {
+                value = i;
+                while (binomial(value + 1, i + 1) <= groupIndex) {
+                    value++;
+                }
+            }
+            groupIndex -= binomial(value, i + 1);
+            suitIndexes[first + i] = value - i;
+        }
+    }
+
+    quint64 masks[4] = {0, 0, 0, 0};
+    for (int suit = 0; suit < 4; suit++) {
+        quint64 suitIndex = suitIndexes[suit];
+        quint32 usedRanks = 0;
+        int usedCount = 0;
+        for (int i = 0; i <= m_street; i++) {
+            const int count = configuration.counts[suit][i];
+            const int size = TABLES.binomials[RANK_COUNT - usedCount][count];
+            int colexIndex = suitIndex % size;
+            suitIndex /= size;
+
+            // Find the positions among the free ranks, then the ranks
+            quint32 ranks = 0;
+            for (int k = count; k > 0; k--) {
+                int position = k - 1;
+                while (TABLES.binomials[position + 1][k] <= colexIndex) {
+                    position++;
+                }
+                colexIndex -= TABLES.binomials[position][k];
+
+                int rank = -1;
+                for (int free = -1; free < position; ) {
+                    rank++;
+                    if (!(usedRanks & (1 << rank))) {
+                        free++;
+                    }
+                }
+                ranks |= 1 << rank;
+            }
+            masks[i] |= quint64(ranks) << (16 * suit);
+            usedRanks |= ranks;
+            usedCount += count;
+        }
+    }
+
+    for (int i = 0; i <= m_street; i++) {
+        streets.append(CardSet(masks[i]));
+    }
+    return streets;
+}
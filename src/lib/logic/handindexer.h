@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef HANDINDEXER_H
+#define HANDINDEXER_H
+
+/**
+ * @file handindexer.h
+ * @short Definition of HandIndexer
+ */
+
+#include "pokqt_global.h"
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QVector>
+#include "card.h"
+#include "cardset.h"
+
+/**
+ * @brief Suit isomorphic hand indexer
+ *
+ * This class maps the cards that a player knows at a given street
+ * (the hole cards, and the cards of the board dealt at each street)
+ * to a dense index, that is the same for all the hands that only
+ * differ by a permutation of the suits. For example, AhKh on a
+ * 2h 7h Tc flop has the same index as AsKs on a 2s 7s Td flop. The
+ * number of indexes is 169 preflop, 1286792 on the flop, 55190538
+ * on the turn and 2428287420 on the river.
+ *
+ * The cards of each street are kept separate: the same cards are
+ * not equivalent if they are dealt at different streets. The cards
+ * of a street are a set, their order doesn't matter.
+ *
+ * An index is computed from the ranks of each suit at each street:
+ * the suits are first grouped by their configuration, that is the
+ * number of cards of the suit dealt at each street, and the
+ * configurations of the four suits are sorted. The ranks of each
+ * suit are then converted to a number, and the numbers of the
+ * suits with the same configuration are combined as a multiset,
+ * so that the order of the suits doesn't matter. The cost of
+ * index() only depends on the number of cards, and cards() gives
+ * a canonical hand back from an index.
+ *
+ * This indexer is the algorithm described by Kevin Waugh in
+ * "A Fast and Optimal Hand Isomorphism Algorithm".
+ */
+class POKQTSHARED_EXPORT HandIndexer
+{
+public:
+    /**
+     * @brief Street
+     */
+    enum Street {
+        /**
+         * @short Only the hole cards
+         */
+        Preflop,
+        /**
+         * @short Hole cards and flop
+         */
+        Flop,
+        /**
+         * @short Hole cards, flop and turn
+         */
+        Turn,
+        /**
+         * @short Hole cards, flop, turn and river
+         */
+        River
+    };
+    /**
+     * @brief Value returned for invalid hands
+     */
+    static const quint64 InvalidIndex = Q_UINT64_C(0xffffffffffffffff);
+    /**
+     * @brief Default constructor
+     * @param street street of the hands to index.
+     */
+    explicit HandIndexer(Street street = Preflop);
+    /**
+     * @brief Street of the hands to index
+     * @return street of the hands to index.
+     */
+    Street street() const;
+    /**
+     * @brief Number of indexes
+     * @return number of indexes.
+     */
+    quint64 indexCount() const;
+    /**
+     * @brief Number of cards dealt at a street
+     * @param street street.
+     * @return number of cards dealt at the street.
+     */
+    static int cardCount(Street street);
+    /**
+     * @brief Get the index of a hand
+     *
+     * The hand is given as the cards dealt at each street, starting
+     * with the hole cards, up to the street of the indexer.
+     *
+     * @param streets cards dealt at each street.
+     * @return index of the hand, or InvalidIndex if the hand is invalid.
+     */
+    quint64 index(const QList<CardSet> &streets) const;
+    /**
+     * @brief Get the index of a hand
+     *
+     * The cards of the board are given in the order they are dealt,
+     * as in the board of a game.
+     *
+     * @param holeCards hole cards.
+     * @param board cards of the board.
+     * @return index of the hand, or InvalidIndex if the hand is invalid.
+     */
+    quint64 index(const QList<Card> &holeCards, const QList<Card> &board) const;
+    /**
+     * @brief Get the canonical hand of an index
+     *
+     * The hand has the same index as all the hands that only differ
+     * by a permutation of the suits.
+     *
+     * @param index index of the hand.
+     * @return cards dealt at each street, or an empty list for an invalid index.
+     */
+    QList<CardSet> cards(quint64 index) const;
+private:
+    /**
+     * @internal
+     * @brief Configuration of the four suits
+     */
+    struct Configuration
+    {
+        /**
+         * @internal
+         * @brief Number of cards dealt at each street for each suit, in decreasing order
+         */
+        int counts[4][4];
+        /**
+         * @internal
+         * @brief Number of rank combinations of each suit
+         */
+        quint64 suitSizes[4];
+        /**
+         * @internal
+         * @brief Index of the first hand with this configuration
+         */
+        quint64 offset;
+    };
+    /**
+     * @internal
+     * @brief Street of the hands to index
+     */
+    Street m_street;
+    /**
+     * @internal
+     * @brief Number of indexes
+     */
+    quint64 m_indexCount;
+    /**
+     * @internal
+     * @brief Configurations, sorted by offset
+     */
+    QVector<Configuration> m_configurations;
+    /**
+     * @internal
+     * @brief Configuration of each key of the four suits
+     */
+    QHash<quint32, int> m_configurationIndexes;
+};
+
+#endif // HANDINDEXER_H
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef HANDKERNELS_H
+#define HANDKERNELS_H
+
+/**
+ * @file handkernels.h
+ * @short Straight and flush detection kernels
+ *
+ * These kernels detect straights and flushes directly from
+ * masks, without sorting cards. Straights are detected in a
+ * 13-bit rank mask, as returned by CardSet::rankMask() or
+ * CardSet::suitMask(), and flushes are detected in the 64-bit
+ * mask of a CardSet, by counting the cards of the four suits
+ * in parallel.
+ */
+
+#include <QtCore/qglobal.h>
+#include "bitops.h"
+
+/**
+ * @brief Get the high cards of all the straights in a rank mask
+ *
+ * The ace is also used as a 1, so the 5432A straight has
+ * the 5 as high card. The rank mask is extended with the
+ * ace in the lowest bit, and five shifted copies are combined
+ * with AND, so that a bit stays set only if it starts a run of
+ * five ranks.
+ *
+ * @param rankMask 13-bit rank mask.
+ * @return mask of the ranks that are the highest card of a straight.
+ */
+inline quint16 straightHighCards(quint16 rankMask)
+{
+    const quint32 extended = (quint32(rankMask) << 1) | (rankMask >> 12);
+    const quint32 runs = extended & (extended >> 1) & (extended >> 2)
+                         & (extended >> 3) & (extended >> 4);
+    return (runs << 3) & 0x1fff;
+}
+
+/**
+ * @brief Get the high card of the highest straight in a rank mask
+ * @param rankMask 13-bit rank mask.
+ * @return rank of the highest card of the straight, or -1 if there is no straight.
+ */
+inline int straightHighCard(quint16 rankMask)
+{
+    const quint16 highCards = straightHighCards(rankMask);
+    return highCards != 0 ? highestBit(highCards) : -1;
+}
+
+/**
+ * @brief Count the cards of each suit
+ *
+ * The number of cards of each suit is computed in parallel
+ * and stored in the 16-bit block of the suit.
+ *
+ * @param cardMask mask of a CardSet.
+ * @return number of cards of each suit, in the 16-bit block of the suit.
+ */
+inline quint64 suitCounts(quint64 cardMask)
+{
+    quint64 counts = cardMask - ((cardMask >> 1) & Q_UINT64_C(0x5555555555555555));
+    counts = (counts & Q_UINT64_C(0x3333333333333333))
+             + ((counts >> 2) & Q_UINT64_C(0x3333333333333333));
+    counts = (counts + (counts >> 4)) & Q_UINT64_C(0x0f0f0f0f0f0f0f0f);
+    return (counts + (counts >> 8)) & Q_UINT64_C(0x00ff00ff00ff00ff);
+}
+
+/**
+ * @brief Get the suits that contain a flush
+ * @param cardMask mask of a CardSet.
+ * @return mask of the indexes of the suits that have at least 5 cards.
+ */
+inline int flushSuits(quint64 cardMask)
+{
+    // Adding 123 to a count sets the bit 7 if the count is at least 5
+    const quint64 flags = ((suitCounts(cardMask) + Q_UINT64_C(0x007b007b007b007b))
+                           & Q_UINT64_C(0x0080008000800080)) >> 7;
+    return (flags | (flags >> 15) | (flags >> 30) | (flags >> 45)) & 0xf;
+}
+
+/**
+ * @brief Check if there is a flush
+ * @param cardMask mask of a CardSet.
+ * @return if at least 5 cards have the same suit.
+ */
+inline bool hasFlush(quint64 cardMask)
+{
+    return ((suitCounts(cardMask) + Q_UINT64_C(0x007b007b007b007b))
+            & Q_UINT64_C(0x0080008000800080)) != 0;
+}
+
+#endif // HANDKERNELS_H
@@ -0,0 +1,415 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file handrange.cpp
+ * @short Implementation of HandRange
+ */
+
+#include "handrange.h"
+#include <QtCore/QStringList>
+#include "bitops.h"
+
+/**
+ * @internal
+ * @brief RANKS
+ *
+ * Constant representing the characters used for the ranks.
+ */
+static const char *RANKS = "23456789TJQKA";
+/**
+ * @internal
+ * @brief SUITS
+ *
+ * Constant representing the characters used for the suits.
+ */
+static const char *SUITS = "cdhs";
+
+/**
+ * @internal
+ * @brief Table of the cards of each combo
+ */
+struct ComboTable
+{
+    /**
+     * @internal
+     * @brief Constructor, that fills the table
+     */
+    ComboTable()
+    {
+        int index = 0;
+        for (int second = 0; second < PackedCard::CardCount; second++) {
+            for (int first = 0; first < second; first++) {
+                masks[index] = (Q_UINT64_C(1) << cardNumberBit(first))
+                               | (Q_UINT64_C(1) << cardNumberBit(second));
+                index++;
+            }
+        }
+    }
+    /**
+     * @internal
+     * @brief Masks of the cards of each combo
+     */
+    quint64 masks[HandRange::ComboCount];
+};
+
+/**
+ * @internal
+ * @brief Cards of each combo
+ */
+static const ComboTable COMBOS;
+
+/**
+ * @internal
+ * @brief Kind of hands
+ */
+enum HandKind {
+    /**
+     * @internal
+     * @brief A pair
+     */
+    PairKind,
+    /**
+     * @internal
+     * @brief Two cards of the same suit
+     */
+    SuitedKind,
+    /**
+     * @internal
+     * @brief Two cards of different suits
+     */
+    OffsuitKind,
+    /**
+     * @internal
+     * @brief Two cards of any suit
+     */
+    AnyKind
+};
+
+/**
+ * @internal
+ * @brief Get the rank of a character
+ * @param character character to parse.
+ * @return rank, or -1 if the character is not a rank.
+ */
+static int parseRank(QChar character)
+{
+    for (int i = 0; RANKS[i]; i++) {
+        if (character == QLatin1Char(RANKS[i])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @internal
+ * @brief Get the suit of a character
+ * @param character character to parse.
+ * @return suit, or Card::Invalid if the character is not a suit.
+ */
+static Card::Suit parseSuit(QChar character)
+{
+    for (int i = 0; SUITS[i]; i++) {
+        if (character == QLatin1Char(SUITS[i])) {
+            return (Card::Suit) (i + 1);
+        }
+    }
+    return Card::Invalid;
+}
+
+/**
+ * @internal
+ * @brief Parse a hand like "AKs", "AKo", "AK" or "QQ"
+ * @param text text to parse.
+ * @param high highest rank of the hand.
+ * @param low lowest rank of the hand.
+ * @param kind kind of the hand.
+ * @return if the text is valid.
+ */
+static bool parseHand(const QString &text, int *high, int *low, HandKind *kind)
+{
+    if (text.length() != 2 && text.length() != 3) {
+        return false;
+    }
+
+    *high = parseRank(text.at(0));
+    *low = parseRank(text.at(1));
+    if (*high == -1 || *low == -1) {
+        return false;
+    }
+
+    if (*high == *low) {
+        *kind = PairKind;
+        return text.length() == 2;
+    }
+
+    if (*high < *low) {
+        qSwap(*high, *low);
+    }
+
+    if (text.length() == 2) {
+        *kind = AnyKind;
+    } else if (text.at(2) == QLatin1Char('s')) {
+        *kind = SuitedKind;
+    } else if (text.at(2) == QLatin1Char('o')) {
+        *kind = OffsuitKind;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @internal
+ * @brief Set the weight of all the combos of a hand
+ * @param weights weights of the combos.
+ * @param high highest rank of the hand.
+ * @param low lowest rank of the hand.
+ * @param kind kind of the hand.
+ * @param weight weight to set.
+ */
+static void addHand(QVector<double> &weights, int high, int low, HandKind kind, double weight)
+{
+    for (int firstSuit = Card::Club; firstSuit <= Card::Spade; firstSuit++) {
+        for (int secondSuit = Card::Club; secondSuit <= Card::Spade; secondSuit++) {
+            if ((kind == PairKind && firstSuit >= secondSuit)
+                || (kind == SuitedKind && firstSuit != secondSuit)
+                || (kind == OffsuitKind && firstSuit == secondSuit)) {
+                continue;
+            }
+
+            CardSet cards;
+            cards.insert(PackedCard((Card::Suit) firstSuit, high));
+            cards.insert(PackedCard((Card::Suit) secondSuit, low));
+            weights[HandRange::comboIndex(cards)] = weight;
+        }
+    }
+}
+
+/**
+ * @internal
+ * @brief Parse an item of a range
+ * @param text text of the item.
+ * @param weights weights of the combos, that are set by the item.
+ * @return if the item is valid.
+ */
+static bool parseItem(const QString &text, QVector<double> &weights)
+{
+    QString item = text;
+    double weight = 1.;
+    int weightIndex = item.indexOf(QLatin1Char(':'));
+    if (weightIndex != -1) {
+        bool ok = false;
+        weight = item.mid(weightIndex + 1).trimmed().toDouble(&ok);
+        if (!ok || weight < 0.) {
+            return false;
+        }
+        item = item.left(weightIndex).trimmed();
+    }
+
+    // A specific combo, like AhKh
+    if (item.length() == 4 && parseSuit(item.at(1)) != Card::Invalid
+        && parseSuit(item.at(3)) != Card::Invalid) {
+        PackedCard first (parseSuit(item.at(1)), parseRank(item.at(0)));
+        PackedCard second (parseSuit(item.at(3)), parseRank(item.at(2)));
+        if (!first.isValid() || !second.isValid() || first == second) {
+            return false;
+        }
+        weights[HandRange::comboIndex(CardSet(first) | CardSet(second))] = weight;
+        return true;
+    }
+
+    int high;
+    int low;
+    HandKind kind;
+
+    // A span of hands, like 99-QQ or A2s-A5s
+    int dashIndex = item.indexOf(QLatin1Char('-'));
+    if (dashIndex != -1) {
+        int otherHigh;
+        int otherLow;
+        HandKind otherKind;
+        if (!parseHand(item.left(dashIndex), &high, &low, &kind)
+            || !parseHand(item.mid(dashIndex + 1), &otherHigh, &otherLow, &otherKind)
+            || kind != otherKind) {
+            return false;
+        }
+
+        if (kind == PairKind) {
+            for (int rank = qMin(high, otherHigh); rank <= qMax(high, otherHigh); rank++) {
+                addHand(weights, rank, rank, kind, weight);
+            }
+            return true;
+        }
+
+        if (high != otherHigh) {
+            return false;
+        }
+        for (int rank = qMin(low, otherLow); rank <= qMax(low, otherLow); rank++) {
+            addHand(weights, high, rank, kind, weight);
+        }
+        return true;
+    }
+
+    // Hands with increasing ranks, like QQ+ or A2s+
+    if (item.endsWith(QLatin1Char('+'))) {
+        if (!parseHand(item.left(item.length() - 1), &high, &low, &kind)) {
+            return false;
+        }
+
+        if (kind == PairKind) {
+            for (int rank = high; rank <= 12; rank++) {
+                addHand(weights, rank, rank, kind, weight);
+            }
+        } else {
+            for (int rank = low; rank < high; rank++) {
+                addHand(weights, high, rank, kind, weight);
+            }
+        }
+        return true;
+    }
+
+    if (!parseHand(item, &high, &low, &kind)) {
+        return false;
+    }
+    addHand(weights, high, low, kind, weight);
+    return true;
+}
+
+HandRange::HandRange()
+    : m_weights(ComboCount, 0.)
+{
+}
+
+HandRange HandRange::fullRange()
+{
+    HandRange range;
+    range.m_weights.fill(1.);
+    return range;
+}
+
+HandRange HandRange::fromCards(CardSet cards)
+{
+    HandRange range;
+    int index = comboIndex(cards);
+    if (index != -1) {
+        range.m_weights[index] = 1.;
+    }
+    return range;
+}
+
+int HandRange::comboIndex(CardSet cards)
+{
+    if (cards.count() != 2) {
+        return -1;
+    }
+
+    int first = cardNumber(lowestBit(cards.mask()));
+    int second = cardNumber(highestBit(cards.mask()));
+    return second * (second - 1) / 2 + first;
+}
+
+CardSet HandRange::comboCards(int index)
+{
+    if (index < 0 || index >= ComboCount) {
+        return CardSet();
+    }
+    return CardSet(COMBOS.masks[index]);
+}
+
+bool HandRange::parse(const QString &text)
+{
+    QVector<double> weights = m_weights;
+    foreach (const QString &item, text.split(QLatin1Char(','))) {
+        QString trimmed = item.trimmed();
+        if (trimmed.isEmpty()) {
+            continue;
+        }
+        if (!parseItem(trimmed, weights)) {
+            return false;
+        }
+    }
+
+    m_weights = weights;
+    return true;
+}
+
+bool HandRange::isEmpty() const
+{
+    return comboCount() == 0;
+}
+
+int HandRange::comboCount() const
+{
+    int count = 0;
+    foreach (double weight, m_weights) {
+        if (weight > 0.) {
+            count++;
+        }
+    }
+    return count;
+}
+
+double HandRange::totalWeight() const
+{
+    double total = 0.;
+    foreach (double weight, m_weights) {
+        total += weight;
+    }
+    return total;
+}
+
+double HandRange::weight(int index) const
+{
+    return m_weights.at(index);
+}
+
+void HandRange::setWeight(int index, double weight)
+{
+    m_weights[index] = weight;
+}
+
+HandRange HandRange::removeCards(CardSet cards) const
+{
+    HandRange range (*this);
+    for (int i = 0; i < ComboCount; i++) {
+        if ((COMBOS.masks[i] & cards.mask()) != 0) {
+            range.m_weights[i] = 0.;
+        }
+    }
+    return range;
+}
+
+bool HandRange::operator==(const HandRange &other) const
+{
+    return m_weights == other.m_weights;
+}
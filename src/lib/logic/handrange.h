@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef HANDRANGE_H
+#define HANDRANGE_H
+
+/**
+ * @file handrange.h
+ * @short Definition of HandRange
+ */
+
+#include "pokqt_global.h"
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include "cardset.h"
+
+/**
+ * @brief A range of hole cards
+ *
+ * This class represents the hole cards that a player might
+ * hold, as a weight for each of the 1326 combos of 2 cards.
+ * A weight of 0 means that the combo is not in the range, and
+ * a weight of 1 that it is fully in the range.
+ *
+ * The combo of two cards whose bits in a CardSet are
+ * first < second has the index second * (second - 1) / 2 + first,
+ * computed on the 52 card numbers (suit index * 13 + rank).
+ *
+ * Ranges can be created from the standard notation, with
+ * parse(), like "AKs, QQ+, 76s". The following items, separated
+ * by commas, are supported:
+ * - pairs: "QQ", "QQ+" for all the pairs from QQ to AA, and
+ *   "99-QQ" for all the pairs from 99 to QQ,
+ * - suited or offsuit hands: "AKs", "AKo", and "AK" for both,
+ * - hands with increasing kickers: "A2s+" for all the suited
+ *   hands from A2s to AKs, and "A2s-A5s" for all the suited hands
+ *   from A2s to A5s,
+ * - a specific combo: "AhKh".
+ *
+ * Each item can be followed by a weight, like "AKs:0.5". Ranks
+ * are written with 23456789TJQKA, and suits with cdhs.
+ */
+class POKQTSHARED_EXPORT HandRange
+{
+public:
+    /**
+     * @brief Number of combos
+     */
+    static const int ComboCount = 1326;
+    /**
+     * @brief Default constructor
+     *
+     * This constructor creates an empty range.
+     */
+    explicit HandRange();
+    /**
+     * @brief Get a range containing all the combos
+     * @return a range containing all the combos.
+     */
+    static HandRange fullRange();
+    /**
+     * @brief Get a range containing a single combo
+     * @param cards cards of the combo, that should contain 2 cards.
+     * @return a range containing the combo.
+     */
+    static HandRange fromCards(CardSet cards);
+    /**
+     * @brief Get the index of a combo
+     * @param cards cards of the combo, that should contain 2 cards.
+     * @return index of the combo, or -1 if there are not 2 cards.
+     */
+    static int comboIndex(CardSet cards);
+    /**
+     * @brief Get the cards of a combo
+     * @param index index of the combo.
+     * @return cards of the combo.
+     */
+    static CardSet comboCards(int index);
+    /**
+     * @brief Parse a range
+     *
+     * The parsed combos are added to the range. If the text
+     * is not valid, the range is not modified.
+     *
+     * @param text range in the standard notation.
+     * @return if the text is valid.
+     */
+    bool parse(const QString &text);
+    /**
+     * @brief Check if the range is empty
+     * @return if no combo has a weight.
+     */
+    bool isEmpty() const;
+    /**
+     * @brief Get the number of combos in the range
+     * @return number of combos that have a weight.
+     */
+    int comboCount() const;
+    /**
+     * @brief Get the sum of the weights of the combos
+     * @return sum of the weights.
+     */
+    double totalWeight() const;
+    /**
+     * @brief Get the weight of a combo
+     * @param index index of the combo.
+     * @return weight of the combo.
+     */
+    double weight(int index) const;
+    /**
+     * @brief Set the weight of a combo
+     * @param index index of the combo.
+     * @param weight weight of the combo.
+     */
+    void setWeight(int index, double weight);
+    /**
+     * @brief Remove the combos that use some cards
+     *
+     * This is used to remove the combos that are not possible
+     * because some cards are on the board or known to be dead.
+     *
+     * @param cards cards that can't be used.
+     * @return a range without the combos using these cards.
+     */
+    HandRange removeCards(CardSet cards) const;
+    /**
+     * @brief Equality
+     * @param other other range to compare with.
+     * @return if the two ranges have the same weights.
+     */
+    bool operator==(const HandRange &other) const;
+private:
+    /**
+     * @internal
+     * @brief Weights of the combos
+     */
+    QVector<double> m_weights;
+};
+
+#endif // HANDRANGE_H
@@ -1,15 +1,60 @@
 CONFIG(c++11):DEFINES+=CPP11
+win32:LIBS += -lbcrypt
 
-HEADERS += $$PWD/card.h \
+HEADERS += $$PWD/bestfive.h \
+    $$PWD/bitops.h \
+    $$PWD/card.h \
+    $$PWD/cardset.h \
+    $$PWD/chachagenerator.h \
+    $$PWD/dealrecord.h \
     $$PWD/deck.h \
+    $$PWD/equitycalculator.h \
+    $$PWD/evaluatortable.h \
+    $$PWD/omahaevaluator.h \
+    $$PWD/outsanalyzer.h \
+    $$PWD/packedcard.h \
     $$PWD/playerproperties.h \
+    $$PWD/preflopequitytable.h \
     $$PWD/gamemanager.h \
+    $$PWD/gamerules.h \
     logic/hand.h \
+    $$PWD/handevaluator.h \
+    $$PWD/handindexer.h \
+    $$PWD/handkernels.h \
+    $$PWD/handrange.h \
+    $$PWD/randomgenerator.h \
+    $$PWD/rangeequitycalculator.h \
+    $$PWD/ranktables.h \
+    $$PWD/resultcache.h \
+    $$PWD/samplingdeck.h \
+    $$PWD/showdown.h \
+    $$PWD/tableevaluator.h \
     logic/betmanager.h
 
-SOURCES += $$PWD/card.cpp \
+SOURCES += $$PWD/bestfive.cpp \
+    $$PWD/card.cpp \
+    $$PWD/cardset.cpp \
+    $$PWD/chachagenerator.cpp \
+    $$PWD/dealrecord.cpp \
     $$PWD/deck.cpp \
+    $$PWD/equitycalculator.cpp \
+    $$PWD/evaluatortable.cpp \
+    $$PWD/omahaevaluator.cpp \
+    $$PWD/outsanalyzer.cpp \
+    $$PWD/packedcard.cpp \
     $$PWD/playerproperties.cpp \
+    $$PWD/preflopequitytable.cpp \
     $$PWD/gamemanager.cpp \
     logic/hand.cpp \
+    $$PWD/handevaluator.cpp \
+    $$PWD/handindexer.cpp \
+    $$PWD/handrange.cpp \
+    $$PWD/randomgenerator.cpp \
+    $$PWD/rangeequitycalculator.cpp \
+    $$PWD/ranktables.cpp \
+    $$PWD/samplingdeck.cpp \
+    $$PWD/showdown.cpp \
+    $$PWD/tableevaluator.cpp \
     logic/betmanager.cpp
+
+RESOURCES += $$PWD/logic.qrc
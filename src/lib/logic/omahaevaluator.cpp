@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file omahaevaluator.cpp
+ * @short Implementation of OmahaEvaluator
+ */
+
+#include "omahaevaluator.h"
+#include "bitops.h"
+#include "handevaluator.h"
+#include "ranktables.h"
+
+/**
+ * @internal
+ * @brief MAX_HOLE_PAIR_COUNT
+ *
+ * Constant representing the maximum number of pairs of hole cards.
+ */
+static const int MAX_HOLE_PAIR_COUNT = OmahaEvaluator::MaxHoleCardCount
+                                       * (OmahaEvaluator::MaxHoleCardCount - 1) / 2;
+/**
+ * @internal
+ * @brief MAX_BOARD_TRIPLE_COUNT
+ *
+ * Constant representing the maximum number of triples of board cards.
+ */
+static const int MAX_BOARD_TRIPLE_COUNT = 10;
+
+/**
+ * @internal
+ * @brief Ranks of a part of a hand
+ *
+ * The ranks are stored as the masks of the ranks that are
+ * present at least once, twice and three times.
+ */
+struct RankLayers
+{
+    /**
+     * @internal
+     * @brief Ranks present at least once
+     */
+    quint16 once;
+    /**
+     * @internal
+     * @brief Ranks present at least twice
+     */
+    quint16 twice;
+    /**
+     * @internal
+     * @brief Ranks present three times
+     */
+    quint16 three;
+};
+
+/**
+ * @internal
+ * @brief Add a rank to the layers
+ * @param layers layers to update.
+ * @param rank rank to add.
+ */
+static inline void addRank(RankLayers &layers, int rank)
+{
+    const quint16 bit = 1 << rank;
+    if (!(layers.once & bit)) {
+        layers.once |= bit;
+    } else if (!(layers.twice & bit)) {
+        layers.twice |= bit;
+    } else {
+        layers.three |= bit;
+    }
+}
+
+/**
+ * @internal
+ * @brief Add the layers to a list if they are not already present
+ * @param layers layers to add.
+ * @param list list of layers.
+ * @param count number of layers in the list, updated.
+ */
+static inline void addUnique(const RankLayers &layers, RankLayers *list, int &count)
+{
+    for (int i = 0; i < count; i++) {
+        if (list[i].once == layers.once && list[i].twice == layers.twice
+            && list[i].three == layers.three) {
+            return;
+        }
+    }
+    list[count++] = layers;
+}
+
+/**
+ * @internal
+ * @brief Evaluate the flushes of a suit
+ *
+ * All the pairs of hole cards and triples of board cards
+ * of the suit are combined. They have different ranks, so a
+ * combination is a 5-rank mask, that is evaluated with the
+ * lookup tables.
+ *
+ * @param hole rank mask of the hole cards of the suit.
+ * @param board rank mask of the board cards of the suit.
+ * @return strength of the best flush or straight flush.
+ */
+static quint16 evaluateFlushes(quint16 hole, quint16 board)
+{
+    quint16 best = 0;
+    for (quint16 first = hole; first != 0; first &= first - 1) {
+        for (quint16 second = first & (first - 1); second != 0; second &= second - 1) {
+            const quint16 pair = (first & -first) | (second & -second);
+            for (quint16 a = board; a != 0; a &= a - 1) {
+                for (quint16 b = a & (a - 1); b != 0; b &= b - 1) {
+                    for (quint16 c = b & (b - 1); c != 0; c &= c - 1) {
+                        const quint16 mask = pair | (a & -a) | (b & -b) | (c & -c);
+                        const int straight = RankTables::straights[mask];
+                        const quint16 strength = straight != 0
+                                                 ? (HandEvaluator::StraightFlush << 12) | (straight - 1)
+                                                 : (HandEvaluator::Flush << 12) | RankTables::highCards[mask];
+                        best = qMax(best, strength);
+                    }
+                }
+            }
+        }
+    }
+    return best;
+}
+
+quint16 OmahaEvaluator::evaluate(CardSet holeCards, CardSet board)
+{
+    Q_ASSERT(holeCards.count() <= MaxHoleCardCount);
+    Q_ASSERT(board.count() <= 5);
+
+    // Ranks of the pairs of hole cards
+    int holeRanks[MaxHoleCardCount];
+    int holeCount = 0;
+    for (quint64 mask = holeCards.mask(); mask != 0 && holeCount < MaxHoleCardCount; mask &= mask - 1) {
+        holeRanks[holeCount++] = lowestBit(mask) & 0xf;
+    }
+    if (holeCount < 2) {
+        return 0;
+    }
+
+    RankLayers holePairs[MAX_HOLE_PAIR_COUNT];
+    int holePairCount = 0;
+    for (int i = 0; i < holeCount; i++) {
+        for (int j = i + 1; j < holeCount; j++) {
+            RankLayers layers = {0, 0, 0};
+            addRank(layers, holeRanks[i]);
+            addRank(layers, holeRanks[j]);
+            addUnique(layers, holePairs, holePairCount);
+        }
+    }
+
+    // Ranks of the triples of board cards, or of the whole
+    // board if it has less than three cards
+    int boardRanks[5];
+    int boardCount = 0;
+    for (quint64 mask = board.mask(); mask != 0 && boardCount < 5; mask &= mask - 1) {
+        boardRanks[boardCount++] = lowestBit(mask) & 0xf;
+    }
+
+    RankLayers boardTriples[MAX_BOARD_TRIPLE_COUNT];
+    int boardTripleCount = 0;
+    if (boardCount < 3) {
+        RankLayers layers = {0, 0, 0};
+        for (int i = 0; i < boardCount; i++) {
+            addRank(layers, boardRanks[i]);
+        }
+        addUnique(layers, boardTriples, boardTripleCount);
+    } else {
+        for (int i = 0; i < boardCount; i++) {
+            for (int j = i + 1; j < boardCount; j++) {
+                for (int k = j + 1; k < boardCount; k++) {
+                    RankLayers layers = {0, 0, 0};
+                    addRank(layers, boardRanks[i]);
+                    addRank(layers, boardRanks[j]);
+                    addRank(layers, boardRanks[k]);
+                    addUnique(layers, boardTriples, boardTripleCount);
+                }
+            }
+        }
+    }
+
+    // The number of times a rank is present in the hand is the
+    // sum of the number of times it is present in both parts
+    quint16 best = 0;
+    for (int i = 0; i < holePairCount; i++) {
+        const RankLayers &hole = holePairs[i];
+        for (int j = 0; j < boardTripleCount; j++) {
+            const RankLayers &triple = boardTriples[j];
+            const quint16 ranks = hole.once | triple.once;
+            const quint16 pairs = hole.twice | triple.twice | (hole.once & triple.once);
+            const quint16 threes = triple.three | (hole.once & triple.twice) | (hole.twice & triple.once);
+            const quint16 fours = (hole.once & triple.three) | (hole.twice & triple.twice);
+            best = qMax(best, HandEvaluator::evaluateRanks(ranks, pairs, threes, fours));
+        }
+    }
+
+    // A flush needs two hole cards and three board cards of the same suit
+    if (boardCount >= 3 && best < (HandEvaluator::StraightFlush << 12)) {
+        for (int suit = 0; suit < 4; suit++) {
+            const quint16 hole = holeCards.suitMask(suit);
+            const quint16 boardSuit = board.suitMask(suit);
+            if (bitCount(hole) >= 2 && bitCount(boardSuit) >= 3) {
+                best = qMax(best, evaluateFlushes(hole, boardSuit));
+            }
+        }
+    }
+    return best;
+}
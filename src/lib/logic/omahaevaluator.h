@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef OMAHAEVALUATOR_H
+#define OMAHAEVALUATOR_H
+
+/**
+ * @file omahaevaluator.h
+ * @short Definition of OmahaEvaluator
+ */
+
+#include "pokqt_global.h"
+#include "cardset.h"
+
+/**
+ * @brief Omaha hand evaluator
+ *
+ * In Omaha, a hand is made of exactly two hole cards and
+ * three cards of the board. Evaluating the 60 combinations
+ * of a four-card hand on a full board is slow, so this evaluator
+ * splits the evaluation:
+ * - without flush, the strength only depends on the ranks. The
+ *   pairs of hole cards and the triples of board cards that have
+ *   the same ranks are only used once, and each combination is
+ *   evaluated from rank masks, with HandEvaluator::evaluateRanks().
+ * - flushes are only checked for the suits that have at least two
+ *   hole cards and three board cards, with the rank mask lookup
+ *   tables.
+ *
+ * The strengths are the same as the ones returned by HandEvaluator
+ * for the best combination, so they can be compared directly.
+ */
+class POKQTSHARED_EXPORT OmahaEvaluator
+{
+public:
+    enum {
+        /**
+         * @brief Maximum number of hole cards
+         */
+        MaxHoleCardCount = 6
+    };
+    /**
+     * @brief Evaluate a hand
+     *
+     * If the board has less than three cards, all the cards
+     * of the board are used.
+     *
+     * @param holeCards hole cards, between 2 and 6 cards.
+     * @param board cards of the board, up to 5 cards.
+     * @return strength of the best hand with two hole cards, or 0
+     * if there are less than two hole cards.
+     */
+    static quint16 evaluate(CardSet holeCards, CardSet board);
+};
+
+#endif // OMAHAEVALUATOR_H
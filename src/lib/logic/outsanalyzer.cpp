@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file outsanalyzer.cpp
+ * @short Implementation of OutsAnalyzer
+ */
+
+#include "outsanalyzer.h"
+#include "bitops.h"
+
+/**
+ * @internal
+ * @brief Get the category of a set of cards
+ * @param mask mask of the cards.
+ * @return category of the cards.
+ */
+static inline HandEvaluator::Category categoryOf(quint64 mask)
+{
+    return HandEvaluator::category(HandEvaluator::evaluate(CardSet(mask)));
+}
+
+OutsAnalyzer::OutsAnalyzer()
+    : m_category(HandEvaluator::HighCard), m_improvementProbability(0)
+    , m_riverImprovementProbability(0)
+{
+    for (int i = 0; i < PackedCard::CardCount; i++) {
+        m_opponentHitProbabilities[i] = 0;
+    }
+}
+
+CardSet OutsAnalyzer::holeCards() const
+{
+    return m_holeCards;
+}
+
+void OutsAnalyzer::setHoleCards(CardSet holeCards)
+{
+    m_holeCards = holeCards;
+}
+
+CardSet OutsAnalyzer::board() const
+{
+    return m_board;
+}
+
+void OutsAnalyzer::setBoard(CardSet board)
+{
+    m_board = board;
+}
+
+CardSet OutsAnalyzer::deadCards() const
+{
+    return m_deadCards;
+}
+
+void OutsAnalyzer::setDeadCards(CardSet deadCards)
+{
+    m_deadCards = deadCards;
+}
+
+bool OutsAnalyzer::isValid() const
+{
+    if (m_holeCards.count() != 2 || m_board.count() < 3 || m_board.count() > 4) {
+        return false;
+    }
+
+    // The same card is used twice
+    if (m_holeCards.intersects(m_board) || m_holeCards.intersects(m_deadCards)
+        || m_board.intersects(m_deadCards)) {
+        return false;
+    }
+
+    CardSet used = m_holeCards | m_board | m_deadCards;
+    return PackedCard::CardCount - used.count() >= 5 - m_board.count();
+}
+
+bool OutsAnalyzer::analyze()
+{
+    m_category = HandEvaluator::HighCard;
+    for (int i = 0; i <= HandEvaluator::StraightFlush; i++) {
+        m_outs[i].clear();
+    }
+    m_sharedOuts.clear();
+    for (int i = 0; i < PackedCard::CardCount; i++) {
+        m_opponentHitProbabilities[i] = 0;
+    }
+    m_improvementProbability = 0;
+    m_riverImprovementProbability = 0;
+
+    if (!isValid()) {
+        return false;
+    }
+
+    quint64 unseen[PackedCard::CardCount];
+    int unseenCount = 0;
+    quint64 unseenMask = unseenCards().mask();
+    while (unseenMask != 0) {
+        unseen[unseenCount++] = unseenMask & (~unseenMask + 1);
+        unseenMask &= unseenMask - 1;
+    }
+
+    const quint64 hand = (m_holeCards | m_board).mask();
+    const quint64 board = m_board.mask();
+    m_category = categoryOf(hand);
+
+    int outCount = 0;
+    for (int i = 0; i < unseenCount; i++) {
+        HandEvaluator::Category category = categoryOf(hand | unseen[i]);
+        if (category > m_category) {
+            m_outs[category] |= CardSet(unseen[i]);
+            if (categoryOf(board | unseen[i]) >= category) {
+                m_sharedOuts |= CardSet(unseen[i]);
+            }
+            outCount++;
+        }
+    }
+    m_improvementProbability = double(outCount) / unseenCount;
+
+    if (m_board.count() == 4) {
+        m_riverImprovementProbability = m_improvementProbability;
+    } else {
+        // Enumerate the turn and the river
+        int improvedCount = 0;
+        for (int i = 0; i < unseenCount; i++) {
+            for (int j = i + 1; j < unseenCount; j++) {
+                if (categoryOf(hand | unseen[i] | unseen[j]) > m_category) {
+                    improvedCount++;
+                }
+            }
+        }
+        m_riverImprovementProbability = double(improvedCount) / (unseenCount * (unseenCount - 1) / 2);
+    }
+
+    if (outCount > 0) {
+        analyzeOpponents(unseen, unseenCount);
+    }
+    return true;
+}
+
+HandEvaluator::Category OutsAnalyzer::category() const
+{
+    return m_category;
+}
+
+CardSet OutsAnalyzer::unseenCards() const
+{
+    return CardSet::fullDeck() - m_holeCards - m_board - m_deadCards;
+}
+
+CardSet OutsAnalyzer::outs() const
+{
+    CardSet outs;
+    for (int i = 0; i <= HandEvaluator::StraightFlush; i++) {
+        outs |= m_outs[i];
+    }
+    return outs;
+}
+
+CardSet OutsAnalyzer::outs(HandEvaluator::Category category) const
+{
+    if (category < HandEvaluator::HighCard || category > HandEvaluator::StraightFlush) {
+        return CardSet();
+    }
+    return m_outs[category];
+}
+
+CardSet OutsAnalyzer::sharedOuts() const
+{
+    return m_sharedOuts;
+}
+
+double OutsAnalyzer::opponentHitProbability(PackedCard out) const
+{
+    if (!out.isValid()) {
+        return 0;
+    }
+    return m_opponentHitProbabilities[out.index()];
+}
+
+double OutsAnalyzer::improvementProbability() const
+{
+    return m_improvementProbability;
+}
+
+double OutsAnalyzer::riverImprovementProbability() const
+{
+    return m_riverImprovementProbability;
+}
+
+void OutsAnalyzer::analyzeOpponents(const quint64 *unseen, int unseenCount)
+{
+    const quint64 board = m_board.mask();
+
+    // Categories of the opponent hands before the out
+    quint8 categories[PackedCard::CardCount][PackedCard::CardCount];
+    for (int i = 0; i < unseenCount; i++) {
+        for (int j = i + 1; j < unseenCount; j++) {
+            categories[i][j] = categoryOf(board | unseen[i] | unseen[j]);
+        }
+    }
+
+    const CardSet outs = this->outs();
+    for (int k = 0; k < unseenCount; k++) {
+        const CardSet out(unseen[k]);
+        if (!outs.contains(out)) {
+            continue;
+        }
+
+        HandEvaluator::Category category = categoryOf((m_holeCards | m_board).mask() | unseen[k]);
+        int hitCount = 0;
+        int opponentCount = 0;
+        for (int i = 0; i < unseenCount; i++) {
+            for (int j = i + 1; j < unseenCount; j++) {
+                if (i == k || j == k) {
+                    continue;
+                }
+                opponentCount++;
+                if (categories[i][j] < category
+                    && categoryOf(board | unseen[i] | unseen[j] | unseen[k]) >= category) {
+                    hitCount++;
+                }
+            }
+        }
+
+        // With only 2 unseen cards on the turn, there is no opponent
+        // hand left once the out is dealt
+        PackedCard card = CardSet::cardAt(lowestBit(unseen[k]));
+        m_opponentHitProbabilities[card.index()] = opponentCount > 0
+                                                   ? double(hitCount) / opponentCount : 0.;
+    }
+}
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef OUTSANALYZER_H
+#define OUTSANALYZER_H
+
+/**
+ * @file outsanalyzer.h
+ * @short Definition of OutsAnalyzer
+ */
+
+#include "pokqt_global.h"
+#include "cardset.h"
+#include "handevaluator.h"
+
+/**
+ * @brief Outs analyzer
+ *
+ * This class finds the outs of a Texas Hold'em hand on the
+ * flop or on the turn: the unseen cards that improve the
+ * category of the hand if they are dealt next. Unseen cards are
+ * the cards that are not in the hole cards, the board or the
+ * dead cards.
+ *
+ * The outs are grouped by the category they give to the hand.
+ * The analyzer also computes the probability of improving the
+ * category with the next card, and by the river, by enumerating
+ * the unseen cards.
+ *
+ * Some outs also help the opponents:
+ * - an out is shared if the board alone, with the out, has a
+ *   category at least as high as the new category of the hand,
+ *   for example when the out pairs the board. All the opponents
+ *   get the improvement.
+ * - for every out, opponentHitProbability() gives the probability
+ *   that a random opponent hand, that was weaker than the new
+ *   category of the hand, reaches that category with the out.
+ *
+ * The enumeration only uses card masks and HandEvaluator, so it
+ * do not allocate memory, and is fast enough to be run for every
+ * player on every street.
+ */
+class POKQTSHARED_EXPORT OutsAnalyzer
+{
+public:
+    /**
+     * @brief Default constructor
+     */
+    explicit OutsAnalyzer();
+    /**
+     * @brief Get the hole cards
+     * @return hole cards of the player.
+     */
+    CardSet holeCards() const;
+    /**
+     * @brief Set the hole cards
+     * @param holeCards hole cards of the player.
+     */
+    void setHoleCards(CardSet holeCards);
+    /**
+     * @brief Get the board
+     * @return cards of the board.
+     */
+    CardSet board() const;
+    /**
+     * @brief Set the board
+     * @param board cards of the board, 3 or 4 cards.
+     */
+    void setBoard(CardSet board);
+    /**
+     * @brief Get the dead cards
+     * @return dead cards.
+     */
+    CardSet deadCards() const;
+    /**
+     * @brief Set the dead cards
+     * @param deadCards cards that can't be dealt, like the cards of the folded players.
+     */
+    void setDeadCards(CardSet deadCards);
+    /**
+     * @brief Check if the parameters are valid
+     *
+     * There should be 2 hole cards, the board should have 3 or 4 cards,
+     * the same card should not be used twice and there should be enough
+     * unseen cards to deal the remaining board.
+     *
+     * @return if the parameters are valid.
+     */
+    bool isValid() const;
+    /**
+     * @brief Find the outs
+     * @return if the analysis succeeded.
+     */
+    bool analyze();
+    /**
+     * @brief Get the current category of the hand
+     * @return category of the hole cards and the board.
+     */
+    HandEvaluator::Category category() const;
+    /**
+     * @brief Get the unseen cards
+     * @return cards that can be dealt.
+     */
+    CardSet unseenCards() const;
+    /**
+     * @brief Get all the outs
+     * @return unseen cards that improve the category of the hand.
+     */
+    CardSet outs() const;
+    /**
+     * @brief Get the outs that give a category
+     * @param category category of the hand with the out.
+     * @return unseen cards that improve the hand to the given category.
+     */
+    CardSet outs(HandEvaluator::Category category) const;
+    /**
+     * @brief Get the shared outs
+     * @return outs that give a category at least as high to the board alone.
+     */
+    CardSet sharedOuts() const;
+    /**
+     * @brief Get the probability that an out also helps an opponent
+     *
+     * The opponent hands are all the pairs of unseen cards that
+     * do not contain the out. If there are not enough unseen cards
+     * to build such a pair, no opponent can be helped.
+     *
+     * @param out an out.
+     * @return probability that a random opponent hand improves from a lower
+     * category to at least the new category of the hand, or 0 if the card
+     * is not an out or if there is no opponent hand.
+     */
+    double opponentHitProbability(PackedCard out) const;
+    /**
+     * @brief Get the probability of improving with the next card
+     * @return probability that the next card is an out.
+     */
+    double improvementProbability() const;
+    /**
+     * @brief Get the probability of improving by the river
+     * @return probability that the category of the hand is improved on the river.
+     */
+    double riverImprovementProbability() const;
+private:
+    /**
+     * @internal
+     * @brief Compute the probability that each out helps an opponent
+     * @param unseen unseen cards.
+     * @param unseenCount number of unseen cards.
+     */
+    void analyzeOpponents(const quint64 *unseen, int unseenCount);
+    /**
+     * @internal
+     * @brief Hole cards
+     */
+    CardSet m_holeCards;
+    /**
+     * @internal
+     * @brief Board
+     */
+    CardSet m_board;
+    /**
+     * @internal
+     * @brief Dead cards
+     */
+    CardSet m_deadCards;
+    /**
+     * @internal
+     * @brief Current category of the hand
+     */
+    HandEvaluator::Category m_category;
+    /**
+     * @internal
+     * @brief Outs for each category
+     */
+    CardSet m_outs[HandEvaluator::StraightFlush + 1];
+    /**
+     * @internal
+     * @brief Shared outs
+     */
+    CardSet m_sharedOuts;
+    /**
+     * @internal
+     * @brief Probability that each out helps an opponent, indexed by PackedCard::index()
+     */
+    double m_opponentHitProbabilities[PackedCard::CardCount];
+    /**
+     * @internal
+     * @brief Probability of improving with the next card
+     */
+    double m_improvementProbability;
+    /**
+     * @internal
+     * @brief Probability of improving by the river
+     */
+    double m_riverImprovementProbability;
+};
+
+#endif // OUTSANALYZER_H
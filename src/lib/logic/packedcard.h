@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef PACKEDCARD_H
+#define PACKEDCARD_H
+
+/**
+ * @file packedcard.h
+ * @short Definition of PackedCard
+ */
+
+#include "pokqt_global.h"
+#include <QtCore/QDataStream>
+#include "card.h"
+
+/**
+ * @brief A card packed in one byte
+ *
+ * This class is a compact version of Card, that is
+ * meant to be used in the places where a lot of cards
+ * are manipulated, like simulations or hand evaluation.
+ *
+ * A packed card is an index between 0 and 51, that
+ * stores the rank in the upper bits and the suit in the
+ * two lower bits:
+ * - index = rank * 4 + (suit - 1)
+ * - rank = index >> 2
+ * - suit = (index & 3) + 1
+ *
+ * With this matching, comparing two indexes is the same
+ * as comparing two Card objects, as the rank is compared
+ * first and the suit after. Invalid cards are represented by
+ * the index InvalidIndex.
+ *
+ * This class can be created at compile time, and it is
+ * a primitive type, so it is stored directly in a QList or
+ * in an array. It can be converted from and to a Card without
+ * losing information.
+ */
+class PackedCard
+{
+public:
+    enum {
+        /**
+         * @brief Number of valid cards
+         */
+        CardCount = 52,
+        /**
+         * @brief Index used by invalid cards
+         */
+        InvalidIndex = 0xff
+    };
+    /**
+     * @brief Invalid constructor
+     *
+     * This constructor creates an invalid card.
+     */
+    Q_DECL_CONSTEXPR PackedCard()
+        : m_index(InvalidIndex)
+    {
+    }
+    /**
+     * @brief Constructor from an index
+     *
+     * If the index is not between 0 and 51, an invalid
+     * card is created.
+     *
+     * @param index index to set.
+     */
+    Q_DECL_CONSTEXPR explicit PackedCard(int index)
+        : m_index(index >= 0 && index < CardCount ? index : InvalidIndex)
+    {
+    }
+    /**
+     * @brief Default constructor
+     *
+     * If the suit or the rank are not valid, an
+     * invalid card is created.
+     *
+     * @param suit suit to set.
+     * @param rank rank to set.
+     */
+    Q_DECL_CONSTEXPR explicit PackedCard(Card::Suit suit, int rank)
+        : m_index(rank >= 0 && rank <= 12 && suit >= Card::Club && suit <= Card::Spade
+                  ? (rank << 2) | (suit - Card::Club) : InvalidIndex)
+    {
+    }
+    /**
+     * @brief Constructor from a Card
+     * @param card card to pack.
+     */
+    explicit PackedCard(const Card &card)
+        : m_index(PackedCard(card.suit(), card.rank()).m_index)
+    {
+    }
+    /**
+     * @brief Equality
+     * @param other other PackedCard to compare with.
+     * @return if the two PackedCard are equal.
+     */
+    Q_DECL_CONSTEXPR bool operator==(PackedCard other) const
+    {
+        return m_index == other.m_index;
+    }
+    /**
+     * @brief Inequality
+     * @param other other PackedCard to compare with.
+     * @return if the two PackedCard are not equal.
+     */
+    Q_DECL_CONSTEXPR bool operator!=(PackedCard other) const
+    {
+        return m_index != other.m_index;
+    }
+    /**
+     * @brief Comparison
+     *
+     * Provides the same order as Card::operator<.
+     *
+     * @param other other PackedCard to compare with.
+     * @return if this PackedCard is smaller than the other PackedCard.
+     */
+    Q_DECL_CONSTEXPR bool operator<(PackedCard other) const
+    {
+        return m_index < other.m_index;
+    }
+    /**
+     * @brief Comparison
+     *
+     * Provides the same order as Card::operator>.
+     *
+     * @param other other PackedCard to compare with.
+     * @return if this PackedCard is bigger than the other PackedCard.
+     */
+    Q_DECL_CONSTEXPR bool operator>(PackedCard other) const
+    {
+        return m_index > other.m_index;
+    }
+    /**
+     * @brief Get if the card is valid
+     * @return if the card is valid.
+     */
+    Q_DECL_CONSTEXPR bool isValid() const
+    {
+        return m_index != InvalidIndex;
+    }
+    /**
+     * @brief Get the card's index
+     * @return the card's index, between 0 and 51, or InvalidIndex.
+     */
+    Q_DECL_CONSTEXPR int index() const
+    {
+        return m_index;
+    }
+    /**
+     * @brief Get the card's suit
+     * @return the card's suit.
+     */
+    Q_DECL_CONSTEXPR Card::Suit suit() const
+    {
+        return isValid() ? Card::Suit((m_index & 3) + Card::Club) : Card::Invalid;
+    }
+    /**
+     * @brief Get the card's suit as an index
+     *
+     * The suit index is between 0 (club) and 3 (spade).
+     *
+     * @return the card's suit index, or -1 if the card is invalid.
+     */
+    Q_DECL_CONSTEXPR int suitIndex() const
+    {
+        return isValid() ? (m_index & 3) : -1;
+    }
+    /**
+     * @brief Get the card's rank
+     * @return the card's rank.
+     */
+    Q_DECL_CONSTEXPR int rank() const
+    {
+        return isValid() ? (m_index >> 2) : -1;
+    }
+    /**
+     * @brief Convert to a Card
+     * @return the unpacked card.
+     */
+    Card toCard() const
+    {
+        return Card(suit(), rank());
+    }
+private:
+    /**
+     * @internal
+     * @brief Index
+     */
+    quint8 m_index;
+};
+
+Q_DECLARE_TYPEINFO(PackedCard, Q_PRIMITIVE_TYPE);
+
+/**
+ * @brief Serialize a PackedCard in a QDataStream
+ * @param stream stream used to serialize.
+ * @param card object to serialize.
+ * @return a reference to the stream with the serialized object.
+ */
+QDataStream &operator <<(QDataStream &stream, PackedCard card);
+/**
+ * @brief Deserialize a PackedCard from a QDataStream
+ * @param stream stream used to deserialize.
+ * @param card reference to the object that is used to store deserialized data.
+ * @return a reference to the stream without the serialized object.
+ */
+QDataStream &operator >>(QDataStream &stream, PackedCard &card);
+
+#endif // PACKEDCARD_H
@@ -0,0 +1,519 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file preflopequitytable.cpp
+ * @short Implementation of PreflopEquityTable
+ */
+
+#include "preflopequitytable.h"
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QMap>
+#include <QtCore/QPair>
+#include <QtCore/QSaveFile>
+#include <QtCore/QVector>
+#include <QtCore/QtEndian>
+#include <algorithm>
+#include <cstring>
+#include "equitycalculator.h"
+
+const quint32 PreflopEquityTable::Version;
+const int PreflopEquityTable::ClassCount;
+const int PreflopEquityTable::MaximumOpponentCount;
+
+/**
+ * @internal
+ * @brief MAGIC
+ *
+ * Constant representing the magic string at the beginning of the file.
+ */
+static const char MAGIC[8] = {'P', 'K', 'Q', 'T', 'P', 'R', 'E', 'F'};
+/**
+ * @internal
+ * @brief RESOURCE_FILE_NAME
+ *
+ * Constant representing the table compiled in the library.
+ */
+static const char *RESOURCE_FILE_NAME = ":/pokqt/preflopequity.table";
+/**
+ * @internal
+ * @brief RANKS
+ *
+ * Constant representing the characters of the ranks.
+ */
+static const char *RANKS = "23456789TJQKA";
+/**
+ * @internal
+ * @brief FIXED_POINT_SCALE
+ *
+ * Constant representing the value of an equity of 1 in the entries.
+ */
+static const double FIXED_POINT_SCALE = 65535.;
+/**
+ * @internal
+ * @brief RANDOM_TRIAL_COUNT
+ *
+ * Constant representing the number of trials used to compute the
+ * equities against random hands.
+ */
+static const qint64 RANDOM_TRIAL_COUNT = 2000000;
+/**
+ * @internal
+ * @brief HEADS_UP_ENTRY_COUNT
+ *
+ * Constant representing the number of equities of a class against another class.
+ */
+static const int HEADS_UP_ENTRY_COUNT = PreflopEquityTable::ClassCount * PreflopEquityTable::ClassCount;
+/**
+ * @internal
+ * @brief ENTRY_COUNT
+ *
+ * Constant representing the number of entries in the table.
+ */
+static const int ENTRY_COUNT = HEADS_UP_ENTRY_COUNT
+                               + PreflopEquityTable::ClassCount
+                                 * PreflopEquityTable::MaximumOpponentCount;
+
+/**
+ * @internal
+ * @brief Header of the table file
+ *
+ * The header and the entries are stored in little endian.
+ */
+struct PreflopEquityTableHeader
+{
+    /**
+     * @internal
+     * @brief Magic string
+     */
+    char magic[8];
+    /**
+     * @internal
+     * @brief Version of the file format
+     */
+    quint32 version;
+    /**
+     * @internal
+     * @brief Size of the header, the entries are stored after the header
+     */
+    quint32 headerSize;
+    /**
+     * @internal
+     * @brief Number of classes
+     */
+    quint16 classCount;
+    /**
+     * @internal
+     * @brief Maximum number of opponents
+     */
+    quint16 opponentCount;
+    /**
+     * @internal
+     * @brief Reserved, should be 0
+     */
+    quint32 reserved;
+    /**
+     * @internal
+     * @brief Checksum of the entries
+     */
+    quint64 checksum;
+};
+
+Q_STATIC_ASSERT(sizeof(PreflopEquityTableHeader) == 32);
+
+/**
+ * @internal
+ * @brief Compute the checksum of the entries
+ *
+ * This is a FNV-1a hash, computed on the bytes of the entries
+ * as they are stored in the file.
+ *
+ * @param data entries.
+ * @param size size of the entries, in bytes.
+ * @return checksum.
+ */
+static quint64 checksum(const uchar *data, int size)
+{
+    quint64 checksum = Q_UINT64_C(0xcbf29ce484222325);
+    for (int i = 0; i < size; i++) {
+        checksum = (checksum ^ data[i]) * Q_UINT64_C(0x100000001b3);
+    }
+    return checksum;
+}
+
+/**
+ * @internal
+ * @brief Read the entries of a table file
+ * @param data content of the file.
+ * @param entries entries to fill.
+ * @return if the file is valid.
+ */
+static bool readEntries(const QByteArray &data, QVector<quint16> &entries)
+{
+    const int size = sizeof(PreflopEquityTableHeader) + ENTRY_COUNT * sizeof(quint16);
+    if (data.size() != size) {
+        return false;
+    }
+
+    const uchar *header = reinterpret_cast<const uchar *>(data.constData());
+    const uchar *values = header + sizeof(PreflopEquityTableHeader);
+    if (memcmp(header, MAGIC, sizeof(MAGIC)) != 0
+        || qFromLittleEndian<quint32>(header + 8) != PreflopEquityTable::Version
+        || qFromLittleEndian<quint32>(header + 12) != sizeof(PreflopEquityTableHeader)
+        || qFromLittleEndian<quint16>(header + 16) != PreflopEquityTable::ClassCount
+        || qFromLittleEndian<quint16>(header + 18) != PreflopEquityTable::MaximumOpponentCount
+        || qFromLittleEndian<quint64>(header + 24) != checksum(values, ENTRY_COUNT * sizeof(quint16))) {
+        return false;
+    }
+
+    entries.resize(ENTRY_COUNT);
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        entries[i] = qFromLittleEndian<quint16>(values + i * sizeof(quint16));
+    }
+    return true;
+}
+
+/**
+ * @internal
+ * @brief Read a table file
+ * @param fileName file to read.
+ * @param entries entries to fill.
+ * @return if the file is valid.
+ */
+static bool readFile(const QString &fileName, QVector<quint16> &entries)
+{
+    QFile file (fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    return readEntries(file.readAll(), entries);
+}
+
+/**
+ * @internal
+ * @brief Table loaded by the process
+ *
+ * The table is loaded when it is first used, from the file given
+ * by the POKQT_PREFLOP_EQUITY_TABLE environment variable, or from
+ * the resource compiled in the library.
+ */
+class PreflopEquityTableData
+{
+public:
+    /**
+     * @internal
+     * @brief Constructor, that loads the table
+     */
+    PreflopEquityTableData()
+    {
+        QString fileName = QString::fromLocal8Bit(qgetenv("POKQT_PREFLOP_EQUITY_TABLE"));
+        if (fileName.isEmpty()) {
+            fileName = QLatin1String(RESOURCE_FILE_NAME);
+        }
+
+        if (!readFile(fileName, entries)) {
+            qDebug() << Q_FUNC_INFO << "Invalid preflop equity table" << fileName;
+            entries.clear();
+        }
+    }
+    /**
+     * @internal
+     * @brief Entries, or an empty vector if the table is not valid
+     */
+    QVector<quint16> entries;
+};
+
+Q_GLOBAL_STATIC(PreflopEquityTableData, tableData)
+
+/**
+ * @internal
+ * @brief Apply a permutation of the suits to cards
+ * @param cards cards.
+ * @param permutation new suit index for each suit index.
+ * @return cards with permuted suits.
+ */
+static quint64 permuteSuits(CardSet cards, const int *permutation)
+{
+    quint64 mask = 0;
+    for (int i = 0; i < 4; i++) {
+        mask |= quint64(cards.suitMask(i)) << (16 * permutation[i]);
+    }
+    return mask;
+}
+
+int PreflopEquityTable::handClass(CardSet holeCards)
+{
+    if (holeCards.count() != 2) {
+        return -1;
+    }
+
+    CardSet::const_iterator it = holeCards.begin();
+    PackedCard first = *it;
+    ++it;
+    PackedCard second = *it;
+    int high = qMax(first.rank(), second.rank());
+    int low = qMin(first.rank(), second.rank());
+    if (first.suit() == second.suit()) {
+        return high * 13 + low;
+    }
+    return low * 13 + high;
+}
+
+QString PreflopEquityTable::className(int handClass)
+{
+    if (handClass < 0 || handClass >= ClassCount) {
+        return QString();
+    }
+
+    int row = handClass / 13;
+    int column = handClass % 13;
+    QString name;
+    name.append(QLatin1Char(RANKS[qMax(row, column)]));
+    name.append(QLatin1Char(RANKS[qMin(row, column)]));
+    if (row > column) {
+        name.append(QLatin1Char('s'));
+    } else if (row < column) {
+        name.append(QLatin1Char('o'));
+    }
+    return name;
+}
+
+QList<CardSet> PreflopEquityTable::classCombos(int handClass)
+{
+    QList<CardSet> combos;
+    if (handClass < 0 || handClass >= ClassCount) {
+        return combos;
+    }
+
+    int row = handClass / 13;
+    int column = handClass % 13;
+    for (int firstSuit = Card::Club; firstSuit <= Card::Spade; firstSuit++) {
+        for (int secondSuit = Card::Club; secondSuit <= Card::Spade; secondSuit++) {
+            // Pairs are only added once, suited hands have the same suit,
+            // and offsuit hands have different suits
+            bool valid = row == column ? firstSuit < secondSuit
+                                       : (row > column) == (firstSuit == secondSuit);
+            if (valid) {
+                combos.append(CardSet(PackedCard(Card::Suit(firstSuit), qMax(row, column)))
+                              | CardSet(PackedCard(Card::Suit(secondSuit), qMin(row, column))));
+            }
+        }
+    }
+    return combos;
+}
+
+double PreflopEquityTable::equity(CardSet first, CardSet second)
+{
+    if ((first & second).count() != 0) {
+        return -1.;
+    }
+    return equity(handClass(first), handClass(second));
+}
+
+double PreflopEquityTable::equity(int firstClass, int secondClass)
+{
+    if (firstClass < 0 || firstClass >= ClassCount || secondClass < 0 || secondClass >= ClassCount) {
+        return -1.;
+    }
+
+    const QVector<quint16> &entries = tableData()->entries;
+    if (entries.isEmpty()) {
+        return calculateEquity(firstClass, secondClass);
+    }
+    return entries.at(firstClass * ClassCount + secondClass) / FIXED_POINT_SCALE;
+}
+
+double PreflopEquityTable::equityAgainstRandom(CardSet holeCards, int opponentCount)
+{
+    return equityAgainstRandom(handClass(holeCards), opponentCount);
+}
+
+double PreflopEquityTable::equityAgainstRandom(int handClass, int opponentCount)
+{
+    if (handClass < 0 || handClass >= ClassCount
+        || opponentCount < 1 || opponentCount > MaximumOpponentCount) {
+        return -1.;
+    }
+
+    const QVector<quint16> &entries = tableData()->entries;
+    if (entries.isEmpty()) {
+        return calculateEquityAgainstRandom(handClass, opponentCount);
+    }
+    return entries.at(HEADS_UP_ENTRY_COUNT + handClass * MaximumOpponentCount + opponentCount - 1)
+           / FIXED_POINT_SCALE;
+}
+
+bool PreflopEquityTable::isAvailable()
+{
+    return !tableData()->entries.isEmpty();
+}
+
+double PreflopEquityTable::calculateEquity(int firstClass, int secondClass)
+{
+    if (firstClass < 0 || firstClass >= ClassCount || secondClass < 0 || secondClass >= ClassCount) {
+        return -1.;
+    }
+
+    // Pairs of combos that are the same with other suits have
+    // the same equity, so we only compute the equity of one pair
+    // of each group, that is the smallest pair of the group.
+    int permutations[24][4];
+    int permutation[4] = {0, 1, 2, 3};
+    for (int i = 0; i < 24; i++) {
+        memcpy(permutations[i], permutation, sizeof(permutation));
+        std::next_permutation(permutation, permutation + 4);
+    }
+
+    QMap<QPair<quint64, quint64>, int> groups;
+    QList<CardSet> secondCombos = classCombos(secondClass);
+    foreach (CardSet first, classCombos(firstClass)) {
+        foreach (CardSet second, secondCombos) {
+            if ((first & second).count() != 0) {
+                continue;
+            }
+
+            QPair<quint64, quint64> smallest (first.mask(), second.mask());
+            for (int i = 1; i < 24; i++) {
+                QPair<quint64, quint64> permuted (permuteSuits(first, permutations[i]),
+                                                  permuteSuits(second, permutations[i]));
+                if (permuted < smallest) {
+                    smallest = permuted;
+                }
+            }
+            groups[smallest]++;
+        }
+    }
+
+    EquityCalculator calculator;
+    double total = 0.;
+    int count = 0;
+    for (QMap<QPair<quint64, quint64>, int>::const_iterator it = groups.constBegin();
+         it != groups.constEnd(); ++it) {
+        calculator.setPlayers(QList<CardSet>() << CardSet(it.key().first)
+                                               << CardSet(it.key().second));
+        if (!calculator.calculateExact()) {
+            return -1.;
+        }
+        total += it.value() * calculator.results().first().equity();
+        count += it.value();
+    }
+    return total / count;
+}
+
+double PreflopEquityTable::calculateEquityAgainstRandom(int handClass, int opponentCount)
+{
+    if (handClass < 0 || handClass >= ClassCount
+        || opponentCount < 1 || opponentCount > MaximumOpponentCount) {
+        return -1.;
+    }
+
+    // All the combos of a class are the same with other suits
+    QList<CardSet> players;
+    players.append(classCombos(handClass).first());
+    for (int i = 0; i < opponentCount; i++) {
+        players.append(CardSet());
+    }
+
+    EquityCalculator calculator;
+    calculator.setPlayers(players);
+    calculator.setMaximumTrialCount(RANDOM_TRIAL_COUNT);
+    calculator.setSeed(quint64(handClass) * MaximumOpponentCount + opponentCount);
+    if (!calculator.calculate()) {
+        return -1.;
+    }
+    return calculator.results().first().equity();
+}
+
+bool PreflopEquityTable::generate(const QString &fileName)
+{
+    QVector<quint16> entries (ENTRY_COUNT, 0);
+    for (int first = 0; first < ClassCount; first++) {
+        // By symmetry, a class has an equity of 0.5 against itself
+        entries[first * ClassCount + first] = qRound(FIXED_POINT_SCALE / 2.);
+        for (int second = first + 1; second < ClassCount; second++) {
+            double equity = calculateEquity(first, second);
+            if (equity < 0.) {
+                return false;
+            }
+            quint16 entry = qRound(equity * FIXED_POINT_SCALE);
+            entries[first * ClassCount + second] = entry;
+            entries[second * ClassCount + first] = quint16(FIXED_POINT_SCALE) - entry;
+        }
+
+        for (int opponentCount = 1; opponentCount <= MaximumOpponentCount; opponentCount++) {
+            double equity = calculateEquityAgainstRandom(first, opponentCount);
+            if (equity < 0.) {
+                return false;
+            }
+            entries[HEADS_UP_ENTRY_COUNT + first * MaximumOpponentCount + opponentCount - 1]
+                    = qRound(equity * FIXED_POINT_SCALE);
+        }
+    }
+
+    QByteArray values (ENTRY_COUNT * sizeof(quint16), 0);
+    uchar *valueData = reinterpret_cast<uchar *>(values.data());
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        qToLittleEndian<quint16>(entries.at(i), valueData + i * sizeof(quint16));
+    }
+
+    QByteArray header (sizeof(PreflopEquityTableHeader), 0);
+    uchar *headerData = reinterpret_cast<uchar *>(header.data());
+    memcpy(headerData, MAGIC, sizeof(MAGIC));
+    qToLittleEndian<quint32>(Version, headerData + 8);
+    qToLittleEndian<quint32>(sizeof(PreflopEquityTableHeader), headerData + 12);
+    qToLittleEndian<quint16>(ClassCount, headerData + 16);
+    qToLittleEndian<quint16>(MaximumOpponentCount, headerData + 18);
+    qToLittleEndian<quint64>(checksum(valueData, values.size()), headerData + 24);
+
+    QSaveFile file (fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << Q_FUNC_INFO << "Failed to open" << fileName;
+        return false;
+    }
+
+    if (file.write(header) != header.size() || file.write(values) != values.size()) {
+        qDebug() << Q_FUNC_INFO << "Failed to write" << fileName;
+        return false;
+    }
+
+    if (!file.commit()) {
+        qDebug() << Q_FUNC_INFO << "Failed to save" << fileName;
+        return false;
+    }
+    return true;
+}
+
+bool PreflopEquityTable::verify(const QString &fileName)
+{
+    QVector<quint16> entries;
+    return readFile(fileName, entries);
+}
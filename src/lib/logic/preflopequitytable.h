@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef PREFLOPEQUITYTABLE_H
+#define PREFLOPEQUITYTABLE_H
+
+/**
+ * @file preflopequitytable.h
+ * @short Definition of PreflopEquityTable
+ */
+
+#include "pokqt_global.h"
+#include <QtCore/QString>
+#include "cardset.h"
+
+/**
+ * @brief Precomputed preflop equities
+ *
+ * This class provides the preflop equities of the 169 classes of
+ * starting hands with a direct lookup in a precomputed table. A
+ * class of starting hands is a pair, or two ranks that are suited
+ * or offsuit, like "AA", "AKs" or "AKo" (see handClass()). The
+ * table contains:
+ * - the equity of each class against each other class, that is the
+ *   average of the exact equities of all the combos of the first
+ *   class against all the combos of the second class that don't
+ *   share a card.
+ * - the equity of each class against 1 to MaximumOpponentCount
+ *   opponents with random hands, that is estimated with a Monte
+ *   Carlo simulation, and is used as a multiway approximation.
+ *
+ * The table is generated once with generate() (the pokqt-tablegen
+ * tool does this with --preflop), and stored in a small binary
+ * file, that is compiled in the library as a Qt resource. This file
+ * contains a header, with a magic string, a version, the number of
+ * classes and opponents and a checksum of the entries, followed by
+ * the entries, stored as 16-bit fixed point numbers, in little
+ * endian. The resource is loaded the first time the table is used.
+ *
+ * Another file can be used with the POKQT_PREFLOP_EQUITY_TABLE
+ * environment variable. If the table is invalid, the equities are
+ * computed when they are requested, which takes seconds.
+ */
+class POKQTSHARED_EXPORT PreflopEquityTable
+{
+public:
+    /**
+     * @brief Version of the file format
+     */
+    static const quint32 Version = 1;
+    /**
+     * @brief Number of classes of starting hands
+     */
+    static const int ClassCount = 169;
+    /**
+     * @brief Maximum number of opponents for the multiway equities
+     */
+    static const int MaximumOpponentCount = 8;
+    /**
+     * @brief Get the class of a starting hand
+     *
+     * Classes are indexes in a 13 x 13 grid. For a pair of rank
+     * r, the class is r * 13 + r. For the highest rank h and the
+     * lowest rank l, the class is h * 13 + l for suited hands,
+     * and l * 13 + h for offsuit hands.
+     *
+     * @param holeCards hole cards.
+     * @return class of the hand, or -1 if there are not two cards.
+     */
+    static int handClass(CardSet holeCards);
+    /**
+     * @brief Get the name of a class of starting hands
+     * @param handClass class of starting hands.
+     * @return name of the class, like "AKs", or an empty string for an invalid class.
+     */
+    static QString className(int handClass);
+    /**
+     * @brief Get the combos of a class of starting hands
+     * @param handClass class of starting hands.
+     * @return all the combos of the class.
+     */
+    static QList<CardSet> classCombos(int handClass);
+    /**
+     * @brief Get the preflop equity of a hand against another hand
+     *
+     * This is the equity of the class of the first hand against
+     * the class of the second hand, so the suits of the hands
+     * are not taken in account.
+     *
+     * @param first hole cards of the first player.
+     * @param second hole cards of the second player.
+     * @return equity of the first player, or -1 for invalid hands.
+     */
+    static double equity(CardSet first, CardSet second);
+    /**
+     * @brief Get the preflop equity of a class against another class
+     * @param firstClass class of the first player.
+     * @param secondClass class of the second player.
+     * @return equity of the first player, or -1 for invalid classes.
+     */
+    static double equity(int firstClass, int secondClass);
+    /**
+     * @brief Get the preflop equity of a hand against random hands
+     * @param holeCards hole cards of the player.
+     * @param opponentCount number of opponents, between 1 and MaximumOpponentCount.
+     * @return equity of the player, or -1 for an invalid hand or number of opponents.
+     */
+    static double equityAgainstRandom(CardSet holeCards, int opponentCount);
+    /**
+     * @brief Get the preflop equity of a class against random hands
+     * @param handClass class of the player.
+     * @param opponentCount number of opponents, between 1 and MaximumOpponentCount.
+     * @return equity of the player, or -1 for an invalid class or number of opponents.
+     */
+    static double equityAgainstRandom(int handClass, int opponentCount);
+    /**
+     * @brief Get if the table is available
+     *
+     * If the table is not available, the equities are computed
+     * when they are requested.
+     *
+     * @return if the table is loaded.
+     */
+    static bool isAvailable();
+    /**
+     * @brief Compute the equity of a class against another class
+     *
+     * The combos are grouped by suit isomorphism, and the equity
+     * of each group is computed with EquityCalculator::calculateExact().
+     *
+     * @param firstClass class of the first player.
+     * @param secondClass class of the second player.
+     * @return equity of the first player, or -1 for invalid classes.
+     */
+    static double calculateEquity(int firstClass, int secondClass);
+    /**
+     * @brief Compute the equity of a class against random hands
+     * @param handClass class of the player.
+     * @param opponentCount number of opponents, between 1 and MaximumOpponentCount.
+     * @return equity of the player, or -1 for an invalid class or number of opponents.
+     */
+    static double calculateEquityAgainstRandom(int handClass, int opponentCount);
+    /**
+     * @brief Generate the table
+     * @param fileName file to write.
+     * @return if the generation succeeded.
+     */
+    static bool generate(const QString &fileName);
+    /**
+     * @brief Verify a table file
+     *
+     * This method checks the header and the checksum of
+     * the entries.
+     *
+     * @param fileName file to verify.
+     * @return if the file is valid.
+     */
+    static bool verify(const QString &fileName);
+};
+
+#endif // PREFLOPEQUITYTABLE_H
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file randomgenerator.cpp
+ * @short Implementation of RandomGenerator and XoshiroGenerator
+ */
+
+#include "randomgenerator.h"
+#include <random>
+
+/**
+ * @internal
+ * @brief Step of the SplitMix64 generator
+ *
+ * This generator is used to initialize the state of other
+ * generators from a seed.
+ *
+ * @param state state of the generator, updated.
+ * @return the next random number.
+ */
+static inline quint64 splitMix64(quint64 &state)
+{
+    quint64 z = (state += Q_UINT64_C(0x9e3779b97f4a7c15));
+    z = (z ^ (z >> 30)) * Q_UINT64_C(0xbf58476d1ce4e5b9);
+    z = (z ^ (z >> 27)) * Q_UINT64_C(0x94d049bb133111eb);
+    return z ^ (z >> 31);
+}
+
+/**
+ * @internal
+ * @brief Rotate bits to the left
+ * @param value value to rotate.
+ * @param count number of bits.
+ * @return the rotated value.
+ */
+static inline quint64 rotateLeft(quint64 value, int count)
+{
+    return (value << count) | (value >> (64 - count));
+}
+
+RandomGenerator::~RandomGenerator()
+{
+}
+
+quint32 RandomGenerator::bounded(quint32 range)
+{
+    Q_ASSERT(range > 0);
+    quint64 product = (next() >> 32) * range;
+    quint32 low = quint32(product);
+    if (low < range) {
+        const quint32 threshold = -range % range;
+        while (low < threshold) {
+            product = (next() >> 32) * range;
+            low = quint32(product);
+        }
+    }
+    return product >> 32;
+}
+
+quint64 RandomGenerator::systemSeed()
+{
+    std::random_device device;
+    return (quint64(device()) << 32) | device();
+}
+
+XoshiroGenerator::XoshiroGenerator(quint64 seed, quint64 stream)
+{
+    this->seed(seed, stream);
+}
+
+void XoshiroGenerator::seed(quint64 seed, quint64 stream)
+{
+    // The stream is hashed, then combined with the seed, so that
+    // close streams start from unrelated states
+    quint64 streamState = stream;
+    quint64 state = seed ^ splitMix64(streamState);
+    for (int i = 0; i < 4; i++) {
+        m_state[i] = splitMix64(state);
+    }
+}
+
+quint64 XoshiroGenerator::next()
+{
+    const quint64 result = rotateLeft(m_state[1] * 5, 7) * 9;
+    const quint64 t = m_state[1] << 17;
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+    m_state[2] ^= t;
+    m_state[3] = rotateLeft(m_state[3], 45);
+    return result;
+}
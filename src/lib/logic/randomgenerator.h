@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef RANDOMGENERATOR_H
+#define RANDOMGENERATOR_H
+
+/**
+ * @file randomgenerator.h
+ * @short Definition of RandomGenerator and XoshiroGenerator
+ */
+
+#include "pokqt_global.h"
+
+/**
+ * @brief Random number generator
+ *
+ * This class is the interface of the random number generators
+ * used to shuffle decks. Subclasses only provide next(), that
+ * returns 64 uniformly distributed bits, and this class derives
+ * the bounded numbers used by shuffles.
+ *
+ * A generator has its own state, so each table or simulation can
+ * use its own generator, without sharing global state with the
+ * other ones.
+ */
+class POKQTSHARED_EXPORT RandomGenerator
+{
+public:
+    /**
+     * @brief Destructor
+     */
+    virtual ~RandomGenerator();
+    /**
+     * @brief Get the next random number
+     * @return 64 random bits.
+     */
+    virtual quint64 next() = 0;
+    /**
+     * @brief Get a random number in a range
+     *
+     * This uses the multiply and shift method, with a rejection
+     * step so that the numbers are not biased.
+     *
+     * @param range size of the range, greater than 0.
+     * @return a random number between 0 and range - 1.
+     */
+    quint32 bounded(quint32 range);
+    /**
+     * @brief Get a seed from the system
+     *
+     * The seed is taken from the random device of the system,
+     * and is used when no seed is provided.
+     *
+     * @return a random seed.
+     */
+    static quint64 systemSeed();
+};
+
+/**
+ * @brief xoshiro256** random number generator
+ *
+ * This is a fast generator, with a 256-bit state, that is
+ * good enough for simulations and for games.
+ *
+ * A generator is created from a seed and a stream index, so that
+ * a single master seed provides an independent stream for each
+ * table. The seed and the stream are mixed with SplitMix64 to
+ * initialize the state.
+ */
+class POKQTSHARED_EXPORT XoshiroGenerator: public RandomGenerator
+{
+public:
+    /**
+     * @brief Default constructor
+     * @param seed master seed.
+     * @param stream index of the stream.
+     */
+    explicit XoshiroGenerator(quint64 seed = 0, quint64 stream = 0);
+    /**
+     * @brief Seed the generator
+     * @param seed master seed.
+     * @param stream index of the stream.
+     */
+    void seed(quint64 seed, quint64 stream = 0);
+    /**
+     * @brief Get the next random number
+     * @return 64 random bits.
+     */
+    quint64 next();
+private:
+    /**
+     * @internal
+     * @brief State
+     */
+    quint64 m_state[4];
+};
+
+#endif // RANDOMGENERATOR_H
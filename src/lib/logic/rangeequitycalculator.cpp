@@ -0,0 +1,750 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file rangeequitycalculator.cpp
+ * @short Implementation of RangeEquityCalculator
+ */
+
+#include "rangeequitycalculator.h"
+#include <QtCore/QByteArray>
+#include <QtCore/QRunnable>
+#include <QtCore/qmath.h>
+#include <algorithm>
+#include <climits>
+#include "bitops.h"
+#include "handevaluator.h"
+#include "randomgenerator.h"
+
+/**
+ * @internal
+ * @brief BATCH_SIZE
+ *
+ * Constant representing the number of boards in a batch.
+ */
+static const int BATCH_SIZE = 16;
+/**
+ * @internal
+ * @brief DEFAULT_BOARD_COUNT
+ *
+ * Constant representing the default maximum number of boards.
+ */
+static const qint64 DEFAULT_BOARD_COUNT = 20000;
+/**
+ * @internal
+ * @brief CONFIDENCE_FACTOR
+ *
+ * Constant representing the factor applied to the standard
+ * error to get a 95% confidence interval.
+ */
+static const double CONFIDENCE_FACTOR = 1.96;
+
+/**
+ * @internal
+ * @brief Functor that orders the combos of a board by increasing strength
+ */
+struct StrengthLess
+{
+    /**
+     * @internal
+     * @brief Default constructor
+     * @param strengths strengths of the combos.
+     */
+    explicit StrengthLess(const quint16 *strengths)
+        : m_strengths(strengths)
+    {
+    }
+    /**
+     * @internal
+     * @brief Compare two combos
+     * @param first index of the first combo.
+     * @param second index of the second combo.
+     * @return if the first combo is weaker than the second.
+     */
+    bool operator()(int first, int second) const
+    {
+        return m_strengths[first] < m_strengths[second];
+    }
+    /**
+     * @internal
+     * @brief Strengths of the combos
+     */
+    const quint16 *m_strengths;
+};
+
+/**
+ * @internal
+ * @brief Task running batches of boards
+ *
+ * Each task copies the combos of the ranges that do not use
+ * the board or the dead cards, then runs batches until the
+ * calculation is finished.
+ */
+class RangeEquityTask: public QRunnable
+{
+public:
+    /**
+     * @internal
+     * @brief Default constructor
+     * @param calculator calculator that runs the task.
+     */
+    explicit RangeEquityTask(RangeEquityCalculator *calculator);
+    /**
+     * @internal
+     * @brief Run batches
+     */
+    void run();
+private:
+    /**
+     * @internal
+     * @brief Get the runout of a board, for exact calculation
+     * @param index index of the board.
+     * @return cards of the runout.
+     */
+    quint64 runout(qint64 index) const;
+    /**
+     * @internal
+     * @brief Evaluate all the combos on a board
+     * @param runout cards added to the board.
+     * @param results results of the batch.
+     */
+    void evaluate(quint64 runout, double *results);
+    /**
+     * @internal
+     * @brief Enumerate the combos of a player
+     * @param player index of the player.
+     * @param used cards used by the previous players.
+     * @param weight product of the weights of the combos of the previous players.
+     * @param results results of the batch.
+     */
+    void enumerate(int player, quint64 used, double weight, double *results);
+    /**
+     * @internal
+     * @brief Compare the combos of two players
+     *
+     * Instead of enumerating all the pairs of combos, the combos
+     * are sorted by strength, and the weight of the combos of the
+     * second player that are beaten, or tied, is accumulated while
+     * walking the combos of the first player. The combos sharing
+     * a card are removed by accumulating the weights per card.
+     *
+     * @param results results of the batch.
+     */
+    void compareHeadsUp(double *results);
+    /**
+     * @internal
+     * @brief Calculator
+     */
+    RangeEquityCalculator *m_calculator;
+    /**
+     * @internal
+     * @brief Number of players
+     */
+    int m_playerCount;
+    /**
+     * @internal
+     * @brief Board, as a mask
+     */
+    quint64 m_board;
+    /**
+     * @internal
+     * @brief Cards that can be dealt, as masks
+     */
+    QVector<quint64> m_cards;
+    /**
+     * @internal
+     * @brief Number of board cards to deal
+     */
+    int m_missingBoardCount;
+    /**
+     * @internal
+     * @brief Combos of each player, as masks
+     */
+    QList<QVector<quint64> > m_combos;
+    /**
+     * @internal
+     * @brief Weights of the combos of each player
+     */
+    QList<QVector<double> > m_weights;
+    /**
+     * @internal
+     * @brief Index of the combos of each player
+     */
+    QList<QVector<int> > m_indexes;
+    /**
+     * @internal
+     * @brief First card number of each combo
+     */
+    QVector<int> m_firstCards;
+    /**
+     * @internal
+     * @brief Second card number of each combo
+     */
+    QVector<int> m_secondCards;
+    /**
+     * @internal
+     * @brief Offset of the combos of each player in the arrays of the board
+     */
+    QVector<int> m_offsets;
+    /**
+     * @internal
+     * @brief Number of combos of each player that are possible on the board
+     */
+    QVector<int> m_counts;
+    /**
+     * @internal
+     * @brief Combos possible on the board
+     */
+    QVector<quint64> m_boardCombos;
+    /**
+     * @internal
+     * @brief Weights of the combos possible on the board
+     */
+    QVector<double> m_boardWeights;
+    /**
+     * @internal
+     * @brief Index of the combos possible on the board
+     */
+    QVector<int> m_boardIndexes;
+    /**
+     * @internal
+     * @brief Masks of the hands possible on the board
+     */
+    QVector<quint64> m_boardHands;
+    /**
+     * @internal
+     * @brief Strengths of the hands possible on the board
+     */
+    QVector<quint16> m_boardStrengths;
+    /**
+     * @internal
+     * @brief Strength of the combo chosen for each player
+     */
+    QVector<quint16> m_strengths;
+    /**
+     * @internal
+     * @brief Combos of the board, sorted by strength, used in heads-up
+     */
+    QVector<int> m_sorted;
+    /**
+     * @internal
+     * @brief Weight of the combos of the second player, by combo index, used in heads-up
+     */
+    QVector<double> m_opponentWeights;
+    /**
+     * @internal
+     * @brief Strength of the combos of the second player, by combo index, used in heads-up
+     */
+    QVector<quint16> m_opponentStrengths;
+};
+
+RangeEquityTask::RangeEquityTask(RangeEquityCalculator *calculator)
+    : m_calculator(calculator), m_playerCount(calculator->m_ranges.count())
+    , m_board(calculator->m_board.mask()), m_missingBoardCount(5 - calculator->m_board.count())
+{
+    const CardSet used = calculator->m_board | calculator->m_deadCards;
+    foreach (PackedCard card, ~used) {
+        m_cards.append(CardSet::cardMask(card));
+    }
+
+    int comboCount = 0;
+    foreach (const HandRange &range, calculator->m_ranges) {
+        QVector<quint64> combos;
+        QVector<double> weights;
+        QVector<int> indexes;
+        for (int i = 0; i < HandRange::ComboCount; i++) {
+            quint64 combo = HandRange::comboCards(i).mask();
+            if (range.weight(i) > 0. && (combo & used.mask()) == 0) {
+                combos.append(combo);
+                weights.append(range.weight(i));
+                indexes.append(i);
+            }
+        }
+        comboCount += combos.count();
+        m_combos.append(combos);
+        m_weights.append(weights);
+        m_indexes.append(indexes);
+    }
+
+    m_firstCards.fill(0, HandRange::ComboCount);
+    m_secondCards.fill(0, HandRange::ComboCount);
+    for (int i = 0; i < HandRange::ComboCount; i++) {
+        QList<int> cards;
+        foreach (PackedCard card, HandRange::comboCards(i)) {
+            cards.append(cardNumber(CardSet::cardBit(card)));
+        }
+        m_firstCards[i] = cards.at(0);
+        m_secondCards[i] = cards.at(1);
+    }
+
+    m_offsets.fill(0, m_playerCount);
+    m_counts.fill(0, m_playerCount);
+    m_boardCombos.fill(0, comboCount);
+    m_boardWeights.fill(0., comboCount);
+    m_boardIndexes.fill(0, comboCount);
+    m_boardHands.fill(0, comboCount);
+    m_boardStrengths.fill(0, comboCount);
+    m_strengths.fill(0, m_playerCount);
+    m_sorted.fill(0, comboCount);
+    m_opponentWeights.fill(0., HandRange::ComboCount);
+    m_opponentStrengths.fill(0, HandRange::ComboCount);
+}
+
+void RangeEquityTask::run()
+{
+    const int resultSize = 1 + 3 * m_playerCount;
+    int batch;
+    while ((batch = m_calculator->nextBatch()) != -1) {
+        double *results = m_calculator->m_batchResults.data() + batch * resultSize;
+        qint64 first = qint64(batch) * BATCH_SIZE;
+        qint64 last = qMin(first + BATCH_SIZE, m_calculator->m_boardCount);
+
+        if (m_calculator->m_exact) {
+            for (qint64 i = first; i < last; i++) {
+                evaluate(runout(i), results);
+            }
+            continue;
+        }
+
+        // Each batch of sampled boards has its own random stream
+        XoshiroGenerator generator (m_calculator->m_seed, batch);
+        QVector<quint64> cards = m_cards;
+        for (qint64 i = first; i < last; i++) {
+            quint64 runout = 0;
+            for (int j = 0; j < m_missingBoardCount; j++) {
+                int other = j + generator.bounded(cards.count() - j);
+                qSwap(cards[j], cards[other]);
+                runout |= cards.at(j);
+            }
+            evaluate(runout, results);
+        }
+    }
+}
+
+quint64 RangeEquityTask::runout(qint64 index) const
+{
+    // The index is decoded as a combination in colexicographic order
+    quint64 runout = 0;
+    int card = m_cards.count();
+    for (int k = m_missingBoardCount; k > 0; k--) {
+        do {
+            card--;
+        } while (qint64(binomial(card, k)) > index);
+        index -= binomial(card, k);
+        runout |= m_cards.at(card);
+    }
+    return runout;
+}
+
+void RangeEquityTask::evaluate(quint64 runout, double *results)
+{
+    const quint64 board = m_board | runout;
+    int count = 0;
+    for (int player = 0; player < m_playerCount; player++) {
+        const QVector<quint64> &combos = m_combos.at(player);
+        const QVector<double> &weights = m_weights.at(player);
+        const QVector<int> &indexes = m_indexes.at(player);
+        m_offsets[player] = count;
+        for (int i = 0; i < combos.count(); i++) {
+            if ((combos.at(i) & runout) == 0) {
+                m_boardCombos[count] = combos.at(i);
+                m_boardWeights[count] = weights.at(i);
+                m_boardIndexes[count] = indexes.at(i);
+                m_boardHands[count] = combos.at(i) | board;
+                count++;
+            }
+        }
+        m_counts[player] = count - m_offsets.at(player);
+    }
+
+    HandEvaluator::evaluateBatch(m_boardHands.constData(), m_boardStrengths.data(), count);
+    if (m_playerCount == 2) {
+        compareHeadsUp(results);
+    } else {
+        enumerate(0, 0, 1., results);
+    }
+}
+
+void RangeEquityTask::enumerate(int player, quint64 used, double weight, double *results)
+{
+    if (player == m_playerCount) {
+        quint16 best = 0;
+        int winnerCount = 0;
+        for (int i = 0; i < m_playerCount; i++) {
+            if (m_strengths.at(i) > best) {
+                best = m_strengths.at(i);
+                winnerCount = 1;
+            } else if (m_strengths.at(i) == best) {
+                winnerCount++;
+            }
+        }
+
+        results[0] += weight;
+        for (int i = 0; i < m_playerCount; i++) {
+            if (m_strengths.at(i) == best) {
+                results[1 + 3 * i + (winnerCount == 1 ? 0 : 1)] += weight;
+                results[1 + 3 * i + 2] += weight / winnerCount;
+            }
+        }
+        return;
+    }
+
+    const int offset = m_offsets.at(player);
+    const int count = m_counts.at(player);
+    for (int i = offset; i < offset + count; i++) {
+        const quint64 combo = m_boardCombos.at(i);
+        if ((combo & used) == 0) {
+            m_strengths[player] = m_boardStrengths.at(i);
+            enumerate(player + 1, used | combo, weight * m_boardWeights.at(i), results);
+        }
+    }
+}
+
+void RangeEquityTask::compareHeadsUp(double *results)
+{
+    const int heroOffset = m_offsets.at(0);
+    const int heroCount = m_counts.at(0);
+    const int opponentOffset = m_offsets.at(1);
+    const int opponentCount = m_counts.at(1);
+    int *heroCombos = m_sorted.data() + heroOffset;
+    int *opponentCombos = m_sorted.data() + opponentOffset;
+    for (int i = 0; i < heroCount + opponentCount; i++) {
+        m_sorted[heroOffset + i] = heroOffset + i;
+    }
+    std::sort(heroCombos, heroCombos + heroCount, StrengthLess(m_boardStrengths.constData()));
+    std::sort(opponentCombos, opponentCombos + opponentCount,
+              StrengthLess(m_boardStrengths.constData()));
+
+    // Weights of the combos of the opponent: in total, weaker than the
+    // current strength, and weaker or equal to the current strength
+    double total = 0.;
+    double totalCards[PackedCard::CardCount] = {};
+    double less = 0.;
+    double lessCards[PackedCard::CardCount] = {};
+    double lessEqual = 0.;
+    double lessEqualCards[PackedCard::CardCount] = {};
+    for (int i = opponentOffset; i < opponentOffset + opponentCount; i++) {
+        const int index = m_boardIndexes.at(i);
+        const double weight = m_boardWeights.at(i);
+        total += weight;
+        totalCards[m_firstCards.at(index)] += weight;
+        totalCards[m_secondCards.at(index)] += weight;
+        m_opponentWeights[index] = weight;
+        m_opponentStrengths[index] = m_boardStrengths.at(i);
+    }
+
+    int lessIndex = 0;
+    int lessEqualIndex = 0;
+    for (int i = 0; i < heroCount; i++) {
+        const int combo = heroCombos[i];
+        const quint16 strength = m_boardStrengths.at(combo);
+        while (lessIndex < opponentCount && m_boardStrengths.at(opponentCombos[lessIndex]) < strength) {
+            const int index = m_boardIndexes.at(opponentCombos[lessIndex]);
+            const double weight = m_boardWeights.at(opponentCombos[lessIndex]);
+            less += weight;
+            lessCards[m_firstCards.at(index)] += weight;
+            lessCards[m_secondCards.at(index)] += weight;
+            lessIndex++;
+        }
+        while (lessEqualIndex < opponentCount
+               && m_boardStrengths.at(opponentCombos[lessEqualIndex]) <= strength) {
+            const int index = m_boardIndexes.at(opponentCombos[lessEqualIndex]);
+            const double weight = m_boardWeights.at(opponentCombos[lessEqualIndex]);
+            lessEqual += weight;
+            lessEqualCards[m_firstCards.at(index)] += weight;
+            lessEqualCards[m_secondCards.at(index)] += weight;
+            lessEqualIndex++;
+        }
+
+        // The combos sharing a card are removed twice when they
+        // share both cards, so the identical combo is added back
+        const int index = m_boardIndexes.at(combo);
+        const int first = m_firstCards.at(index);
+        const int second = m_secondCards.at(index);
+        const double same = m_opponentWeights.at(index);
+        const quint16 sameStrength = m_opponentStrengths.at(index);
+        double possible = total - totalCards[first] - totalCards[second] + same;
+        double win = less - lessCards[first] - lessCards[second]
+                     + (sameStrength < strength ? same : 0.);
+        double tie = lessEqual - lessEqualCards[first] - lessEqualCards[second]
+                     + (sameStrength <= strength ? same : 0.) - win;
+        double lose = possible - win - tie;
+
+        const double weight = m_boardWeights.at(combo);
+        results[0] += weight * possible;
+        results[1] += weight * win;
+        results[2] += weight * tie;
+        results[3] += weight * (win + tie / 2.);
+        results[4] += weight * lose;
+        results[5] += weight * tie;
+        results[6] += weight * (lose + tie / 2.);
+    }
+
+    for (int i = opponentOffset; i < opponentOffset + opponentCount; i++) {
+        m_opponentWeights[m_boardIndexes.at(i)] = 0.;
+    }
+}
+
+RangeEquityCalculator::RangeEquityCalculator()
+    : m_maximumBoardCount(DEFAULT_BOARD_COUNT), m_seed(0), m_batchCount(0), m_exact(false)
+    , m_boardCount(0), m_cache(0)
+{
+}
+
+RangeEquityCalculator::~RangeEquityCalculator()
+{
+}
+
+QList<HandRange> RangeEquityCalculator::ranges() const
+{
+    return m_ranges;
+}
+
+void RangeEquityCalculator::setRanges(const QList<HandRange> &ranges)
+{
+    m_ranges = ranges;
+}
+
+CardSet RangeEquityCalculator::board() const
+{
+    return m_board;
+}
+
+void RangeEquityCalculator::setBoard(CardSet board)
+{
+    m_board = board;
+}
+
+CardSet RangeEquityCalculator::deadCards() const
+{
+    return m_deadCards;
+}
+
+void RangeEquityCalculator::setDeadCards(CardSet deadCards)
+{
+    m_deadCards = deadCards;
+}
+
+qint64 RangeEquityCalculator::maximumBoardCount() const
+{
+    return m_maximumBoardCount;
+}
+
+void RangeEquityCalculator::setMaximumBoardCount(qint64 maximumBoardCount)
+{
+    m_maximumBoardCount = maximumBoardCount;
+}
+
+quint64 RangeEquityCalculator::seed() const
+{
+    return m_seed;
+}
+
+void RangeEquityCalculator::setSeed(quint64 seed)
+{
+    m_seed = seed;
+}
+
+int RangeEquityCalculator::threadCount() const
+{
+    return m_threadPool.maxThreadCount();
+}
+
+void RangeEquityCalculator::setThreadCount(int threadCount)
+{
+    m_threadPool.setMaxThreadCount(threadCount);
+}
+
+EquityCache * RangeEquityCalculator::cache() const
+{
+    return m_cache;
+}
+
+void RangeEquityCalculator::setCache(EquityCache *cache)
+{
+    m_cache = cache;
+}
+
+bool RangeEquityCalculator::isValid() const
+{
+    if (m_ranges.count() < 2 || m_board.count() > 5 || !(m_board & m_deadCards).isEmpty()) {
+        return false;
+    }
+
+    foreach (const HandRange &range, m_ranges) {
+        if (range.removeCards(m_board | m_deadCards).isEmpty()) {
+            return false;
+        }
+    }
+
+    // Enough cards to deal the hole cards and the board
+    int missingCount = 2 * m_ranges.count() + 5 - m_board.count();
+    return PackedCard::CardCount - (m_board | m_deadCards).count() >= missingCount;
+}
+
+bool RangeEquityCalculator::calculate()
+{
+    m_boardCount = 0;
+    m_batchResults.clear();
+    m_cachedResults.clear();
+    if (!isValid() || m_maximumBoardCount <= 0) {
+        return false;
+    }
+
+    qint64 possibleCount = binomial(PackedCard::CardCount - (m_board | m_deadCards).count(),
+                                    5 - m_board.count());
+    m_exact = possibleCount <= m_maximumBoardCount;
+    m_boardCount = m_exact ? possibleCount : m_maximumBoardCount;
+
+    qint64 batchCount = (m_boardCount + BATCH_SIZE - 1) / BATCH_SIZE;
+    m_batchCount = int(qMin<qint64>(batchCount, INT_MAX));
+    m_boardCount = qMin(m_boardCount, qint64(m_batchCount) * BATCH_SIZE);
+
+    // In heads-up, the results of the second player are
+    // deduced from the results of the first player
+    const bool cached = m_cache && m_ranges.count() == 2;
+    const quint64 key = cached ? cacheKey() : 0;
+    Equity equity;
+    if (cached && m_cache->find(key, &equity)) {
+        m_cachedResults.append(equity);
+        m_cachedResults.append(Equity(1. - equity.win() - equity.tie(), equity.tie(),
+                                      1. - equity.equity(), equity.error()));
+        return true;
+    }
+
+    m_batchResults.fill(0., m_batchCount * (1 + 3 * m_ranges.count()));
+    m_nextBatch.store(0);
+
+    int taskCount = qMin(qMax(m_threadPool.maxThreadCount(), 1), m_batchCount);
+    for (int i = 0; i < taskCount; i++) {
+        m_threadPool.start(new RangeEquityTask(this));
+    }
+    m_threadPool.waitForDone();
+
+    // Ranges that can't be dealt together, because one range is
+    // blocked by the other, don't have any weight
+    const int resultSize = 1 + 3 * m_ranges.count();
+    double totalWeight = 0.;
+    for (int batch = 0; batch < m_batchCount; batch++) {
+        totalWeight += m_batchResults.at(batch * resultSize);
+    }
+    if (totalWeight <= 0.) {
+        m_batchResults.clear();
+        return false;
+    }
+
+    if (cached) {
+        m_cache->insert(key, results().first());
+    }
+    return true;
+}
+
+QList<Equity> RangeEquityCalculator::results() const
+{
+    if (!m_cachedResults.isEmpty()) {
+        return m_cachedResults;
+    }
+
+    QList<Equity> results;
+    if (m_batchResults.isEmpty()) {
+        return results;
+    }
+
+    // The results are summed in the order of the batches
+    const int playerCount = m_ranges.count();
+    const int resultSize = 1 + 3 * playerCount;
+    QVector<double> totals (resultSize, 0.);
+    for (int batch = 0; batch < m_batchCount; batch++) {
+        for (int i = 0; i < resultSize; i++) {
+            totals[i] += m_batchResults.at(batch * resultSize + i);
+        }
+    }
+
+    const double totalWeight = totals.at(0);
+    for (int player = 0; player < playerCount; player++) {
+        double equity = totals.at(1 + 3 * player + 2) / totalWeight;
+
+        // Error of the ratio estimator, using the batches as samples
+        double error = 0.;
+        if (!m_exact && m_batchCount > 1) {
+            double sum = 0.;
+            for (int batch = 0; batch < m_batchCount; batch++) {
+                const double *batchResults = m_batchResults.constData() + batch * resultSize;
+                double deviation = batchResults[1 + 3 * player + 2] - equity * batchResults[0];
+                sum += deviation * deviation;
+            }
+            double meanWeight = totalWeight / m_batchCount;
+            double variance = sum / (m_batchCount - 1) / m_batchCount / (meanWeight * meanWeight);
+            error = CONFIDENCE_FACTOR * qSqrt(variance);
+        }
+
+        results.append(Equity(totals.at(1 + 3 * player) / totalWeight,
+                              totals.at(1 + 3 * player + 1) / totalWeight, equity, error));
+    }
+    return results;
+}
+
+qint64 RangeEquityCalculator::boardCount() const
+{
+    return m_boardCount;
+}
+
+bool RangeEquityCalculator::isExact() const
+{
+    return m_exact;
+}
+
+quint64 RangeEquityCalculator::cacheKey() const
+{
+    // FNV-1a hash of the parameters
+    QByteArray data;
+    foreach (const HandRange &range, m_ranges) {
+        for (int i = 0; i < HandRange::ComboCount; i++) {
+            double weight = range.weight(i);
+            data.append(reinterpret_cast<const char *>(&weight), sizeof(weight));
+        }
+    }
+    quint64 values[4] = {m_board.mask(), m_deadCards.mask(), quint64(m_maximumBoardCount), m_seed};
+    data.append(reinterpret_cast<const char *>(values), sizeof(values));
+
+    const uchar *bytes = reinterpret_cast<const uchar *>(data.constData());
+    quint64 hash = Q_UINT64_C(0xcbf29ce484222325);
+    for (int i = 0; i < data.size(); i++) {
+        hash = (hash ^ bytes[i]) * Q_UINT64_C(0x100000001b3);
+    }
+    return hash;
+}
+
+int RangeEquityCalculator::nextBatch()
+{
+    int batch = m_nextBatch.fetchAndAddRelaxed(1);
+    return batch < m_batchCount ? batch : -1;
+}
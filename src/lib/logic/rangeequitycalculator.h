@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef RANGEEQUITYCALCULATOR_H
+#define RANGEEQUITYCALCULATOR_H
+
+/**
+ * @file rangeequitycalculator.h
+ * @short Definition of RangeEquityCalculator
+ */
+
+#include "pokqt_global.h"
+#include <QtCore/QAtomicInt>
+#include <QtCore/QList>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+#include "cardset.h"
+#include "equitycalculator.h"
+#include "handrange.h"
+#include "resultcache.h"
+
+/**
+ * @brief Cache of the equities of two ranges
+ */
+typedef ResultCache<Equity> EquityCache;
+
+/**
+ * @brief Range versus range equity calculator
+ *
+ * This class computes the equity of players described by
+ * ranges of hole cards, on a partial board, with some dead
+ * cards.
+ *
+ * For each board, all the combos of all the ranges that do
+ * not use a card of the board are evaluated in one batch.
+ * Then every combination of combos that do not share a card
+ * is weighted by the product of the weights of the combos, and
+ * its showdown is counted. The cost of a board is then the
+ * product of the sizes of the ranges.
+ *
+ * If the number of possible boards is at most the maximum
+ * board count, all the boards are enumerated and the results
+ * are exact. Otherwise, the maximum board count of boards
+ * are sampled, and the results are estimated.
+ *
+ * The boards are split in batches that are run on a thread
+ * pool, and the results of the batches are summed in order, so
+ * they only depend on the seed and not on the number of threads.
+ *
+ * The results of two ranges can be stored in an EquityCache, that
+ * can be shared between calculators. They are mapped by a 64-bit
+ * hash of the ranges, the board, the dead cards, the maximum board
+ * count and the seed.
+ */
+class POKQTSHARED_EXPORT RangeEquityCalculator
+{
+public:
+    /**
+     * @brief Default constructor
+     */
+    explicit RangeEquityCalculator();
+    /**
+     * @brief Destructor
+     */
+    virtual ~RangeEquityCalculator();
+    /**
+     * @brief Get the ranges of the players
+     * @return ranges of the players.
+     */
+    QList<HandRange> ranges() const;
+    /**
+     * @brief Set the ranges of the players
+     * @param ranges ranges of the players.
+     */
+    void setRanges(const QList<HandRange> &ranges);
+    /**
+     * @brief Get the board
+     * @return cards of the board.
+     */
+    CardSet board() const;
+    /**
+     * @brief Set the board
+     * @param board cards of the board, up to 5.
+     */
+    void setBoard(CardSet board);
+    /**
+     * @brief Get the dead cards
+     * @return dead cards.
+     */
+    CardSet deadCards() const;
+    /**
+     * @brief Set the dead cards
+     * @param deadCards cards that can't be dealt.
+     */
+    void setDeadCards(CardSet deadCards);
+    /**
+     * @brief Get the maximum number of boards
+     * @return maximum number of boards.
+     */
+    qint64 maximumBoardCount() const;
+    /**
+     * @brief Set the maximum number of boards
+     *
+     * If there are more possible boards, boards are sampled.
+     *
+     * @param maximumBoardCount maximum number of boards.
+     */
+    void setMaximumBoardCount(qint64 maximumBoardCount);
+    /**
+     * @brief Get the seed
+     * @return seed used to sample boards.
+     */
+    quint64 seed() const;
+    /**
+     * @brief Set the seed
+     * @param seed seed used to sample boards.
+     */
+    void setSeed(quint64 seed);
+    /**
+     * @brief Get the number of threads
+     * @return number of threads used for the calculation.
+     */
+    int threadCount() const;
+    /**
+     * @brief Set the number of threads
+     * @param threadCount number of threads used for the calculation.
+     */
+    void setThreadCount(int threadCount);
+    /**
+     * @brief Cache of the results
+     * @return cache of the results, or 0 if there is no cache.
+     */
+    EquityCache * cache() const;
+    /**
+     * @brief Set the cache of the results
+     *
+     * The cache is only used for two ranges. It is not owned
+     * by the calculator.
+     *
+     * @param cache cache of the results, or 0 to not use a cache.
+     */
+    void setCache(EquityCache *cache);
+    /**
+     * @brief Check if the parameters are valid
+     *
+     * There should be at least 2 ranges, the board should have
+     * at most 5 cards, the board and the dead cards should not share
+     * a card, and each range should contain at least a combo that
+     * do not use the board or the dead cards.
+     *
+     * @return if the parameters are valid.
+     */
+    bool isValid() const;
+    /**
+     * @brief Run the calculation
+     *
+     * This method blocks until the calculation is finished.
+     *
+     * The calculation fails if the parameters are invalid, or if
+     * the ranges can't be dealt together on any of the boards,
+     * for example when a range is blocked by the other ones.
+     *
+     * @return if the calculation succeeded.
+     */
+    bool calculate();
+    /**
+     * @brief Get the results of the last calculation
+     * @return the equity of each player.
+     */
+    QList<Equity> results() const;
+    /**
+     * @brief Get the number of boards of the last calculation
+     * @return number of boards.
+     */
+    qint64 boardCount() const;
+    /**
+     * @brief Check if the results are exact
+     * @return if all the boards were enumerated.
+     */
+    bool isExact() const;
+private:
+    Q_DISABLE_COPY(RangeEquityCalculator)
+    friend class RangeEquityTask;
+    /**
+     * @internal
+     * @brief Key of the results in the cache
+     * @return hash of the parameters of the calculation.
+     */
+    quint64 cacheKey() const;
+    /**
+     * @internal
+     * @brief Get the index of the next batch to run
+     * @return index of the next batch, or -1 if the calculation is finished.
+     */
+    int nextBatch();
+    /**
+     * @internal
+     * @brief Ranges of the players
+     */
+    QList<HandRange> m_ranges;
+    /**
+     * @internal
+     * @brief Board
+     */
+    CardSet m_board;
+    /**
+     * @internal
+     * @brief Dead cards
+     */
+    CardSet m_deadCards;
+    /**
+     * @internal
+     * @brief Maximum number of boards
+     */
+    qint64 m_maximumBoardCount;
+    /**
+     * @internal
+     * @brief Seed
+     */
+    quint64 m_seed;
+    /**
+     * @internal
+     * @brief Thread pool running the batches
+     */
+    QThreadPool m_threadPool;
+    /**
+     * @internal
+     * @brief Index of the next batch
+     */
+    QAtomicInt m_nextBatch;
+    /**
+     * @internal
+     * @brief Number of batches
+     */
+    int m_batchCount;
+    /**
+     * @internal
+     * @brief If all the boards are enumerated
+     */
+    bool m_exact;
+    /**
+     * @internal
+     * @brief Number of boards
+     */
+    qint64 m_boardCount;
+    /**
+     * @internal
+     * @brief Results of each batch
+     *
+     * Each batch has the total weight of its showdowns, followed
+     * by the weighted wins, ties and equities of each player.
+     */
+    QVector<double> m_batchResults;
+    /**
+     * @internal
+     * @brief Cache of the results
+     */
+    EquityCache *m_cache;
+    /**
+     * @internal
+     * @brief Results found in the cache
+     */
+    QList<Equity> m_cachedResults;
+};
+
+#endif // RANGEEQUITYCALCULATOR_H
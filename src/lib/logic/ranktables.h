@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef RANKTABLES_H
+#define RANKTABLES_H
+
+/**
+ * @file ranktables.h
+ * @short Definition of RankTables
+ */
+
+#include <QtCore/qglobal.h>
+#include "bitops.h"
+
+/**
+ * @internal
+ * @brief List of rank masks
+ *
+ * This list is used to expand the tables of RankTables
+ * with one entry per rank mask.
+ */
+template <int... Masks>
+struct RankMaskList
+{
+};
+
+/**
+ * @internal
+ * @brief Concatenate two lists of rank masks
+ *
+ * The masks of the second list are shifted after the masks
+ * of the first list.
+ */
+template <typename First, typename Second>
+struct RankMaskListConcat;
+
+/**
+ * @internal
+ * @brief Concatenate two lists of rank masks
+ */
+template <int... First, int... Second>
+struct RankMaskListConcat<RankMaskList<First...>, RankMaskList<Second...> >
+{
+    typedef RankMaskList<First..., (int(sizeof...(First)) + Second)...> Type;
+};
+
+/**
+ * @internal
+ * @brief Build the list of rank masks from 0 to Count - 1
+ *
+ * The list is built by concatenating two halves, so that the
+ * depth of the template recursion stays small.
+ */
+template <int Count>
+struct MakeRankMaskList
+{
+    typedef typename RankMaskListConcat<typename MakeRankMaskList<Count / 2>::Type,
+                                        typename MakeRankMaskList<Count - Count / 2>::Type>::Type Type;
+};
+
+/**
+ * @internal
+ * @brief Build an empty list of rank masks
+ */
+template <>
+struct MakeRankMaskList<0>
+{
+    typedef RankMaskList<> Type;
+};
+
+/**
+ * @internal
+ * @brief Build a list containing the rank mask 0
+ */
+template <>
+struct MakeRankMaskList<1>
+{
+    typedef RankMaskList<0> Type;
+};
+
+/**
+ * @brief Functions on 13-bit rank masks
+ *
+ * These functions are constexpr, and are used to build the
+ * tables of RankTables at compile time.
+ */
+class RankFunctions
+{
+public:
+    enum {
+        /**
+         * @brief Number of 13-bit rank masks
+         */
+        MaskCount = 1 << 13
+    };
+    /**
+     * @brief Number of ranks in a mask
+     * @param mask rank mask.
+     * @return number of ranks in the mask.
+     */
+    static Q_DECL_CONSTEXPR int bitCount(int mask)
+    {
+        return mask == 0 ? 0 : (mask & 1) + bitCount(mask >> 1);
+    }
+    /**
+     * @brief Highest rank of a mask
+     * @param mask rank mask, that should not be 0.
+     * @return highest rank of the mask.
+     */
+    static Q_DECL_CONSTEXPR int highestRank(int mask)
+    {
+        return mask <= 1 ? 0 : 1 + highestRank(mask >> 1);
+    }
+    /**
+     * @brief Highest rank of a straight, plus one
+     *
+     * The ace is also used as a 1 for the 5432A straight.
+     *
+     * @param mask rank mask.
+     * @return highest rank of the highest straight plus one, or 0 if there is no straight.
+     */
+    static Q_DECL_CONSTEXPR int straight(int mask)
+    {
+        return straightRuns((mask << 1) | (mask >> 12)) != 0
+               ? highestRank(straightRuns((mask << 1) | (mask >> 12))) + 4 : 0;
+    }
+    /**
+     * @brief Count the subsets with a maximum size
+     * @param p number of ranks to choose from.
+     * @param k maximum size of the subsets.
+     * @return number of subsets of at most k elements among p elements.
+     */
+    static Q_DECL_CONSTEXPR int subsetCount(int p, int k)
+    {
+        return k < 0 ? 0 : (k > p ? subsetCount(p, p) : int(binomial(p, k)) + subsetCount(p, k - 1));
+    }
+    /**
+     * @brief Compute the position of the kickers
+     *
+     * Kickers are compared by their highest card first, and
+     * a missing kicker is weaker than any kicker. Sorting sets of
+     * kickers this way is the same as sorting their rank masks as
+     * integers. In order to get compact values, we compute the
+     * position of a set of at most n kickers among all sets of at
+     * most n ranks, using the number of subsets of at most k elements
+     * of the p lowest ranks.
+     *
+     * @param mask rank mask containing the kickers.
+     * @param n number of kickers to keep.
+     * @return the position of the n highest ranks of the mask, among all
+     * sets of at most n ranks.
+     */
+    static Q_DECL_CONSTEXPR int kickerPosition(int mask, int n)
+    {
+        return n == 0 || mask == 0 ? 0
+               : subsetCount(highestRank(mask), n)
+                 + kickerPosition(mask & ~(1 << highestRank(mask)), n - 1);
+    }
+private:
+    /**
+     * @internal
+     * @brief Find the runs of five ranks
+     * @param extendedMask rank mask, shifted by one, with the ace in the lowest bit.
+     * @return mask of the lowest bits of the runs of five ranks.
+     */
+    static Q_DECL_CONSTEXPR int straightRuns(int extendedMask)
+    {
+        return extendedMask & (extendedMask >> 1) & (extendedMask >> 2)
+               & (extendedMask >> 3) & (extendedMask >> 4);
+    }
+};
+
+/**
+ * @brief Array indexed by rank masks
+ *
+ * This array can be created and read at compile time.
+ */
+template <typename T>
+struct RankArray
+{
+    /**
+     * @brief Value for a rank mask
+     * @param mask rank mask.
+     * @return value for the rank mask.
+     */
+    Q_DECL_CONSTEXPR T operator[](int mask) const
+    {
+        return values[mask];
+    }
+    /**
+     * @brief Values
+     */
+    T values[RankFunctions::MaskCount];
+};
+
+/**
+ * @internal
+ * @brief Build the tables of RankTables
+ *
+ * The functions of this class are only evaluated at compile time.
+ */
+struct RankTablesBuilder
+{
+    /**
+     * @internal
+     * @brief Build the number of ranks in each mask
+     */
+    template <int... Masks>
+    static Q_DECL_CONSTEXPR RankArray<quint8> bitCounts(RankMaskList<Masks...>)
+    {
+        return RankArray<quint8>{{quint8(RankFunctions::bitCount(Masks))...}};
+    }
+    /**
+     * @internal
+     * @brief Build the highest ranks of the straights
+     */
+    template <int... Masks>
+    static Q_DECL_CONSTEXPR RankArray<quint8> straights(RankMaskList<Masks...>)
+    {
+        return RankArray<quint8>{{quint8(RankFunctions::straight(Masks))...}};
+    }
+    /**
+     * @internal
+     * @brief Build the positions of the kickers
+     */
+    template <int... Masks>
+    static Q_DECL_CONSTEXPR RankArray<quint16> kickers(RankMaskList<Masks...>, int n)
+    {
+        return RankArray<quint16>{{quint16(RankFunctions::kickerPosition(Masks, n))...}};
+    }
+};
+
+/**
+ * @brief Lookup tables indexed by 13-bit rank masks
+ *
+ * These tables are used by the hand evaluators. They are
+ * generated at compile time by the constexpr functions of
+ * RankFunctions, so they are stored in read-only data, and
+ * do not need to be initialized at startup.
+ */
+class RankTables
+{
+public:
+    /**
+     * @brief Number of ranks in a mask
+     */
+    static Q_DECL_CONSTEXPR RankArray<quint8> bitCounts
+        = RankTablesBuilder::bitCounts(MakeRankMaskList<RankFunctions::MaskCount>::Type());
+    /**
+     * @brief Highest rank of a straight, plus one, or 0 if there is no straight
+     */
+    static Q_DECL_CONSTEXPR RankArray<quint8> straights
+        = RankTablesBuilder::straights(MakeRankMaskList<RankFunctions::MaskCount>::Type());
+    /**
+     * @brief Position of the 5 highest ranks among all sets of at most 5 ranks
+     *
+     * See RankFunctions::kickerPosition().
+     */
+    static Q_DECL_CONSTEXPR RankArray<quint16> highCards
+        = RankTablesBuilder::kickers(MakeRankMaskList<RankFunctions::MaskCount>::Type(), 5);
+    /**
+     * @brief Position of the 3 highest ranks among all sets of at most 3 ranks
+     */
+    static Q_DECL_CONSTEXPR RankArray<quint16> threeKickers
+        = RankTablesBuilder::kickers(MakeRankMaskList<RankFunctions::MaskCount>::Type(), 3);
+};
+
+Q_STATIC_ASSERT(RankTables::bitCounts[0x1fff] == 13);
+Q_STATIC_ASSERT(RankTables::straights[0x100f] == 4);
+Q_STATIC_ASSERT(RankTables::straights[0x1f00] == 13);
+Q_STATIC_ASSERT(RankTables::straights[0x1f7f] == 13);
+Q_STATIC_ASSERT(RankTables::straights[0x1e07] == 0);
+Q_STATIC_ASSERT(RankTables::highCards[0] == 0);
+Q_STATIC_ASSERT(RankTables::highCards[0x1f00] == RankFunctions::subsetCount(13, 5) - 1);
+Q_STATIC_ASSERT(RankTables::threeKickers[0x1c00] == RankFunctions::subsetCount(13, 3) - 1);
+
+#endif // RANKTABLES_H
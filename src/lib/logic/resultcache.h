@@ -0,0 +1,326 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+/**
+ * @file resultcache.h
+ * @short Definition of ResultCache
+ */
+
+#include <QtCore/qglobal.h>
+#include <atomic>
+#include <cstring>
+
+/**
+ * @brief Bounded cache of computation results
+ *
+ * This class maps 64-bit keys, like the mask of a CardSet, to
+ * results of a computation, like the strength of a hand. It is
+ * used to share results between the tables and the calculators
+ * that compute the same results again and again.
+ *
+ * The cache has a fixed size, given as a budget in bytes when it
+ * is created, and never allocates memory after. It is a set
+ * associative cache: a key can only be stored in WayCount
+ * entries, that form the bucket of the key. When a bucket is full,
+ * the entry to replace is selected with the CLOCK algorithm, so
+ * that entries that were found since the last pass are kept.
+ *
+ * The cache can be used by several threads without locking. Each
+ * entry is protected by a sequence number: a writer makes the
+ * sequence number odd while it writes the entry, and a reader only
+ * accepts the entry if the sequence number was even and did not
+ * change while the entry was read. A writer that finds the entry
+ * busy simply drops its result. The value type should be trivially
+ * copyable.
+ *
+ * The number of lookups that found a result and that did not find
+ * a result are counted, see hitCount() and missCount().
+ *
+ * Note that a lookup costs about as much as HandEvaluator::evaluate(),
+ * so caching strengths only pays with slower evaluators. Caching
+ * equities, that take milliseconds to compute, always pays.
+ */
+template<typename T>
+class ResultCache
+{
+public:
+    /**
+     * @brief Number of entries in a bucket
+     */
+    static const int WayCount = 4;
+    /**
+     * @brief Default budget of a cache, in bytes
+     */
+    static const qint64 DefaultByteBudget = 4 << 20;
+    /**
+     * @brief Default constructor
+     *
+     * The number of buckets is the highest power of 2 that
+     * fits in the budget, with at least one bucket.
+     *
+     * @param byteBudget maximum size of the entries, in bytes.
+     */
+    explicit ResultCache(qint64 byteBudget = DefaultByteBudget)
+        : m_bucketCount(1)
+    {
+        while (2 * m_bucketCount * WayCount * qint64(sizeof(Entry)) <= byteBudget) {
+            m_bucketCount *= 2;
+        }
+        m_entries = new Entry[m_bucketCount * WayCount];
+        clear();
+    }
+    /**
+     * @brief Destructor
+     */
+    ~ResultCache()
+    {
+        delete [] m_entries;
+    }
+    /**
+     * @brief Size of the entries
+     * @return size of the entries, in bytes.
+     */
+    qint64 byteSize() const
+    {
+        return m_bucketCount * WayCount * qint64(sizeof(Entry));
+    }
+    /**
+     * @brief Number of entries
+     * @return maximum number of results that can be stored.
+     */
+    int capacity() const
+    {
+        return m_bucketCount * WayCount;
+    }
+    /**
+     * @brief Find a result
+     * @param key key of the result.
+     * @param value value that is set to the result, if it is found.
+     * @return if the result is found.
+     */
+    bool find(quint64 key, T *value)
+    {
+        Entry *bucket = m_entries + (hash(key) & (m_bucketCount - 1)) * WayCount;
+        for (int i = 0; i < WayCount; i++) {
+            Entry &entry = bucket[i];
+            quint32 sequence = entry.sequence.load(std::memory_order_acquire);
+            if (sequence == 0 || (sequence & 1) || entry.key.load(std::memory_order_relaxed) != key) {
+                continue;
+            }
+
+            quint64 words[WordCount];
+            for (int j = 0; j < WordCount; j++) {
+                words[j] = entry.words[j].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (entry.sequence.load(std::memory_order_relaxed) != sequence) {
+                continue;
+            }
+
+            memcpy(value, words, sizeof(T));
+            entry.referenced.store(1, std::memory_order_relaxed);
+            m_hitCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        m_missCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    /**
+     * @brief Insert a result
+     *
+     * The result might not be inserted if another thread is
+     * writing in the same entry.
+     *
+     * @param key key of the result.
+     * @param value result.
+     */
+    void insert(quint64 key, const T &value)
+    {
+        const quint64 keyHash = hash(key);
+        Entry *bucket = m_entries + (keyHash & (m_bucketCount - 1)) * WayCount;
+
+        // Replace the same key or an empty entry first, otherwise the
+        // first entry that was not referenced since the last pass
+        Entry *victim = 0;
+        for (int i = 0; i < WayCount && !victim; i++) {
+            quint32 sequence = bucket[i].sequence.load(std::memory_order_relaxed);
+            if (sequence == 0 || bucket[i].key.load(std::memory_order_relaxed) == key) {
+                victim = &bucket[i];
+            }
+        }
+        const int start = int(keyHash >> 62);
+        for (int i = 0; i < 2 * WayCount && !victim; i++) {
+            Entry &entry = bucket[(start + i) % WayCount];
+            if (entry.referenced.exchange(0, std::memory_order_relaxed) == 0) {
+                victim = &entry;
+            }
+        }
+        if (!victim) {
+            victim = &bucket[start];
+        }
+
+        quint32 sequence = victim->sequence.load(std::memory_order_relaxed);
+        if ((sequence & 1) || !victim->sequence.compare_exchange_strong(sequence, sequence + 1,
+                                                                        std::memory_order_relaxed)) {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        quint64 words[WordCount] = {};
+        memcpy(words, &value, sizeof(T));
+        victim->key.store(key, std::memory_order_relaxed);
+        for (int j = 0; j < WordCount; j++) {
+            victim->words[j].store(words[j], std::memory_order_relaxed);
+        }
+        victim->referenced.store(0, std::memory_order_relaxed);
+        victim->sequence.store(sequence + 2, std::memory_order_release);
+    }
+    /**
+     * @brief Remove all the results and reset the counters
+     *
+     * This method should not be called while the cache is used
+     * by other threads.
+     */
+    void clear()
+    {
+        for (int i = 0; i < m_bucketCount * WayCount; i++) {
+            Entry &entry = m_entries[i];
+            entry.sequence.store(0, std::memory_order_relaxed);
+            entry.referenced.store(0, std::memory_order_relaxed);
+            entry.key.store(0, std::memory_order_relaxed);
+            for (int j = 0; j < WordCount; j++) {
+                entry.words[j].store(0, std::memory_order_relaxed);
+            }
+        }
+        m_hitCount.store(0, std::memory_order_relaxed);
+        m_missCount.store(0, std::memory_order_relaxed);
+    }
+    /**
+     * @brief Number of lookups that found a result
+     * @return number of lookups that found a result.
+     */
+    quint64 hitCount() const
+    {
+        return m_hitCount.load(std::memory_order_relaxed);
+    }
+    /**
+     * @brief Number of lookups that did not find a result
+     * @return number of lookups that did not find a result.
+     */
+    quint64 missCount() const
+    {
+        return m_missCount.load(std::memory_order_relaxed);
+    }
+private:
+    Q_DISABLE_COPY(ResultCache)
+    /**
+     * @internal
+     * @brief Number of 64-bit words used to store a value
+     */
+    static const int WordCount = (sizeof(T) + sizeof(quint64) - 1) / sizeof(quint64);
+    /**
+     * @internal
+     * @brief Entry of the cache
+     */
+    struct Entry
+    {
+        /**
+         * @internal
+         * @brief Sequence number, 0 for an empty entry, odd while the entry is written
+         */
+        std::atomic<quint32> sequence;
+        /**
+         * @internal
+         * @brief If the entry was found since the last pass of the CLOCK algorithm
+         */
+        std::atomic<quint32> referenced;
+        /**
+         * @internal
+         * @brief Key
+         */
+        std::atomic<quint64> key;
+        /**
+         * @internal
+         * @brief Value
+         */
+        std::atomic<quint64> words[WordCount];
+    };
+    /**
+     * @internal
+     * @brief Hash a key
+     *
+     * The bits of the key are mixed, as the bits of the masks
+     * of cards are not uniformly distributed. The lowest bits
+     * give the bucket of the key.
+     *
+     * @param key key.
+     * @return hash of the key.
+     */
+    static quint64 hash(quint64 key)
+    {
+        key ^= key >> 33;
+        key *= Q_UINT64_C(0xff51afd7ed558ccd);
+        key ^= key >> 33;
+        key *= Q_UINT64_C(0xc4ceb9fe1a85ec53);
+        key ^= key >> 33;
+        return key;
+    }
+    /**
+     * @internal
+     * @brief Number of buckets, a power of 2
+     */
+    int m_bucketCount;
+    /**
+     * @internal
+     * @brief Entries, bucket after bucket
+     */
+    Entry *m_entries;
+    /**
+     * @internal
+     * @brief Number of lookups that found a result
+     */
+    std::atomic<quint64> m_hitCount;
+    /**
+     * @internal
+     * @brief Number of lookups that did not find a result
+     */
+    std::atomic<quint64> m_missCount;
+};
+
+/**
+ * @brief Cache of the strengths of hands, mapped by the masks of the cards
+ */
+typedef ResultCache<quint16> EvaluationCache;
+
+#endif // RESULTCACHE_H
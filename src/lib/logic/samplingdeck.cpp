@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file samplingdeck.cpp
+ * @short Implementation of SamplingDeck
+ */
+
+#include "samplingdeck.h"
+#include "bitops.h"
+#include "randomgenerator.h"
+
+#if defined(Q_CC_GNU) && defined(Q_PROCESSOR_X86_64)
+#define SAMPLINGDECK_BMI2
+
+#include <immintrin.h>
+
+/**
+ * @internal
+ * @brief Get the index of the n-th bit that is set (BMI2)
+ *
+ * PDEP deposits the bit n on the n-th bit that is set in the mask.
+ *
+ * @param mask mask to check.
+ * @param n index of the bit among the bits that are set.
+ * @return index of the n-th bit that is set.
+ */
+__attribute__((target("bmi2")))
+static int selectBitBmi2(quint64 mask, int n)
+{
+    return __builtin_ctzll(_pdep_u64(Q_UINT64_C(1) << n, mask));
+}
+#endif
+
+/**
+ * @internal
+ * @brief Detect if the processor has a fast PDEP
+ *
+ * AMD processors before Zen 3 support BMI2, but PDEP is
+ * microcoded on them, and is slower than selectBit().
+ *
+ * @return if PDEP can be used.
+ */
+static bool detectBmi2()
+{
+#ifdef SAMPLINGDECK_BMI2
+    __builtin_cpu_init();
+    if (__builtin_cpu_is("amdfam15h") || __builtin_cpu_is("amdfam17h")) {
+        return false;
+    }
+    return __builtin_cpu_supports("bmi2");
+#else
+    return false;
+#endif
+}
+
+/**
+ * @internal
+ * @brief If PDEP is used to select the bits
+ */
+static const bool BIT_SELECT_BMI2 = detectBmi2();
+
+SamplingDeck::SamplingDeck(CardSet excludedCards)
+{
+    setExcludedCards(excludedCards);
+}
+
+CardSet SamplingDeck::excludedCards() const
+{
+    return CardSet(m_excludedCards);
+}
+
+void SamplingDeck::setExcludedCards(CardSet excludedCards)
+{
+    m_excludedCards = excludedCards.mask() & CardSet::FullMask;
+    reset();
+}
+
+CardSet SamplingDeck::cardSet() const
+{
+    return CardSet(m_cards);
+}
+
+int SamplingDeck::count() const
+{
+    return m_count;
+}
+
+bool SamplingDeck::isEmpty() const
+{
+    return m_count == 0;
+}
+
+void SamplingDeck::reset()
+{
+    m_cards = CardSet::FullMask & ~m_excludedCards;
+    m_count = bitCount(m_cards);
+}
+
+PackedCard SamplingDeck::draw(RandomGenerator &generator)
+{
+    Q_ASSERT(m_count > 0);
+    const int bit = selectBit(m_cards, generator.bounded(m_count));
+    m_cards &= ~(Q_UINT64_C(1) << bit);
+    m_count--;
+    return CardSet::cardAt(bit);
+}
+
+CardSet SamplingDeck::draw(RandomGenerator &generator, int count)
+{
+    quint64 cards = 0;
+    for (count = qMin(count, m_count); count > 0; count--) {
+        const int bit = selectBit(m_cards, generator.bounded(m_count));
+        cards |= Q_UINT64_C(1) << bit;
+        m_cards &= ~(Q_UINT64_C(1) << bit);
+        m_count--;
+    }
+    return CardSet(cards);
+}
+
+int SamplingDeck::selectBit(quint64 mask, int n)
+{
+#ifdef SAMPLINGDECK_BMI2
+    if (BIT_SELECT_BMI2) {
+        return selectBitBmi2(mask, n);
+    }
+#endif
+    return ::selectBit(mask, n);
+}
+
+bool SamplingDeck::isBitSelectAccelerated()
+{
+    return BIT_SELECT_BMI2;
+}
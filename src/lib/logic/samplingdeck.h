@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef SAMPLINGDECK_H
+#define SAMPLINGDECK_H
+
+/**
+ * @file samplingdeck.h
+ * @short Definition of SamplingDeck
+ */
+
+#include "pokqt_global.h"
+#include "cardset.h"
+
+class RandomGenerator;
+
+/**
+ * @brief Deck used to sample random cards
+ *
+ * Simulations deal random cards many times, excluding cards
+ * that are known, like the hole cards, the board, or the cards
+ * that are dead. This deck is only a mask of the remaining cards,
+ * so resetting it for a new trial, and drawing cards, do not
+ * allocate anything.
+ *
+ * A card is drawn by selecting a random bit of the mask. The
+ * bit is selected with the PDEP instruction on the processors
+ * where it is fast, and with selectBit() otherwise.
+ */
+class POKQTSHARED_EXPORT SamplingDeck
+{
+public:
+    /**
+     * @brief Default constructor
+     * @param excludedCards cards that are never drawn.
+     */
+    explicit SamplingDeck(CardSet excludedCards = CardSet());
+    /**
+     * @brief Get the excluded cards
+     * @return cards that are never drawn.
+     */
+    CardSet excludedCards() const;
+    /**
+     * @brief Set the excluded cards
+     *
+     * The deck is reset.
+     *
+     * @param excludedCards cards that are never drawn.
+     */
+    void setExcludedCards(CardSet excludedCards);
+    /**
+     * @brief Get the cards that can be drawn
+     * @return cards in the deck.
+     */
+    CardSet cardSet() const;
+    /**
+     * @brief Get the number of cards that can be drawn
+     * @return number of cards in the deck.
+     */
+    int count() const;
+    /**
+     * @brief Get if the deck is empty
+     * @return if the deck is empty.
+     */
+    bool isEmpty() const;
+    /**
+     * @brief Reset the deck
+     *
+     * All the cards that are not excluded can be drawn again.
+     */
+    void reset();
+    /**
+     * @brief Draw a card
+     *
+     * The deck should not be empty.
+     *
+     * @param generator random number generator.
+     * @return a card drawn uniformly among the cards in the deck.
+     */
+    PackedCard draw(RandomGenerator &generator);
+    /**
+     * @brief Draw several distinct cards
+     * @param generator random number generator.
+     * @param count number of cards to draw.
+     * @return the drawn cards, that are less than count if the deck is empty.
+     */
+    CardSet draw(RandomGenerator &generator, int count);
+    /**
+     * @brief Get the index of the n-th bit that is set in a mask
+     *
+     * This is the bit selection used to draw the cards, that uses
+     * PDEP when it is fast.
+     *
+     * @param mask mask to check.
+     * @param n index of the bit among the bits that are set.
+     * @return index of the n-th bit that is set.
+     */
+    static int selectBit(quint64 mask, int n);
+    /**
+     * @brief Check if the bit selection uses PDEP
+     * @return if the processor has a fast PDEP.
+     */
+    static bool isBitSelectAccelerated();
+private:
+    /**
+     * @internal
+     * @brief Excluded cards, as a mask
+     */
+    quint64 m_excludedCards;
+    /**
+     * @internal
+     * @brief Cards in the deck, as a mask
+     */
+    quint64 m_cards;
+    /**
+     * @internal
+     * @brief Number of cards in the deck
+     */
+    int m_count;
+};
+
+#endif // SAMPLINGDECK_H
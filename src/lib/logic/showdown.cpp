@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file showdown.cpp
+ * @short Implementation of Showdown
+ */
+
+#include "showdown.h"
+#include <QtCore/QtAlgorithms>
+#include "handevaluator.h"
+
+/**
+ * @internal
+ * @brief Compare hand indexes by strength
+ *
+ * Used to sort the indexes of the hands from the
+ * strongest to the weakest hand.
+ */
+class StrengthGreater
+{
+public:
+    /**
+     * @internal
+     * @brief Default constructor
+     * @param strengths strengths of the hands.
+     */
+    explicit StrengthGreater(const QVector<quint16> &strengths)
+        : m_strengths(strengths)
+    {
+    }
+    /**
+     * @internal
+     * @brief Compare two hands
+     * @param index1 index of the first hand.
+     * @param index2 index of the second hand.
+     * @return if the first hand is stronger than the second one.
+     */
+    bool operator()(int index1, int index2) const
+    {
+        return m_strengths.at(index1) > m_strengths.at(index2);
+    }
+private:
+    /**
+     * @internal
+     * @brief Strengths of the hands
+     */
+    const QVector<quint16> &m_strengths;
+};
+
+QList<QList<int> > Showdown::rank(const QList<CardSet> &hands)
+{
+    QVector<quint64> masks (hands.count());
+    for (int i = 0; i < hands.count(); i++) {
+        masks[i] = hands.at(i).mask();
+    }
+
+    QVector<quint16> strengths (hands.count());
+    HandEvaluator::evaluateBatch(masks.constData(), strengths.data(), hands.count());
+    return rank(strengths);
+}
+
+QList<QList<int> > Showdown::rank(const QVector<quint16> &strengths)
+{
+    // The sort is stable, so tied hands keep their order
+    QList<int> indexes;
+    for (int i = 0; i < strengths.count(); i++) {
+        indexes.append(i);
+    }
+    qStableSort(indexes.begin(), indexes.end(), StrengthGreater(strengths));
+
+    QList<QList<int> > groups;
+    for (int i = 0; i < indexes.count(); i++) {
+        int index = indexes.at(i);
+        if (i == 0 || strengths.at(index) != strengths.at(indexes.at(i - 1))) {
+            groups.append(QList<int>());
+        }
+        groups.last().append(index);
+    }
+    return groups;
+}
+
+QList<int> Showdown::splitPot(int pot, int winnerCount)
+{
+    QList<int> shares;
+    if (winnerCount <= 0) {
+        return shares;
+    }
+
+    int share = pot / winnerCount;
+    int remainder = pot % winnerCount;
+    for (int i = 0; i < winnerCount; i++) {
+        shares.append(i < remainder ? share + 1 : share);
+    }
+    return shares;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef SHOWDOWN_H
+#define SHOWDOWN_H
+
+/**
+ * @file showdown.h
+ * @short Definition of Showdown
+ */
+
+#include "pokqt_global.h"
+#include <QtCore/QList>
+#include <QtCore/QVector>
+#include "cardset.h"
+
+/**
+ * @brief Showdown
+ *
+ * This class ranks the hands of the players that are still
+ * in game at the end of a round, and computes how the pot
+ * is shared between the winners.
+ *
+ * Each hand is evaluated only once, with HandEvaluator, and
+ * hands that have the same strength are tied: they share
+ * the pot.
+ */
+class POKQTSHARED_EXPORT Showdown
+{
+public:
+    /**
+     * @brief Rank hands
+     *
+     * The hands are grouped by strength, the strongest group
+     * being the first one. Each group contains the indexes of
+     * the hands in the list, in increasing order, so the first
+     * group contains the winners.
+     *
+     * @param hands hands to rank.
+     * @return indexes of the hands, grouped by strength.
+     */
+    static QList<QList<int> > rank(const QList<CardSet> &hands);
+    /**
+     * @brief Rank hands that are already evaluated
+     *
+     * This method works like rank(const QList<CardSet> &), but
+     * uses strengths computed by HandEvaluator.
+     *
+     * @param strengths strengths of the hands to rank.
+     * @return indexes of the hands, grouped by strength.
+     */
+    static QList<QList<int> > rank(const QVector<quint16> &strengths);
+    /**
+     * @brief Rank hands of a game variant
+     *
+     * The hands are made of hole cards and of the board, and are
+     * evaluated with the rules of the variant, like OmahaRules,
+     * that decide how the hole cards and the board are combined.
+     *
+     * @param holeCards hole cards of the players.
+     * @param board cards of the board.
+     * @return indexes of the hands, grouped by strength.
+     */
+    template <typename Rules>
+    static QList<QList<int> > rank(const QList<CardSet> &holeCards, CardSet board)
+    {
+        QVector<quint16> strengths;
+        strengths.reserve(holeCards.count());
+        foreach (CardSet cards, holeCards) {
+            strengths.append(Rules::evaluate(cards, board));
+        }
+        return rank(strengths);
+    }
+    /**
+     * @brief Split a pot between winners
+     *
+     * Each winner gets the same share of the pot, and the tokens
+     * that cannot be split are given one by one to the first
+     * winners.
+     *
+     * @param pot number of tokens in the pot.
+     * @param winnerCount number of winners.
+     * @return the number of tokens won by each winner.
+     */
+    static QList<int> splitPot(int pot, int winnerCount);
+};
+
+#endif // SHOWDOWN_H
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+/**
+ * @file tableevaluator.cpp
+ * @short Implementation of TableEvaluator
+ */
+
+#include "tableevaluator.h"
+
+TableEvaluator::TableEvaluator()
+    : m_cache(0)
+{
+}
+
+void TableEvaluator::reset(int seatCount)
+{
+    m_board = CardSet();
+    m_holeCards.fill(CardSet(), seatCount);
+    m_masks.fill(0, seatCount);
+    m_strengths.fill(0, seatCount);
+    update();
+}
+
+int TableEvaluator::seatCount() const
+{
+    return m_holeCards.count();
+}
+
+CardSet TableEvaluator::holeCards(int seat) const
+{
+    return m_holeCards.at(seat);
+}
+
+void TableEvaluator::setHoleCards(int seat, CardSet cards)
+{
+    m_holeCards[seat] = cards;
+    m_masks[seat] = (cards | m_board).mask();
+    if (!m_cache || !m_cache->find(m_masks.at(seat), &m_strengths[seat])) {
+        m_strengths[seat] = HandEvaluator::evaluate(CardSet(m_masks.at(seat)));
+        if (m_cache) {
+            m_cache->insert(m_masks.at(seat), m_strengths.at(seat));
+        }
+    }
+}
+
+CardSet TableEvaluator::board() const
+{
+    return m_board;
+}
+
+void TableEvaluator::addBoardCards(CardSet cards)
+{
+    m_board |= cards;
+    update();
+}
+
+CardSet TableEvaluator::cards(int seat) const
+{
+    return CardSet(m_masks.at(seat));
+}
+
+quint16 TableEvaluator::strength(int seat) const
+{
+    return m_strengths.at(seat);
+}
+
+HandEvaluator::Category TableEvaluator::category(int seat) const
+{
+    return HandEvaluator::category(m_strengths.at(seat));
+}
+
+QVector<quint16> TableEvaluator::strengths() const
+{
+    return m_strengths;
+}
+
+EvaluationCache * TableEvaluator::cache() const
+{
+    return m_cache;
+}
+
+void TableEvaluator::setCache(EvaluationCache *cache)
+{
+    m_cache = cache;
+}
+
+void TableEvaluator::update()
+{
+    const quint64 board = m_board.mask();
+    for (int i = 0; i < m_holeCards.count(); i++) {
+        m_masks[i] = m_holeCards.at(i).mask() | board;
+    }
+
+    if (!m_cache) {
+        HandEvaluator::evaluateBatch(m_masks.constData(), m_strengths.data(), m_masks.count());
+        return;
+    }
+
+    // Only the hands that are not in the cache are evaluated
+    m_missingSeats.clear();
+    m_missingMasks.clear();
+    for (int i = 0; i < m_masks.count(); i++) {
+        if (!m_cache->find(m_masks.at(i), &m_strengths[i])) {
+            m_missingSeats.append(i);
+            m_missingMasks.append(m_masks.at(i));
+        }
+    }
+
+    m_missingStrengths.resize(m_missingMasks.count());
+    HandEvaluator::evaluateBatch(m_missingMasks.constData(), m_missingStrengths.data(),
+                                 m_missingMasks.count());
+    for (int i = 0; i < m_missingSeats.count(); i++) {
+        m_strengths[m_missingSeats.at(i)] = m_missingStrengths.at(i);
+        m_cache->insert(m_missingMasks.at(i), m_missingStrengths.at(i));
+    }
+}
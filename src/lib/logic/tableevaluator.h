@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef TABLEEVALUATOR_H
+#define TABLEEVALUATOR_H
+
+/**
+ * @file tableevaluator.h
+ * @short Definition of TableEvaluator
+ */
+
+#include "pokqt_global.h"
+#include <QtCore/QVector>
+#include "cardset.h"
+#include "handevaluator.h"
+#include "resultcache.h"
+
+/**
+ * @brief Incremental evaluator of the hands of a table
+ *
+ * This class keeps the hole cards of each seat of a table,
+ * the cards of the board, and the current strength of the
+ * hand of each seat.
+ *
+ * The strengths are updated when the hole cards are set and
+ * each time cards are added to the board, so that they are
+ * known at every street. Updating a seat only needs the union
+ * of its hole cards and of the board, and one evaluation, in
+ * constant time, and all the seats are updated in one batch.
+ */
+class POKQTSHARED_EXPORT TableEvaluator
+{
+public:
+    /**
+     * @brief Default constructor
+     *
+     * This constructor creates an evaluator without any seat.
+     */
+    TableEvaluator();
+    /**
+     * @brief Reset the evaluator
+     *
+     * The board is cleared, and the seats are created without
+     * any hole cards.
+     *
+     * @param seatCount number of seats.
+     */
+    void reset(int seatCount);
+    /**
+     * @brief Get the number of seats
+     * @return number of seats.
+     */
+    int seatCount() const;
+    /**
+     * @brief Get the hole cards of a seat
+     * @param seat index of the seat.
+     * @return hole cards of the seat.
+     */
+    CardSet holeCards(int seat) const;
+    /**
+     * @brief Set the hole cards of a seat
+     * @param seat index of the seat.
+     * @param cards hole cards of the seat.
+     */
+    void setHoleCards(int seat, CardSet cards);
+    /**
+     * @brief Get the board
+     * @return cards of the board.
+     */
+    CardSet board() const;
+    /**
+     * @brief Add cards to the board
+     * @param cards cards to add.
+     */
+    void addBoardCards(CardSet cards);
+    /**
+     * @brief Get the cards of a seat
+     * @param seat index of the seat.
+     * @return hole cards of the seat and cards of the board.
+     */
+    CardSet cards(int seat) const;
+    /**
+     * @brief Get the current strength of a seat
+     * @param seat index of the seat.
+     * @return strength of the seat, as computed by HandEvaluator.
+     */
+    quint16 strength(int seat) const;
+    /**
+     * @brief Get the current category of a seat
+     * @param seat index of the seat.
+     * @return category of the made hand of the seat.
+     */
+    HandEvaluator::Category category(int seat) const;
+    /**
+     * @brief Get the current strengths of all the seats
+     * @return strengths of the seats.
+     */
+    QVector<quint16> strengths() const;
+    /**
+     * @brief Get the cache of the strengths
+     * @return cache of the strengths, or 0 if there is no cache.
+     */
+    EvaluationCache * cache() const;
+    /**
+     * @brief Set the cache of the strengths
+     *
+     * The strengths are searched in the cache before being
+     * evaluated. The cache can be shared between several
+     * evaluators, even in different threads, and is not owned
+     * by the evaluator.
+     *
+     * @param cache cache of the strengths, or 0 to not use a cache.
+     */
+    void setCache(EvaluationCache *cache);
+private:
+    /**
+     * @internal
+     * @brief Update the strengths of all the seats
+     */
+    void update();
+    /**
+     * @internal
+     * @brief Cards of the board
+     */
+    CardSet m_board;
+    /**
+     * @internal
+     * @brief Hole cards of each seat
+     */
+    QVector<CardSet> m_holeCards;
+    /**
+     * @internal
+     * @brief Cards of each seat, as masks
+     */
+    QVector<quint64> m_masks;
+    /**
+     * @internal
+     * @brief Strength of each seat
+     */
+    QVector<quint16> m_strengths;
+    /**
+     * @internal
+     * @brief Cache of the strengths
+     */
+    EvaluationCache *m_cache;
+    /**
+     * @internal
+     * @brief Seats whose strength is not in the cache
+     */
+    QVector<int> m_missingSeats;
+    /**
+     * @internal
+     * @brief Cards of the seats whose strength is not in the cache, as masks
+     */
+    QVector<quint64> m_missingMasks;
+    /**
+     * @internal
+     * @brief Strengths of the seats whose strength is not in the cache
+     */
+    QVector<quint16> m_missingStrengths;
+};
+
+#endif // TABLEEVALUATOR_H
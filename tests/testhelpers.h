@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#ifndef TESTHELPERS_H
+#define TESTHELPERS_H
+
+/**
+ * @file testhelpers.h
+ * @short Helpers shared by the tests
+ */
+
+#include <cstring>
+#include <QtCore/QList>
+#include "logic/cardset.h"
+#include "logic/packedcard.h"
+
+/**
+ * @brief Build a list of cards from a string
+ *
+ * Cards are given as a string, like "Ah Kh 2c", using
+ * 23456789TJQKA for ranks and cdhs for suits. The order
+ * of the cards is kept.
+ */
+inline QList<PackedCard> cardListFromString(const char *string)
+{
+    static const char *ranks = "23456789TJQKA";
+    static const char *suits = "cdhs";
+    QList<PackedCard> cards;
+    for (const char *i = string; i[0] && i[1]; i += 3) {
+        int rank = strchr(ranks, i[0]) - ranks;
+        int suit = strchr(suits, i[1]) - suits;
+        cards.append(PackedCard((Card::Suit) (suit + 1), rank));
+        if (!i[2]) {
+            break;
+        }
+    }
+    return cards;
+}
+
+/**
+ * @brief Build a card set from a list of cards
+ *
+ * Cards are given as in cardListFromString().
+ */
+inline CardSet cardsFromString(const char *string)
+{
+    CardSet cards;
+    foreach (PackedCard card, cardListFromString(string)) {
+        cards.insert(card);
+    }
+    return cards;
+}
+
+#endif // TESTHELPERS_H
@@ -1,2 +1,6 @@
 TEMPLATE = subdirs
-SUBDIRS = tst_card tst_hand
+SUBDIRS = tst_bestfive tst_card tst_cardset tst_dealrecord tst_hand tst_equitycalculator tst_gamerules tst_handevaluator tst_handindexer tst_handkernels tst_handrange tst_omahaevaluator tst_outsanalyzer tst_preflopequitytable tst_randomgenerator tst_resultcache tst_samplingdeck tst_showdown tst_tableevaluator
+
+# The enumeration of all the 7-card hands takes a long time, so it
+# is only built when requested, with qmake CONFIG+=handvalidation
+CONFIG(handvalidation): SUBDIRS += tst_handvalidation
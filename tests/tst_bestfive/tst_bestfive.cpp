@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+#include "logic/bestfive.h"
+#include "testhelpers.h"
+
+/**
+ * @brief Get the cards of a BestFive as a list
+ */
+static QList<PackedCard> cardsOf(const BestFive &bestFive)
+{
+    QList<PackedCard> cards;
+    for (int i = 0; i < bestFive.count(); i++) {
+        cards.append(bestFive.at(i));
+    }
+    return cards;
+}
+
+class TstBestFive: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testBestFive() {
+        static const struct {
+            const char *hand;
+            HandEvaluator::Category category;
+            const char *expected;
+        } cases[] = {
+            {"Ah Kh Qh Jh Th 2c 2d", HandEvaluator::StraightFlush, "Ah Kh Qh Jh Th"},
+            {"Ah 2h 3h 4h 5h Kc Kd", HandEvaluator::StraightFlush, "5h 4h 3h 2h Ah"},
+            {"7h 7c 7s 7d 5h Kc Kd", HandEvaluator::Four, "7s 7h 7d 7c Kd"},
+            {"7h 7c 7s 5d 5h Kc Kd", HandEvaluator::FullHouse, "7s 7h 7c Kd Kc"},
+            {"7h 7c 7s 5d 5h 5c Kd", HandEvaluator::FullHouse, "7s 7h 7c 5h 5d"},
+            {"Ah 9h 7h 5h 2h 3h Kd", HandEvaluator::Flush, "Ah 9h 7h 5h 3h"},
+            {"9h 8h 7c 6h 5h 2h Kd", HandEvaluator::Flush, "9h 8h 6h 5h 2h"},
+            {"7s 6c 5h 4d 3d 3s 2c", HandEvaluator::Straight, "7s 6c 5h 4d 3s"},
+            {"Ah 2c 3h 4d 5s Kc Kd", HandEvaluator::Straight, "5s 4d 3h 2c Ah"},
+            {"7h 7c 7s 5d 4h Kc 2d", HandEvaluator::Three, "7s 7h 7c Kc 5d"},
+            {"7h 7c 5s 5d 4h 4c 2d", HandEvaluator::TwoPairs, "7h 7c 5s 5d 4h"},
+            {"7h 7c 5s 9d 4h Kc 2d", HandEvaluator::Pair, "7h 7c Kc 9d 5s"},
+            {"7h Tc 5s 9d 4h Kc 2d", HandEvaluator::HighCard, "Kc Tc 9d 7h 5s"},
+            // With less cards, all the cards are used
+            {"Ah Ac 2d", HandEvaluator::Pair, "Ah Ac 2d"},
+            {"", HandEvaluator::HighCard, ""}
+        };
+
+        for (unsigned int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            BestFive bestFive(cardsFromString(cases[i].hand));
+            QCOMPARE(bestFive.category(), cases[i].category);
+            QCOMPARE(cardsOf(bestFive), cardListFromString(cases[i].expected));
+        }
+    }
+    void testCombo() {
+        // Combos are extracted without kickers
+        CardSet cards = cardsFromString("7h 7c 7s 7d Kh Kc 2d");
+        QCOMPARE(cardsOf(BestFive::combo(cards, HandEvaluator::Four)),
+                 cardListFromString("7s 7h 7d 7c"));
+        QCOMPARE(cardsOf(BestFive::combo(cards, HandEvaluator::FullHouse)),
+                 cardListFromString("7s 7h 7d Kh Kc"));
+        QCOMPARE(cardsOf(BestFive::combo(cards, HandEvaluator::Three)),
+                 cardListFromString("7s 7h 7d"));
+        QCOMPARE(cardsOf(BestFive::combo(cards, HandEvaluator::TwoPairs)),
+                 cardListFromString("Kh Kc 7s 7h"));
+        QCOMPARE(cardsOf(BestFive::combo(cards, HandEvaluator::Pair)),
+                 cardListFromString("Kh Kc"));
+        QCOMPARE(cardsOf(BestFive::combo(cards, HandEvaluator::HighCard)),
+                 cardListFromString("Kh"));
+        QVERIFY(BestFive::combo(cards, HandEvaluator::Flush).isEmpty());
+        QVERIFY(BestFive::combo(cards, HandEvaluator::Straight).isEmpty());
+        QCOMPARE(BestFive::combo(cards, HandEvaluator::Flush).category(), HandEvaluator::Flush);
+
+        // The highest flush is extracted, even with more than 7 cards
+        cards = cardsFromString("Qc Jc 7c 5c 2c Kd Qd Jd 9d 3d");
+        QCOMPARE(cardsOf(BestFive::combo(cards, HandEvaluator::Flush)),
+                 cardListFromString("Kd Qd Jd 9d 3d"));
+
+        // As well as the highest straight flush
+        cards = cardsFromString("Ac 2c 3c 4c 5c 6d 7d 8d 9d Td");
+        QCOMPARE(cardsOf(BestFive::combo(cards, HandEvaluator::StraightFlush)),
+                 cardListFromString("Td 9d 8d 7d 6d"));
+    }
+    void testEvaluator() {
+        // The best five cards have the same strength than the hand
+        qsrand(42);
+        for (int i = 0; i < 10000; i++) {
+            int count = 5 + i % 3;
+            CardSet cards;
+            while (cards.count() < count) {
+                cards.insert(PackedCard(qrand() % PackedCard::CardCount));
+            }
+
+            BestFive bestFive(cards);
+            quint16 strength = HandEvaluator::evaluate(cards);
+            QCOMPARE(bestFive.count(), 5);
+            QCOMPARE(bestFive.category(), HandEvaluator::category(strength));
+            QVERIFY(cards.contains(bestFive.cardSet()));
+            QCOMPARE(bestFive.cardSet().count(), 5);
+            QCOMPARE(HandEvaluator::evaluate(bestFive.cardSet()), strength);
+        }
+    }
+};
+
+QTEST_MAIN(TstBestFive)
+#include "tst_bestfive.moc"
@@ -0,0 +1,25 @@
+QT += testlib
+CONFIG += c++11
+
+win32:DEFINES += POKQT_LIBRARY
+
+INCLUDEPATH=../../src/lib/ ../
+
+HEADERS += ../../src/lib/pokqt_global.h \
+    ../testhelpers.h \
+    ../../src/lib/logic/bestfive.h \
+    ../../src/lib/logic/bitops.h \
+    ../../src/lib/logic/card.h \
+    ../../src/lib/logic/cardset.h \
+    ../../src/lib/logic/packedcard.h \
+    ../../src/lib/logic/handevaluator.h \
+    ../../src/lib/logic/handkernels.h \
+    ../../src/lib/logic/ranktables.h
+
+SOURCES += ../../src/lib/logic/bestfive.cpp \
+    ../../src/lib/logic/card.cpp \
+    ../../src/lib/logic/cardset.cpp \
+    ../../src/lib/logic/packedcard.cpp \
+    ../../src/lib/logic/handevaluator.cpp \
+    ../../src/lib/logic/ranktables.cpp \
+    tst_bestfive.cpp
@@ -32,6 +32,7 @@
 #include <QtCore/QObject>
 #include <QtTest/QtTest>
 #include "logic/card.h"
+#include "logic/packedcard.h"
 
 class TstCard: public QObject
 {
@@ -86,6 +87,50 @@ private slots:
             }
         }
     }
+    void testPacked() {
+        // Packed cards can be created at compile time
+        Q_STATIC_ASSERT(PackedCard(Card::Spade, 12).index() == 51);
+        Q_STATIC_ASSERT(PackedCard(Card::Club, 0).index() == 0);
+        Q_STATIC_ASSERT(!PackedCard(Card::Invalid, 3).isValid());
+        Q_STATIC_ASSERT(!PackedCard(Card::Heart, 13).isValid());
+
+        QVERIFY(!PackedCard().isValid());
+        QVERIFY(!PackedCard(Card()).isValid());
+        QVERIFY(!PackedCard(52).isValid());
+        QVERIFY(PackedCard().toCard() == Card());
+
+        // Conversions should not loose any information
+        QList<Card> cards;
+        for (int i = 0; i < PackedCard::CardCount; i++) {
+            PackedCard packed (i);
+            QVERIFY(packed.isValid());
+            Card card = packed.toCard();
+            QVERIFY(card.isValid());
+            QVERIFY(PackedCard(card) == packed);
+            QVERIFY(packed.suit() == card.suit());
+            QVERIFY(packed.rank() == card.rank());
+            cards.append(card);
+        }
+
+        // Packed cards and cards share the same order
+        for (int i = 0; i < cards.count(); i++) {
+            for (int j = 0; j < cards.count(); j++) {
+                QVERIFY((cards.at(i) < cards.at(j)) == (PackedCard(cards.at(i)) < PackedCard(cards.at(j))));
+            }
+        }
+
+        // Serialization
+        QByteArray data;
+        QDataStream stream (&data, QIODevice::WriteOnly);
+        stream << PackedCard(Card::Diamond, 4) << PackedCard();
+        QCOMPARE(data.size(), 2);
+        QDataStream readStream (data);
+        PackedCard card1;
+        PackedCard card2 (0);
+        readStream >> card1 >> card2;
+        QVERIFY(card1 == PackedCard(Card::Diamond, 4));
+        QVERIFY(!card2.isValid());
+    }
 };
 
 QTEST_MAIN(TstCard)
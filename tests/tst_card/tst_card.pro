@@ -1,11 +1,14 @@
 QT += testlib
+CONFIG += c++11
 
 win32:DEFINES += POKQT_LIBRARY
 
 INCLUDEPATH=../../src/lib/
 
 HEADERS += ../../src/lib/pokqt_global.h \
-    ../../src/lib/logic/card.h
+    ../../src/lib/logic/card.h \
+    ../../src/lib/logic/packedcard.h
 
 SOURCES += ../../src/lib/logic/card.cpp \
+    ../../src/lib/logic/packedcard.cpp \
     tst_card.cpp
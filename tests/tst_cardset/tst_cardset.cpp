@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+#include "logic/cardset.h"
+#include "logic/deck.h"
+#include "logic/hand.h"
+
+class TstCardSet: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testBasics() {
+        CardSet cards;
+        QVERIFY(cards.isEmpty());
+        QCOMPARE(cards.count(), 0);
+        QVERIFY(!cards.first().isValid());
+
+        cards.insert(PackedCard(Card::Heart, 12));
+        cards.insert(PackedCard(Card::Club, 3));
+        cards.insert(PackedCard());
+        QCOMPARE(cards.count(), 2);
+        QVERIFY(cards.contains(PackedCard(Card::Heart, 12)));
+        QVERIFY(cards.contains(PackedCard(Card::Club, 3)));
+        QVERIFY(!cards.contains(PackedCard(Card::Spade, 12)));
+        QVERIFY(!cards.contains(PackedCard()));
+
+        // Clubs are in the lowest block
+        QVERIFY(cards.first() == PackedCard(Card::Club, 3));
+
+        cards.remove(PackedCard(Card::Club, 3));
+        QCOMPARE(cards.count(), 1);
+        QVERIFY(cards.takeFirst() == PackedCard(Card::Heart, 12));
+        QVERIFY(cards.isEmpty());
+
+        // Bits that are not cards are ignored
+        QVERIFY(CardSet(~Q_UINT64_C(0)) == CardSet::fullDeck());
+        QCOMPARE(CardSet::fullDeck().count(), 52);
+    }
+    void testAlgebra() {
+        CardSet first;
+        first.insert(PackedCard(Card::Spade, 0));
+        first.insert(PackedCard(Card::Spade, 1));
+        CardSet second;
+        second.insert(PackedCard(Card::Spade, 1));
+        second.insert(PackedCard(Card::Diamond, 1));
+
+        QCOMPARE((first | second).count(), 3);
+        QVERIFY((first & second) == CardSet(PackedCard(Card::Spade, 1)));
+        QVERIFY((first - second) == CardSet(PackedCard(Card::Spade, 0)));
+        QVERIFY(first.intersects(second));
+        QVERIFY(!(first - second).intersects(second));
+        QVERIFY((first | second).contains(first));
+        QVERIFY(!first.contains(second));
+        QCOMPARE((~first).count(), 50);
+        QVERIFY(!(~first).intersects(first));
+
+        CardSet third = first;
+        third |= second;
+        QVERIFY(third == (first | second));
+        third -= second;
+        QVERIFY(third == (first - second));
+        third &= second;
+        QVERIFY(third.isEmpty());
+    }
+    void testMasks() {
+        CardSet cards;
+        cards.insert(PackedCard(Card::Spade, 12));
+        cards.insert(PackedCard(Card::Spade, 0));
+        cards.insert(PackedCard(Card::Heart, 5));
+        cards.insert(PackedCard(Card::Club, 5));
+
+        QCOMPARE(cards.suitMask(Card::Spade), quint16(0x1001));
+        QCOMPARE(cards.suitMask(3), quint16(0x1001));
+        QCOMPARE(cards.suitMask(Card::Heart), quint16(0x20));
+        QCOMPARE(cards.suitMask(Card::Diamond), quint16(0));
+        QCOMPARE(cards.suitMask(Card::Club), quint16(0x20));
+        QCOMPARE(cards.suitMask(Card::Invalid), quint16(0));
+        QCOMPARE(cards.rankMask(), quint16(0x1021));
+    }
+    void testIteration() {
+        // Each card has its own bit
+        CardSet all;
+        for (int i = 0; i < PackedCard::CardCount; i++) {
+            PackedCard card (i);
+            QVERIFY(CardSet::cardAt(CardSet::cardBit(card)) == card);
+            QVERIFY(!all.contains(card));
+            all.insert(card);
+        }
+        QVERIFY(all == CardSet::fullDeck());
+
+        int count = 0;
+        int previousBit = -1;
+        foreach (PackedCard card, all) {
+            QVERIFY(CardSet::cardBit(card) > previousBit);
+            previousBit = CardSet::cardBit(card);
+            count++;
+        }
+        QCOMPARE(count, 52);
+    }
+    void testConversions() {
+        QList<Card> cards;
+        cards << Card(Card::Club, 2) << Card(Card::Heart, 11) << Card(Card::Spade, 0) << Card();
+
+        CardSet set (cards);
+        QCOMPARE(set.count(), 3);
+        QList<Card> converted = set.toList();
+        QCOMPARE(converted.count(), 3);
+        foreach (const Card &card, converted) {
+            QVERIFY(cards.contains(card));
+        }
+
+        Hand hand;
+        hand.addCards(cards);
+        QVERIFY(hand.cardSet() == set);
+
+        Deck deck;
+        deck.reset();
+        QVERIFY(deck.cardSet() == CardSet::fullDeck());
+        Card card = deck.draw();
+        QVERIFY(deck.cardSet() == CardSet::fullDeck() - CardSet(PackedCard(card)));
+
+        // Draw into a buffer, then put the cards back
+        Card buffer[52];
+        QCOMPARE(deck.draw(buffer, 10), 10);
+        QCOMPARE(deck.count(), 41);
+        QCOMPARE(buffer[0], Card(Card::Spade, 1));
+        QCOMPARE(deck.draw(buffer, 52), 41);
+        QVERIFY(deck.isEmpty());
+        QCOMPARE(deck.draw(), Card());
+        deck.rewind();
+        QCOMPARE(deck.count(), 52);
+        QVERIFY(deck.cardSet() == CardSet::fullDeck());
+        QCOMPARE(deck.draw(), card);
+    }
+};
+
+QTEST_MAIN(TstCardSet)
+#include "tst_cardset.moc"
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+#include "logic/dealrecord.h"
+#include "logic/deck.h"
+#include "logic/randomgenerator.h"
+
+class TstDealRecord: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testRecord() {
+        DealRecord record;
+        QVERIFY(record.isEmpty());
+        QVERIFY(record.append(PackedCard(Card::Heart, 12)));
+        QVERIFY(record.append(PackedCard(Card::Club, 0)));
+        QVERIFY(!record.append(PackedCard(Card::Heart, 12)));
+        QVERIFY(!record.append(PackedCard()));
+        QCOMPARE(record.count(), 2);
+        QCOMPARE(record.at(0), PackedCard(Card::Heart, 12));
+        QCOMPARE(record.at(1), PackedCard(Card::Club, 0));
+        QCOMPARE(record.toList(), QList<Card>() << Card(Card::Heart, 12) << Card(Card::Club, 0));
+        QCOMPARE(record.cardSet().count(), 2);
+
+        // One byte per card
+        QByteArray data = record.toByteArray();
+        QCOMPARE(data.size(), 2);
+        QVERIFY(DealRecord::fromByteArray(data) == record);
+
+        // Invalid data gives an empty record
+        QByteArray duplicated = data;
+        duplicated.append(data.at(0));
+        QVERIFY(DealRecord::fromByteArray(duplicated).isEmpty());
+        QByteArray invalid = data;
+        invalid.append(char(PackedCard::CardCount));
+        QVERIFY(DealRecord::fromByteArray(invalid).isEmpty());
+
+        record.clear();
+        QVERIFY(record.isEmpty());
+        QVERIFY(record != DealRecord::fromByteArray(data));
+    }
+    void testReplay() {
+        // Record a shuffled deal
+        XoshiroGenerator generator (42);
+        Deck deck;
+        deck.reset();
+        deck.shuffle(&generator);
+        QList<Card> dealt;
+        for (int i = 0; i < 17; i++) {
+            dealt.append(deck.draw());
+        }
+        DealRecord record = deck.dealRecord();
+        QCOMPARE(record.toList(), dealt);
+
+        // The recorded cards are dealt again, even after a new shuffle
+        deck.rewind();
+        deck.shuffle(&generator);
+        deck.draw();
+        deck.replay(DealRecord::fromByteArray(record.toByteArray()));
+        QCOMPARE(deck.count(), 52);
+        for (int i = 0; i < dealt.count(); i++) {
+            QCOMPARE(deck.draw(), dealt.at(i));
+        }
+        QCOMPARE(deck.dealRecord(), record);
+
+        // The other cards can still be dealt
+        QCOMPARE(deck.count(), 35);
+        QCOMPARE(deck.cardSet(), CardSet::fullDeck() - record.cardSet());
+
+        // Also for decks shuffled with the secure generator
+        deck.setShuffleMode(Deck::SecureShuffle);
+        deck.rewind();
+        deck.shuffle(&generator);
+        for (int i = 0; i < 9; i++) {
+            deck.draw();
+        }
+        record = deck.dealRecord();
+        deck.replay(record);
+        for (int i = 0; i < 9; i++) {
+            QCOMPARE(PackedCard(deck.draw()), record.at(i));
+        }
+    }
+};
+
+QTEST_MAIN(TstDealRecord)
+#include "tst_dealrecord.moc"
@@ -0,0 +1,492 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+#include "logic/equitycalculator.h"
+#include "logic/gamerules.h"
+#include "logic/rangeequitycalculator.h"
+#include "logic/showdown.h"
+#include "testhelpers.h"
+
+
+class TstEquityCalculator: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testValidity() {
+        EquityCalculator calculator;
+        QVERIFY(!calculator.isValid());
+        QVERIFY(!calculator.calculate());
+
+        // A single player
+        calculator.setPlayers(QList<CardSet>() << cardsFromString("Ah Ad"));
+        QVERIFY(!calculator.isValid());
+
+        // A player with 1 card
+        calculator.setPlayers(QList<CardSet>() << cardsFromString("Ah Ad") << cardsFromString("Kh"));
+        QVERIFY(!calculator.isValid());
+
+        // The same card is used twice
+        calculator.setPlayers(QList<CardSet>() << cardsFromString("Ah Ad") << cardsFromString("Ah Kh"));
+        QVERIFY(!calculator.isValid());
+        calculator.setPlayers(QList<CardSet>() << cardsFromString("Ah Ad") << cardsFromString("Kh Kd"));
+        QVERIFY(calculator.isValid());
+        calculator.setBoard(cardsFromString("Kh 2c 3c"));
+        QVERIFY(!calculator.isValid());
+        calculator.setBoard(cardsFromString("4c 2c 3c"));
+        calculator.setDeadCards(cardsFromString("Ad"));
+        QVERIFY(!calculator.isValid());
+
+        // Too many cards on the board
+        calculator.setDeadCards(CardSet());
+        calculator.setBoard(cardsFromString("4c 2c 3c 5c 6c 7c"));
+        QVERIFY(!calculator.isValid());
+    }
+    void testKnownBoard() {
+        // With a complete board, the results are exact
+        EquityCalculator calculator;
+        calculator.setPlayers(QList<CardSet>() << cardsFromString("Ah Ad") << cardsFromString("Kh Kd")
+                              << cardsFromString("2s 3s"));
+        calculator.setBoard(cardsFromString("Ks 7c 8d Qs Jh"));
+        calculator.setMaximumTrialCount(10000);
+        QVERIFY(calculator.calculate());
+        QCOMPARE(calculator.trialCount(), qint64(10000));
+
+        QList<Equity> results = calculator.results();
+        QCOMPARE(results.count(), 3);
+        QCOMPARE(results.at(0).equity(), 0.);
+        QCOMPARE(results.at(1).win(), 1.);
+        QCOMPARE(results.at(1).equity(), 1.);
+        QCOMPARE(results.at(1).error(), 0.);
+        QCOMPARE(results.at(2).equity(), 0.);
+
+        // Everybody plays the board
+        calculator.setPlayers(QList<CardSet>() << cardsFromString("2h 3d") << cardsFromString("2c 3c"));
+        calculator.setBoard(cardsFromString("As Ks Qs Js Ts"));
+        QVERIFY(calculator.calculate());
+        results = calculator.results();
+        QCOMPARE(results.at(0).tie(), 1.);
+        QCOMPARE(results.at(0).equity(), 0.5);
+        QCOMPARE(results.at(1).equity(), 0.5);
+    }
+    void testPreflop() {
+        // Aces against kings, without common suits, have an equity of 81.26%
+        EquityCalculator calculator;
+        calculator.setPlayers(QList<CardSet>() << cardsFromString("Ah Ad") << cardsFromString("Ks Kc"));
+        calculator.setMaximumTrialCount(200000);
+        QVERIFY(calculator.calculate());
+        QList<Equity> results = calculator.results();
+        QVERIFY(qAbs(results.at(0).equity() - 0.8126) < 0.01);
+        QVERIFY(qAbs(results.at(0).equity() + results.at(1).equity() - 1) < 1e-9);
+        QVERIFY(results.at(0).error() > 0 && results.at(0).error() < 0.005);
+
+        // Aces against a random hand win about 85% of the time
+        calculator.setPlayers(QList<CardSet>() << cardsFromString("Ah Ad") << CardSet());
+        QVERIFY(calculator.calculate());
+        results = calculator.results();
+        QVERIFY(qAbs(results.at(0).equity() - 0.852) < 0.01);
+    }
+    void testDeterminism() {
+        // Without target error, the results do not depend on the threads
+        EquityCalculator calculator;
+        calculator.setPlayers(QList<CardSet>() << cardsFromString("Ah Kh") << CardSet() << CardSet());
+        calculator.setBoard(cardsFromString("Qh 7c 2h"));
+        calculator.setMaximumTrialCount(50000);
+        calculator.setSeed(1234);
+        calculator.setThreadCount(1);
+        QVERIFY(calculator.calculate());
+        QList<Equity> results1 = calculator.results();
+        calculator.setThreadCount(4);
+        QVERIFY(calculator.calculate());
+        QList<Equity> results2 = calculator.results();
+        for (int i = 0; i < 3; i++) {
+            QCOMPARE(results1.at(i).win(), results2.at(i).win());
+            QCOMPARE(results1.at(i).tie(), results2.at(i).tie());
+            QCOMPARE(results1.at(i).equity(), results2.at(i).equity());
+        }
+    }
+    void testExact() {
+        // Aces against kings, compared with a full enumeration
+        EquityCalculator calculator;
+        calculator.setPlayers(QList<CardSet>() << cardsFromString("Ah Ad") << cardsFromString("Ks Kc"));
+        QVERIFY(calculator.calculateExact());
+        QVERIFY(calculator.isExact());
+        QCOMPARE(calculator.trialCount(), qint64(1712304));
+        QList<Equity> results = calculator.results();
+        QVERIFY(qAbs(results.at(0).equity() - 0.81255) < 0.00001);
+        QCOMPARE(results.at(0).error(), 0.);
+
+        // Unknown cards can't be enumerated
+        calculator.setPlayers(QList<CardSet>() << cardsFromString("Ah Ad") << CardSet());
+        QVERIFY(!calculator.calculateExact());
+
+        // Compare some flops and turns with a simple enumeration
+        QList<QList<CardSet> > hands;
+        QList<CardSet> boards;
+        hands << (QList<CardSet>() << cardsFromString("Ah Kh") << cardsFromString("Qs Qd"));
+        boards << cardsFromString("2h 7h Tc");
+        hands << (QList<CardSet>() << cardsFromString("Ah Kh") << cardsFromString("As Ks")
+                  << cardsFromString("7c 8c"));
+        boards << cardsFromString("2d 3d 9d");
+        hands << (QList<CardSet>() << cardsFromString("Jc Tc") << cardsFromString("Ad Kd")
+                  << cardsFromString("9s 9h"));
+        boards << cardsFromString("2c 3c 4c Qd");
+        hands << (QList<CardSet>() << cardsFromString("2c 2d") << cardsFromString("3c 3d"));
+        boards << CardSet();
+
+        for (int i = 0; i < hands.count(); i++) {
+            const QList<CardSet> &players = hands.at(i);
+            CardSet used = boards.at(i);
+            foreach (CardSet player, players) {
+                used |= player;
+            }
+
+            // Only check the flops and turns with a full enumeration
+            QList<double> equities;
+            qint64 boardCount = 0;
+            if (boards.at(i).count() >= 3) {
+                for (int j = 0; j < players.count(); j++) {
+                    equities.append(0);
+                }
+                QList<PackedCard> available;
+                foreach (PackedCard card, ~used) {
+                    available.append(card);
+                }
+                QList<CardSet> runouts;
+                for (int first = 0; first < available.count(); first++) {
+                    if (boards.at(i).count() == 4) {
+                        runouts.append(CardSet(available.at(first)));
+                        continue;
+                    }
+                    for (int second = first + 1; second < available.count(); second++) {
+                        runouts.append(CardSet(available.at(first)) | CardSet(available.at(second)));
+                    }
+                }
+
+                foreach (CardSet runout, runouts) {
+                    QList<CardSet> hands;
+                    foreach (CardSet player, players) {
+                        hands.append(player | boards.at(i) | runout);
+                    }
+                    QList<int> winners = Showdown::rank(hands).first();
+                    foreach (int winner, winners) {
+                        equities[winner] += 1. / winners.count();
+                    }
+                    boardCount++;
+                }
+            }
+
+            calculator.setPlayers(players);
+            calculator.setBoard(boards.at(i));
+            calculator.setThreadCount(1);
+            QVERIFY(calculator.calculateExact());
+            QList<Equity> results = calculator.results();
+            qint64 trialCount = calculator.trialCount();
+            calculator.setThreadCount(4);
+            QVERIFY(calculator.calculateExact());
+            QCOMPARE(calculator.trialCount(), trialCount);
+
+            double total = 0;
+            for (int j = 0; j < players.count(); j++) {
+                QCOMPARE(calculator.results().at(j).equity(), results.at(j).equity());
+                total += results.at(j).equity();
+                if (!equities.isEmpty()) {
+                    QCOMPARE(trialCount, boardCount);
+                    QVERIFY(qAbs(results.at(j).equity() - equities.at(j) / boardCount) < 1e-12);
+                }
+            }
+            QVERIFY(qAbs(total - 1) < 1e-12);
+        }
+    }
+    void testOmaha() {
+        EquityCalculator calculator;
+        QCOMPARE(calculator.variant(), EquityCalculator::Holdem);
+        calculator.setVariant(EquityCalculator::Omaha);
+        QCOMPARE(calculator.variant(), EquityCalculator::Omaha);
+
+        // Players have four hole cards
+        calculator.setPlayers(QList<CardSet>() << cardsFromString("Ah Ad") << cardsFromString("Ks Kc"));
+        QVERIFY(!calculator.isValid());
+        QList<CardSet> players;
+        players << cardsFromString("Ah Ad Kh 2c") << cardsFromString("Qs Js Ts 9d");
+        calculator.setPlayers(players);
+        QVERIFY(calculator.isValid());
+        calculator.setPlayers(QList<CardSet>() << players << CardSet());
+        QVERIFY(calculator.isValid());
+
+        // Compare the turns of a flop with a simple enumeration
+        CardSet board = cardsFromString("As 8s 2d");
+        CardSet used = board | players.at(0) | players.at(1);
+        double equity = 0;
+        qint64 boardCount = 0;
+        QList<PackedCard> available;
+        foreach (PackedCard card, ~used) {
+            available.append(card);
+        }
+        for (int first = 0; first < available.count(); first++) {
+            for (int second = first + 1; second < available.count(); second++) {
+                CardSet runout = board | CardSet(available.at(first)) | CardSet(available.at(second));
+                QList<int> winners = Showdown::rank<OmahaRules>(players, runout).first();
+                if (winners.contains(0)) {
+                    equity += 1. / winners.count();
+                }
+                boardCount++;
+            }
+        }
+
+        calculator.setPlayers(players);
+        calculator.setBoard(board);
+        QVERIFY(calculator.calculateExact());
+        QCOMPARE(calculator.trialCount(), boardCount);
+        QVERIFY(qAbs(calculator.results().at(0).equity() - equity / boardCount) < 1e-12);
+
+        // The simulation agrees with the exact equity
+        calculator.setSeed(7);
+        calculator.setMaximumTrialCount(200000);
+        QVERIFY(calculator.calculate());
+        Equity estimate = calculator.results().at(0);
+        QVERIFY(qAbs(estimate.equity() - equity / boardCount) < 2 * estimate.error());
+    }
+    void testEarlyStop() {
+        EquityCalculator calculator;
+        calculator.setPlayers(QList<CardSet>() << cardsFromString("Ah Kh") << cardsFromString("Qs Qd"));
+        calculator.setMaximumTrialCount(10000000);
+        calculator.setTargetError(0.01);
+        QVERIFY(calculator.calculate());
+        QVERIFY(calculator.trialCount() < 1000000);
+        foreach (const Equity &equity, calculator.results()) {
+            QVERIFY(equity.error() <= 0.01);
+        }
+    }
+    void testRangeValidity() {
+        HandRange aces;
+        QVERIFY(aces.parse("AA"));
+        HandRange kings;
+        QVERIFY(kings.parse("KK"));
+
+        RangeEquityCalculator calculator;
+        QVERIFY(!calculator.isValid());
+        calculator.setRanges(QList<HandRange>() << aces);
+        QVERIFY(!calculator.isValid());
+        calculator.setRanges(QList<HandRange>() << aces << kings);
+        QVERIFY(calculator.isValid());
+
+        // A range without any combo left is invalid
+        calculator.setDeadCards(cardsFromString("Ks Kh Kd"));
+        QVERIFY(!calculator.isValid());
+        QVERIFY(!calculator.calculate());
+        calculator.setDeadCards(CardSet());
+        calculator.setRanges(QList<HandRange>() << aces << HandRange());
+        QVERIFY(!calculator.isValid());
+
+        // Ranges that can never be dealt together have no results
+        HandRange combo;
+        QVERIFY(combo.parse("AhKh"));
+        EquityCache cache;
+        calculator.setCache(&cache);
+        calculator.setRanges(QList<HandRange>() << combo << combo);
+        QVERIFY(calculator.isValid());
+        QVERIFY(!calculator.calculate());
+        QVERIFY(calculator.results().isEmpty());
+        QVERIFY(!calculator.calculate());
+        QCOMPARE(cache.hitCount(), quint64(0));
+        QCOMPARE(cache.missCount(), quint64(2));
+
+        calculator.setCache(0);
+        HandRange suited;
+        QVERIFY(suited.parse("AKs"));
+        HandRange blocker;
+        QVERIFY(blocker.parse("AhAs"));
+        calculator.setRanges(QList<HandRange>() << suited << blocker);
+        calculator.setDeadCards(cardsFromString("Ac Ad"));
+        QVERIFY(calculator.isValid());
+        QVERIFY(!calculator.calculate());
+        QVERIFY(calculator.results().isEmpty());
+    }
+    void testRange() {
+        // Ranges are compared with the average of the exact
+        // equities of all the pairs of combos
+        QList<QStringList> ranges;
+        QList<CardSet> boards;
+        ranges << (QStringList() << "AhKh" << "QsQd");
+        boards << cardsFromString("2h 7h Tc");
+        ranges << (QStringList() << "AKs, QQ:0.5, 76s" << "JJ+, AQo:0.25");
+        boards << cardsFromString("Ah 7c 2d");
+        ranges << (QStringList() << "TT-QQ" << "AK" << "98s");
+        boards << cardsFromString("9c Td 2s Kh");
+
+        for (int i = 0; i < ranges.count(); i++) {
+            QList<HandRange> handRanges;
+            foreach (const QString &text, ranges.at(i)) {
+                HandRange range;
+                QVERIFY(range.parse(text));
+                handRanges.append(range.removeCards(boards.at(i)));
+            }
+
+            QList<double> equities;
+            for (int j = 0; j < handRanges.count(); j++) {
+                equities.append(0);
+            }
+            // Only the combos with a weight are enumerated
+            QList<QList<int> > combos;
+            foreach (const HandRange &range, handRanges) {
+                QList<int> rangeCombos;
+                for (int j = 0; j < HandRange::ComboCount; j++) {
+                    if (range.weight(j) > 0) {
+                        rangeCombos.append(j);
+                    }
+                }
+                combos.append(rangeCombos);
+            }
+
+            double totalWeight = 0;
+            QList<int> indexes;
+            for (int j = 0; j < handRanges.count(); j++) {
+                indexes.append(0);
+            }
+            EquityCalculator exactCalculator;
+            exactCalculator.setBoard(boards.at(i));
+            exactCalculator.setThreadCount(1);
+            while (indexes.last() < combos.last().count()) {
+                QList<CardSet> players;
+                CardSet used;
+                double weight = 1;
+                for (int j = 0; j < handRanges.count(); j++) {
+                    int combo = combos.at(j).at(indexes.at(j));
+                    CardSet cards = HandRange::comboCards(combo);
+                    weight *= handRanges.at(j).weight(combo);
+                    if (!(used & cards).isEmpty()) {
+                        weight = 0;
+                    }
+                    used |= cards;
+                    players.append(cards);
+                }
+                if (weight > 0) {
+                    exactCalculator.setPlayers(players);
+                    QVERIFY(exactCalculator.calculateExact());
+                    for (int j = 0; j < handRanges.count(); j++) {
+                        equities[j] += weight * exactCalculator.results().at(j).equity();
+                    }
+                    totalWeight += weight;
+                }
+
+                int j = 0;
+                indexes[j]++;
+                while (j < handRanges.count() - 1 && indexes.at(j) == combos.at(j).count()) {
+                    indexes[j] = 0;
+                    j++;
+                    indexes[j]++;
+                }
+            }
+
+            RangeEquityCalculator calculator;
+            calculator.setRanges(handRanges);
+            calculator.setBoard(boards.at(i));
+            calculator.setThreadCount(1);
+            QVERIFY(calculator.calculate());
+            QVERIFY(calculator.isExact());
+            QList<Equity> results = calculator.results();
+            calculator.setThreadCount(4);
+            QVERIFY(calculator.calculate());
+
+            double total = 0;
+            for (int j = 0; j < handRanges.count(); j++) {
+                QCOMPARE(calculator.results().at(j).equity(), results.at(j).equity());
+                QVERIFY(qAbs(results.at(j).equity() - equities.at(j) / totalWeight) < 1e-9);
+                total += results.at(j).equity();
+            }
+            QVERIFY(qAbs(total - 1) < 1e-9);
+        }
+    }
+    void testRangePreflop() {
+        // All aces against all kings, sampling boards
+        HandRange aces;
+        QVERIFY(aces.parse("AA"));
+        HandRange kings;
+        QVERIFY(kings.parse("KK"));
+
+        RangeEquityCalculator calculator;
+        calculator.setRanges(QList<HandRange>() << aces << kings);
+        calculator.setSeed(42);
+        calculator.setThreadCount(1);
+        QVERIFY(calculator.calculate());
+        QVERIFY(!calculator.isExact());
+        QCOMPARE(calculator.boardCount(), qint64(20000));
+        QList<Equity> results = calculator.results();
+        QVERIFY(qAbs(results.at(0).equity() - 0.8195) < 0.015);
+        QVERIFY(results.at(0).error() > 0 && results.at(0).error() < 0.01);
+
+        // The results don't depend on the number of threads
+        calculator.setThreadCount(4);
+        QVERIFY(calculator.calculate());
+        for (int i = 0; i < results.count(); i++) {
+            QCOMPARE(calculator.results().at(i).win(), results.at(i).win());
+            QCOMPARE(calculator.results().at(i).equity(), results.at(i).equity());
+        }
+    }
+    void testRangeCache() {
+        HandRange first;
+        QVERIFY(first.parse("AKs, QQ+"));
+        HandRange second;
+        QVERIFY(second.parse("JJ+, AQo"));
+
+        EquityCache cache;
+        RangeEquityCalculator calculator;
+        calculator.setRanges(QList<HandRange>() << first << second);
+        calculator.setBoard(cardsFromString("Ah 7c 2d"));
+        QVERIFY(calculator.calculate());
+        QList<Equity> results = calculator.results();
+
+        calculator.setCache(&cache);
+        QCOMPARE(calculator.cache(), &cache);
+        QVERIFY(calculator.calculate());
+        QCOMPARE(cache.missCount(), quint64(1));
+        QVERIFY(calculator.calculate());
+        QCOMPARE(cache.hitCount(), quint64(1));
+        QVERIFY(calculator.isExact());
+        QCOMPARE(calculator.results().count(), 2);
+        for (int i = 0; i < 2; i++) {
+            QVERIFY(qAbs(calculator.results().at(i).win() - results.at(i).win()) < 1e-12);
+            QVERIFY(qAbs(calculator.results().at(i).tie() - results.at(i).tie()) < 1e-12);
+            QVERIFY(qAbs(calculator.results().at(i).equity() - results.at(i).equity()) < 1e-12);
+        }
+
+        // Other parameters are not found
+        calculator.setBoard(cardsFromString("Ah 7c Qd"));
+        QVERIFY(calculator.calculate());
+        QCOMPARE(cache.missCount(), quint64(2));
+        QVERIFY(calculator.results().at(0).equity() != results.at(0).equity());
+    }
+};
+
+QTEST_MAIN(TstEquityCalculator)
+#include "tst_equitycalculator.moc"
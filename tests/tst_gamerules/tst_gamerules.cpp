@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+#include "logic/deck.h"
+#include "logic/gamerules.h"
+#include "testhelpers.h"
+
+/**
+ * @brief Evaluate a short-deck hand
+ */
+static quint16 shortDeck(const char *holeCards, const char *board)
+{
+    return ShortDeckRules::evaluate(cardsFromString(holeCards), cardsFromString(board));
+}
+
+/**
+ * @brief Evaluate an Omaha hand
+ */
+static quint16 omaha(const char *holeCards, const char *board)
+{
+    return OmahaRules::evaluate(cardsFromString(holeCards), cardsFromString(board));
+}
+
+class TstGameRules: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testDeck() {
+        QCOMPARE(CardSet(HoldemRules::deckMask()), CardSet::fullDeck());
+        QCOMPARE(CardSet(OmahaRules::deckMask()), CardSet::fullDeck());
+        QCOMPARE(CardSet(ShortDeckRules::deckMask()).count(), 36);
+        QVERIFY(!CardSet(ShortDeckRules::deckMask()).contains(PackedCard(Card::Heart, 3)));
+        QVERIFY(CardSet(ShortDeckRules::deckMask()).contains(PackedCard(Card::Heart, 4)));
+
+        Deck deck;
+        deck.reset(CardSet(ShortDeckRules::deckMask()));
+        QCOMPARE(deck.count(), 36);
+        QCOMPARE(deck.cardSet(), CardSet(ShortDeckRules::deckMask()));
+        QCOMPARE(deck.draw(), Card(Card::Spade, 4));
+    }
+    void testHoldem() {
+        CardSet holeCards = cardsFromString("Ah Kh");
+        CardSet board = cardsFromString("Qh Jh Th 2c 2d");
+        QCOMPARE(HoldemRules::evaluate(holeCards, board), HandEvaluator::evaluate(holeCards | board));
+        QCOMPARE(HoldemRules::category(HoldemRules::evaluate(holeCards, board)),
+                 HandEvaluator::StraightFlush);
+    }
+    void testShortDeck() {
+        // A flush beats a full house
+        QVERIFY(shortDeck("Ah Kh", "Qh Jh 7h 7c 7d") > shortDeck("7s 8c", "Qh Jh 7h 7c 8d"));
+        QCOMPARE(ShortDeckRules::category(shortDeck("Ah Kh", "Qh Jh 7h 7c 7d")), HandEvaluator::Flush);
+        QCOMPARE(ShortDeckRules::category(shortDeck("7s 8c", "Qh Jh 7h 7c 8d")),
+                 HandEvaluator::FullHouse);
+        // But not a four
+        QVERIFY(shortDeck("Ah Kh", "Qh Jh 7h 7c 7d") < shortDeck("7s 8c", "Qh Jh 7h 7c 7d"));
+
+        // A6789 is the lowest straight
+        quint16 lowStraight = shortDeck("Ac 6d", "7h 8s 9c Kd Qd");
+        QCOMPARE(ShortDeckRules::category(lowStraight), HandEvaluator::Straight);
+        QVERIFY(lowStraight < shortDeck("Tc 6d", "7h 8s 9c Kd Qd"));
+        QVERIFY(lowStraight > shortDeck("9d 9h", "7h 8s 9c Kd Qd"));
+
+        // Also for straight flushes
+        quint16 lowStraightFlush = shortDeck("Ac 6c", "7c 8c 9c 9d 9h");
+        QCOMPARE(ShortDeckRules::category(lowStraightFlush), HandEvaluator::StraightFlush);
+        QVERIFY(lowStraightFlush < shortDeck("Tc 6c", "7c 8c 9c 9d 9h"));
+        QVERIFY(lowStraightFlush > shortDeck("9s 6c", "7c 8c 9c 9d 9h"));
+
+        // Other hands are the same as Texas Hold'em
+        CardSet holeCards = cardsFromString("Ac Kd");
+        CardSet board = cardsFromString("Ah Kh 7s 8c 6d");
+        QCOMPARE(ShortDeckRules::evaluate(holeCards, board), HandEvaluator::evaluate(holeCards | board));
+    }
+    void testOmaha() {
+        // Exactly two hole cards must be used
+        QCOMPARE(OmahaRules::category(omaha("Ah Kc Qd Js", "2h 5h 7h 9h Tc")), HandEvaluator::HighCard);
+        QCOMPARE(OmahaRules::category(omaha("Ah Kh Qd Js", "2h 5h 7h 9c Tc")), HandEvaluator::Flush);
+        QCOMPARE(OmahaRules::category(omaha("Ah Ad Ac Js", "2h 5h 7h 9c Tc")), HandEvaluator::Pair);
+        QCOMPARE(OmahaRules::category(omaha("Ah 2d 3c Js", "2h 2s 7h 7c Tc")), HandEvaluator::Three);
+        QCOMPARE(OmahaRules::category(omaha("2d 7d 3c Js", "2h 2s 7h 9c Tc")), HandEvaluator::FullHouse);
+
+        // Compare with the evaluation of all the hands of two hole
+        // cards and three board cards
+        qsrand(42);
+        for (int i = 0; i < 1000; i++) {
+            CardSet cards;
+            PackedCard dealt[9];
+            for (int j = 0; j < 9; j++) {
+                do {
+                    dealt[j] = PackedCard(qrand() % PackedCard::CardCount);
+                } while (cards.contains(dealt[j]));
+                cards.insert(dealt[j]);
+            }
+
+            CardSet holeCards;
+            for (int j = 0; j < 4; j++) {
+                holeCards.insert(dealt[j]);
+            }
+            CardSet board = cards - holeCards;
+
+            quint16 best = 0;
+            for (int a = 0; a < 4; a++) {
+                for (int b = a + 1; b < 4; b++) {
+                    for (int c = 4; c < 9; c++) {
+                        for (int d = c + 1; d < 9; d++) {
+                            for (int e = d + 1; e < 9; e++) {
+                                CardSet hand;
+                                hand.insert(dealt[a]);
+                                hand.insert(dealt[b]);
+                                hand.insert(dealt[c]);
+                                hand.insert(dealt[d]);
+                                hand.insert(dealt[e]);
+                                best = qMax(best, HandEvaluator::evaluate(hand));
+                            }
+                        }
+                    }
+                }
+            }
+            QCOMPARE(OmahaRules::evaluate(holeCards, board), best);
+        }
+    }
+};
+
+QTEST_MAIN(TstGameRules)
+#include "tst_gamerules.moc"
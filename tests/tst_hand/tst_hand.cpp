@@ -73,6 +73,13 @@ private slots:
               << Card(Card::Heart, 11) << Card(Card::Heart, 2);
         QVERIFY(!Hand::flush(flush).isEmpty());
 
+        // Tricky one: the cards of the flush are not consecutive
+        flush.clear();
+        flush << Card(Card::Heart, 12) << Card(Card::Club, 11) << Card(Card::Heart, 10)
+              << Card(Card::Heart, 7) << Card(Card::Heart, 3) << Card(Card::Heart, 0);
+        QCOMPARE(Hand::flush(flush).count(), 5);
+        QVERIFY(!Hand::flush(flush).contains(Card(Card::Club, 11)));
+
         QList<Card> straight;
         straight << Card(Card::Heart, 7) << Card(Card::Heart, 6) << Card(Card::Club, 5)
                  << Card(Card::Spade, 4) << Card(Card::Diamond, 3);
@@ -119,6 +126,29 @@ private slots:
             }
         }
     }
+    void testHandCombos() {
+        // A pair wins against high cards, even with a lower card
+        Hand pair;
+        pair.addCard(Card(Card::Heart, 2));
+        pair.addCard(Card(Card::Club, 2));
+        Hand highCards;
+        highCards.addCard(Card(Card::Heart, 12));
+        highCards.addCard(Card(Card::Club, 11));
+        QVERIFY(highCards < pair);
+        QVERIFY(!(pair < highCards));
+
+        // Adding the same cards in the middle
+        QList<Card> middle;
+        middle << Card(Card::Spade, 7) << Card(Card::Diamond, 8) << Card(Card::Spade, 9)
+               << Card(Card::Diamond, 3) << Card(Card::Spade, 0);
+        pair.addCards(middle);
+        highCards.addCards(middle);
+        QVERIFY(highCards < pair);
+        QVERIFY(!(pair < highCards));
+
+        // A hand is not smaller than itself
+        QVERIFY(!(pair < pair));
+    }
     // TODO: write more unit tests for all combinaisons
 };
 
@@ -0,0 +1,373 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+#include "logic/evaluatortable.h"
+#include "logic/handevaluator.h"
+#include "logic/handkernels.h"
+#include "logic/ranktables.h"
+#include "testhelpers.h"
+
+/**
+ * @brief Reference evaluation of a 5-card hand
+ *
+ * This simple evaluation creates a list starting with the
+ * category, followed by the ranks, sorted by number of cards
+ * and rank. These lists can be compared lexicographically.
+ */
+static QList<int> referenceValue5(const QList<PackedCard> &cards)
+{
+    int counts[13] = {0};
+    bool flush = true;
+    foreach (PackedCard card, cards) {
+        counts[card.index() >> 2]++;
+        flush = flush && card.suit() == cards.first().suit();
+    }
+
+    QList<int> groups;
+    for (int count = 4; count >= 1; count--) {
+        for (int rank = 12; rank >= 0; rank--) {
+            if (counts[rank] == count) {
+                groups.append(rank);
+            }
+        }
+    }
+
+    int straightHigh = -1;
+    if (groups.count() == 5) {
+        if (groups.at(0) - groups.at(4) == 4) {
+            straightHigh = groups.at(0);
+        } else if (groups.at(0) == 12 && groups.at(1) == 3) {
+            straightHigh = 3;
+        }
+    }
+
+    int category = HandEvaluator::HighCard;
+    if (straightHigh != -1 && flush) {
+        category = HandEvaluator::StraightFlush;
+    } else if (counts[groups.at(0)] == 4) {
+        category = HandEvaluator::Four;
+    } else if (counts[groups.at(0)] == 3 && counts[groups.at(1)] == 2) {
+        category = HandEvaluator::FullHouse;
+    } else if (flush) {
+        category = HandEvaluator::Flush;
+    } else if (straightHigh != -1) {
+        category = HandEvaluator::Straight;
+    } else if (counts[groups.at(0)] == 3) {
+        category = HandEvaluator::Three;
+    } else if (counts[groups.at(0)] == 2 && counts[groups.at(1)] == 2) {
+        category = HandEvaluator::TwoPairs;
+    } else if (counts[groups.at(0)] == 2) {
+        category = HandEvaluator::Pair;
+    }
+
+    QList<int> value;
+    value.append(category);
+    if (straightHigh != -1) {
+        value.append(straightHigh);
+    } else {
+        value.append(groups);
+    }
+    return value;
+}
+
+/**
+ * @brief Compare two reference values
+ */
+static bool referenceLesser(const QList<int> &value1, const QList<int> &value2)
+{
+    return std::lexicographical_compare(value1.begin(), value1.end(),
+                                        value2.begin(), value2.end());
+}
+
+/**
+ * @brief Reference evaluation of a 5, 6 or 7-card hand
+ *
+ * Returns the best value of all the 5-card hands.
+ */
+static QList<int> referenceValue(CardSet cards)
+{
+    QList<PackedCard> list;
+    foreach (PackedCard card, cards) {
+        list.append(card);
+    }
+
+    QList<int> best;
+    int n = list.count();
+    for (int mask = 0; mask < (1 << n); mask++) {
+        if (bitCount(mask) != 5) {
+            continue;
+        }
+        QList<PackedCard> hand;
+        for (int i = 0; i < n; i++) {
+            if (mask & (1 << i)) {
+                hand.append(list.at(i));
+            }
+        }
+        QList<int> value = referenceValue5(hand);
+        if (best.isEmpty() || referenceLesser(best, value)) {
+            best = value;
+        }
+    }
+    return best;
+}
+
+class TstHandEvaluator: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testCategories() {
+        QCOMPARE(HandEvaluator::category(HandEvaluator::evaluate(cardsFromString("Ah Kh Qh Jh Th 2c 2d"))),
+                 HandEvaluator::StraightFlush);
+        QCOMPARE(HandEvaluator::category(HandEvaluator::evaluate(cardsFromString("Ah 2h 3h 4h 5h Kc Kd"))),
+                 HandEvaluator::StraightFlush);
+        QCOMPARE(HandEvaluator::category(HandEvaluator::evaluate(cardsFromString("7h 7c 7s 7d 5h Kc Kd"))),
+                 HandEvaluator::Four);
+        QCOMPARE(HandEvaluator::category(HandEvaluator::evaluate(cardsFromString("7h 7c 7s 5d 5h Kc Kd"))),
+                 HandEvaluator::FullHouse);
+        QCOMPARE(HandEvaluator::category(HandEvaluator::evaluate(cardsFromString("7h 7c 7s 5d 5h 5c Kd"))),
+                 HandEvaluator::FullHouse);
+        QCOMPARE(HandEvaluator::category(HandEvaluator::evaluate(cardsFromString("Ah 9h 7h 5h 2h Kc Kd"))),
+                 HandEvaluator::Flush);
+        QCOMPARE(HandEvaluator::category(HandEvaluator::evaluate(cardsFromString("Ah 2c 3h 4d 5s Kc Kd"))),
+                 HandEvaluator::Straight);
+        QCOMPARE(HandEvaluator::category(HandEvaluator::evaluate(cardsFromString("7h 7c 7s 5d 4h Kc 2d"))),
+                 HandEvaluator::Three);
+        QCOMPARE(HandEvaluator::category(HandEvaluator::evaluate(cardsFromString("7h 7c 5s 5d 4h 4c 2d"))),
+                 HandEvaluator::TwoPairs);
+        QCOMPARE(HandEvaluator::category(HandEvaluator::evaluate(cardsFromString("7h 7c 5s 9d 4h Kc 2d"))),
+                 HandEvaluator::Pair);
+        QCOMPARE(HandEvaluator::category(HandEvaluator::evaluate(cardsFromString("7h Tc 5s 9d 4h Kc 2d"))),
+                 HandEvaluator::HighCard);
+    }
+    void testOrder() {
+        // Wheel is the smallest straight
+        QVERIFY(HandEvaluator::evaluate(cardsFromString("Ah 2c 3h 4d 5s"))
+                < HandEvaluator::evaluate(cardsFromString("2c 3h 4d 5s 6s")));
+        // Kickers are used
+        QVERIFY(HandEvaluator::evaluate(cardsFromString("Ah Ac 9h 4d 3s"))
+                < HandEvaluator::evaluate(cardsFromString("Ah Ac Th 4d 2s")));
+        QVERIFY(HandEvaluator::evaluate(cardsFromString("Kh Kc 9h 9d 3s"))
+                < HandEvaluator::evaluate(cardsFromString("Kh Kc 9h 9d 4s")));
+        // Suits are not used
+        QCOMPARE(HandEvaluator::evaluate(cardsFromString("Kh Kc 9h 9d 4s")),
+                 HandEvaluator::evaluate(cardsFromString("Ks Kd 9c 9s 4h")));
+        // Only the 5 best cards are used
+        QCOMPARE(HandEvaluator::evaluate(cardsFromString("Ah Kc Qh 9d 8s 3c 2c")),
+                 HandEvaluator::evaluate(cardsFromString("Ah Kc Qh 9d 8s 4c 3c")));
+        // With less cards, a missing kicker is weaker than any kicker
+        QVERIFY(HandEvaluator::evaluate(cardsFromString("Kh Qc"))
+                < HandEvaluator::evaluate(cardsFromString("Ah")));
+        QVERIFY(HandEvaluator::evaluate(cardsFromString("Ah"))
+                < HandEvaluator::evaluate(cardsFromString("Ah 2c")));
+        QVERIFY(HandEvaluator::evaluate(cardsFromString("Ah Ac"))
+                < HandEvaluator::evaluate(cardsFromString("Ah Ac 2c")));
+    }
+    void testRankTables() {
+        // Compare the compile-time tables with the runtime helpers
+        for (int mask = 0; mask < RankFunctions::MaskCount; mask++) {
+            QCOMPARE((int) RankTables::bitCounts[mask], bitCount(mask));
+            QCOMPARE((int) RankTables::straights[mask], straightHighCard(mask) + 1);
+        }
+
+        // Sets of kickers are sorted like their rank masks
+        int previousFive = 0;
+        int previousThree = 0;
+        for (int mask = 1; mask < RankFunctions::MaskCount; mask++) {
+            if (bitCount(mask) <= 5) {
+                QCOMPARE(RankTables::highCards[mask], quint16(RankTables::highCards[previousFive] + 1));
+                previousFive = mask;
+            }
+            if (bitCount(mask) <= 3) {
+                QCOMPARE(RankTables::threeKickers[mask], quint16(RankTables::threeKickers[previousThree] + 1));
+                previousThree = mask;
+            }
+        }
+    }
+    void testReference() {
+        // Compare random hands with the reference evaluation
+        qsrand(42);
+        QList<CardSet> hands;
+        QList<QList<int> > values;
+        for (int i = 0; i < 3000; i++) {
+            int count = 5 + i % 3;
+            CardSet cards;
+            while (cards.count() < count) {
+                cards.insert(PackedCard(qrand() % PackedCard::CardCount));
+            }
+            hands.append(cards);
+            values.append(referenceValue(cards));
+        }
+
+        for (int i = 0; i < hands.count(); i++) {
+            quint16 strength = HandEvaluator::evaluate(hands.at(i));
+            QCOMPARE((int) HandEvaluator::category(strength), values.at(i).first());
+            for (int j = 0; j < 100; j++) {
+                int k = (i + j * 31) % hands.count();
+                quint16 otherStrength = HandEvaluator::evaluate(hands.at(k));
+                QCOMPARE(strength < otherStrength, referenceLesser(values.at(i), values.at(k)));
+                QCOMPARE(strength == otherStrength, values.at(i) == values.at(k));
+            }
+        }
+    }
+    void testBatch() {
+        // Hands of 5 to 7 cards, with some bits that are not cards,
+        // and a count that is not a multiple of the size of the blocks
+        qsrand(42);
+        QVector<quint64> masks;
+        for (int i = 0; i < 4099; i++) {
+            CardSet cards;
+            while (cards.count() < 5 + i % 3) {
+                cards.insert(PackedCard(qrand() % PackedCard::CardCount));
+            }
+            quint64 mask = cards.mask();
+            if (i % 5 == 0) {
+                mask |= Q_UINT64_C(0xe000e000e000e000);
+            }
+            masks.append(mask);
+        }
+        // Some flushes and straight flushes
+        masks.append(cardsFromString("As Ks Qs Js Ts 2c 2d").mask());
+        masks.append(cardsFromString("9c 8c 7c 6c 4c 5h 5d").mask());
+        masks.append(cardsFromString("Ad 2d 3d 4d 5d 6d 7d").mask());
+
+        QVector<quint16> expected (masks.count());
+        for (int i = 0; i < masks.count(); i++) {
+            expected[i] = HandEvaluator::evaluate(CardSet(masks.at(i)));
+        }
+
+        QList<HandEvaluator::BatchKernel> kernels;
+        kernels << HandEvaluator::AutomaticKernel << HandEvaluator::ScalarKernel
+                << HandEvaluator::Sse42Kernel << HandEvaluator::Avx2Kernel;
+        QVERIFY(HandEvaluator::isBatchKernelSupported(HandEvaluator::ScalarKernel));
+        foreach (HandEvaluator::BatchKernel kernel, kernels) {
+            if (!HandEvaluator::isBatchKernelSupported(kernel)) {
+                qWarning() << "Batch kernel" << kernel << "is not supported";
+                continue;
+            }
+
+            for (int offset = 0; offset < 3; offset++) {
+                QVector<quint16> strengths (masks.count(), 0);
+                HandEvaluator::evaluateBatch(masks.constData() + offset, strengths.data() + offset,
+                                             masks.count() - offset, kernel);
+                for (int i = offset; i < masks.count(); i++) {
+                    QCOMPARE(strengths.at(i), expected.at(i));
+                }
+            }
+        }
+    }
+    void testTable() {
+        // Lowest and highest hands
+        QCOMPARE(EvaluatorTable::index(cardsFromString("2c 3c 4c 5c 6c 7c 8c")), quint32(0));
+        QCOMPARE(EvaluatorTable::index(cardsFromString("8s 9s Ts Js Qs Ks As")),
+                 quint32(EvaluatorTable::EntryCount - 1));
+
+        // Different hands have different indexes, and the table (or
+        // the fallback if the table is not available) gives the same
+        // strength than the evaluator
+        qsrand(42);
+        QList<quint32> indexes;
+        QList<CardSet> hands;
+        for (int i = 0; i < 2000; i++) {
+            CardSet cards;
+            while (cards.count() < 7) {
+                cards.insert(PackedCard(qrand() % PackedCard::CardCount));
+            }
+            if (hands.contains(cards)) {
+                continue;
+            }
+            quint32 index = EvaluatorTable::index(cards);
+            QVERIFY(index < EvaluatorTable::EntryCount);
+            QVERIFY(!indexes.contains(index));
+            indexes.append(index);
+            hands.append(cards);
+            QCOMPARE(EvaluatorTable::evaluate(cards), HandEvaluator::evaluate(cards));
+        }
+    }
+    void testTableFile() {
+        // The full table is generated by the pokqt-tablegen tool. The
+        // file format is tested on the first hands, that only use
+        // clubs and diamonds. The number of entries is not a multiple
+        // of 4, so the checksum of a partial word is tested too.
+        const quint32 entryCount = 657799;
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QString fileName = dir.path() + QLatin1String("/pokqt-evaluator.table");
+        QVERIFY(EvaluatorTable::generate(fileName, entryCount));
+        QVERIFY(EvaluatorTable::verify(fileName, entryCount));
+        QVERIFY(!EvaluatorTable::verify(fileName));
+
+        // The entries, that are after the header, are the strengths
+        // given by the evaluator
+        QList<CardSet> hands;
+        hands << cardsFromString("2c 3c 4c 5c 6c 7c 8c")
+              << cardsFromString("Ac Kc Qc Jc Tc 2d 3d")
+              << cardsFromString("7c 7d 5c 9d 4d Kc 2d")
+              << cardsFromString("6d 7d 8d 9d Td Jd Qd");
+        QFile file (fileName);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        qint64 headerSize = file.size() - qint64(entryCount) * sizeof(quint16);
+        QVERIFY(headerSize > 0);
+        foreach (CardSet hand, hands) {
+            quint16 entry = 0;
+            QVERIFY(EvaluatorTable::index(hand) < entryCount);
+            QVERIFY(file.seek(headerSize + EvaluatorTable::index(hand) * sizeof(quint16)));
+            QCOMPARE(file.read(reinterpret_cast<char *>(&entry), sizeof(entry)),
+                     qint64(sizeof(entry)));
+            QCOMPARE(entry, HandEvaluator::evaluate(hand));
+        }
+
+        // Corrupting the last entry breaks the checksum
+        char byte = 0;
+        qint64 position = file.size() - 1;
+        QVERIFY(file.seek(position));
+        QCOMPARE(file.read(&byte, 1), qint64(1));
+        byte ^= 0x1;
+        QVERIFY(file.seek(position));
+        QCOMPARE(file.write(&byte, 1), qint64(1));
+        file.close();
+        QVERIFY(!EvaluatorTable::verify(fileName, entryCount));
+
+        // Generating again replaces the file
+        QVERIFY(EvaluatorTable::generate(fileName, entryCount));
+        QVERIFY(EvaluatorTable::verify(fileName, entryCount));
+
+        // Corrupting the header is detected too
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QCOMPARE(file.write("X", 1), qint64(1));
+        file.close();
+        QVERIFY(!EvaluatorTable::verify(fileName, entryCount));
+    }
+};
+
+QTEST_MAIN(TstHandEvaluator)
+#include "tst_handevaluator.moc"
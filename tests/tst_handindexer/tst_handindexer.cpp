@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+#include "logic/handindexer.h"
+
+/**
+ * @brief Apply a permutation of the suits to cards
+ */
+static CardSet permuteSuits(CardSet cards, const int *permutation)
+{
+    quint64 mask = 0;
+    for (int i = 0; i < 4; i++) {
+        mask |= quint64(cards.suitMask(i)) << (16 * permutation[i]);
+    }
+    return CardSet(mask);
+}
+
+/**
+ * @brief Deal a random hand
+ */
+static QList<CardSet> randomHand(HandIndexer::Street street)
+{
+    QList<CardSet> streets;
+    CardSet used;
+    for (int i = HandIndexer::Preflop; i <= street; i++) {
+        CardSet cards;
+        while (cards.count() < HandIndexer::cardCount(HandIndexer::Street(i))) {
+            PackedCard card (Card::Suit(qrand() % 4 + 1), qrand() % 13);
+            if (!used.contains(card)) {
+                cards.insert(card);
+                used.insert(card);
+            }
+        }
+        streets.append(cards);
+    }
+    return streets;
+}
+
+class TstHandIndexer: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testIndexCount() {
+        QCOMPARE(HandIndexer(HandIndexer::Preflop).indexCount(), quint64(169));
+        QCOMPARE(HandIndexer(HandIndexer::Flop).indexCount(), quint64(1286792));
+        QCOMPARE(HandIndexer(HandIndexer::Turn).indexCount(), quint64(55190538));
+        QCOMPARE(HandIndexer(HandIndexer::River).indexCount(), Q_UINT64_C(2428287420));
+    }
+    void testPreflop() {
+        // All the combos give all the indexes
+        HandIndexer indexer (HandIndexer::Preflop);
+        QVector<int> counts (169, 0);
+        for (int first = 0; first < 52; first++) {
+            for (int second = first + 1; second < 52; second++) {
+                CardSet cards;
+                cards.insert(PackedCard(Card::Suit(first / 13 + 1), first % 13));
+                cards.insert(PackedCard(Card::Suit(second / 13 + 1), second % 13));
+                quint64 index = indexer.index(QList<CardSet>() << cards);
+                QVERIFY(index < 169);
+                counts[index]++;
+            }
+        }
+        for (int i = 0; i < counts.count(); i++) {
+            QVERIFY(counts.at(i) == 4 || counts.at(i) == 6 || counts.at(i) == 12);
+        }
+    }
+    void testBijection() {
+        // The indexes are a bijection with the canonical hands
+        HandIndexer preflop (HandIndexer::Preflop);
+        for (quint64 i = 0; i < preflop.indexCount(); i++) {
+            QCOMPARE(preflop.index(preflop.cards(i)), i);
+        }
+        HandIndexer flop (HandIndexer::Flop);
+        for (quint64 i = 0; i < flop.indexCount(); i++) {
+            if (flop.index(flop.cards(i)) != i) {
+                QFAIL("Invalid flop index");
+            }
+        }
+
+        for (int street = HandIndexer::Turn; street <= HandIndexer::River; street++) {
+            HandIndexer indexer ((HandIndexer::Street(street)));
+            for (int i = 0; i < 100000; i++) {
+                quint64 index = (quint64(qrand()) * RAND_MAX + qrand()) % indexer.indexCount();
+                QList<CardSet> streets = indexer.cards(index);
+                QCOMPARE(streets.count(), street + 1);
+                QCOMPARE(indexer.index(streets), index);
+            }
+            QVERIFY(indexer.cards(indexer.indexCount()).isEmpty());
+        }
+    }
+    void testIsomorphism() {
+        int permutations[24][4];
+        int permutation[4] = {0, 1, 2, 3};
+        for (int i = 0; i < 24; i++) {
+            memcpy(permutations[i], permutation, sizeof(permutation));
+            std::next_permutation(permutation, permutation + 4);
+        }
+
+        for (int street = HandIndexer::Preflop; street <= HandIndexer::River; street++) {
+            HandIndexer indexer ((HandIndexer::Street(street)));
+            for (int i = 0; i < 2000; i++) {
+                // Hands that only differ by the suits have the same index
+                QList<CardSet> streets = randomHand(HandIndexer::Street(street));
+                quint64 index = indexer.index(streets);
+                QVERIFY(index < indexer.indexCount());
+                for (int j = 0; j < 24; j++) {
+                    QList<CardSet> permuted;
+                    foreach (CardSet cards, streets) {
+                        permuted.append(permuteSuits(cards, permutations[j]));
+                    }
+                    QCOMPARE(indexer.index(permuted), index);
+                }
+
+                // And the canonical hand is one of them
+                QList<CardSet> canonical = indexer.cards(index);
+                bool found = false;
+                for (int j = 0; j < 24 && !found; j++) {
+                    bool same = true;
+                    for (int k = 0; k < streets.count(); k++) {
+                        same = same && permuteSuits(streets.at(k), permutations[j]) == canonical.at(k);
+                    }
+                    found = same;
+                }
+                QVERIFY(found);
+            }
+        }
+    }
+    void testCards() {
+        HandIndexer indexer (HandIndexer::Turn);
+        QList<Card> holeCards;
+        holeCards << Card(Card::Heart, 12) << Card(Card::Heart, 11);
+        QList<Card> board;
+        board << Card(Card::Heart, 0) << Card(Card::Heart, 5) << Card(Card::Club, 8)
+              << Card(Card::Spade, 3);
+        QList<Card> otherHoleCards;
+        otherHoleCards << Card(Card::Spade, 11) << Card(Card::Spade, 12);
+        QList<Card> otherBoard;
+        otherBoard << Card(Card::Spade, 5) << Card(Card::Diamond, 8) << Card(Card::Spade, 0)
+                   << Card(Card::Club, 3);
+        QVERIFY(indexer.index(holeCards, board) != HandIndexer::InvalidIndex);
+        QCOMPARE(indexer.index(holeCards, board), indexer.index(otherHoleCards, otherBoard));
+
+        // The same cards dealt at another street are not equivalent
+        otherBoard.swap(0, 3);
+        QVERIFY(indexer.index(holeCards, board) != indexer.index(otherHoleCards, otherBoard));
+
+        // Invalid hands
+        QCOMPARE(indexer.index(holeCards, board.mid(0, 3)), HandIndexer::InvalidIndex);
+        board[3] = Card(Card::Heart, 12);
+        QCOMPARE(indexer.index(holeCards, board), HandIndexer::InvalidIndex);
+    }
+};
+
+QTEST_MAIN(TstHandIndexer)
+#include "tst_handindexer.moc"
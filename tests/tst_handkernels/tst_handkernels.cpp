@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+#include "logic/cardset.h"
+#include "logic/handkernels.h"
+
+class TstHandKernels: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testStraights() {
+        // Check all the rank masks against a simple search
+        for (int mask = 0; mask < (1 << 13); mask++) {
+            quint16 expected = 0;
+            for (int rank = 3; rank <= 12; rank++) {
+                bool straight = true;
+                for (int i = rank - 4; i <= rank; i++) {
+                    // -1 is the ace used as a 1
+                    int bit = i >= 0 ? i : 12;
+                    straight = straight && (mask & (1 << bit));
+                }
+                if (straight) {
+                    expected |= 1 << rank;
+                }
+            }
+            QCOMPARE(straightHighCards(mask), expected);
+            QCOMPARE(straightHighCard(mask), expected != 0 ? highestBit(expected) : -1);
+        }
+
+        QCOMPARE(straightHighCard(0x100f), 3);
+        QCOMPARE(straightHighCard(0x1f00), 12);
+        QCOMPARE(straightHighCard(0x1e07), -1);
+    }
+    void testFlushes() {
+        // Check random card sets against the count of each suit
+        qsrand(42);
+        for (int i = 0; i < 10000; i++) {
+            int count = 1 + i % 20;
+            CardSet cards;
+            while (cards.count() < count) {
+                cards.insert(PackedCard(qrand() % PackedCard::CardCount));
+            }
+
+            int expected = 0;
+            for (int suit = 0; suit < 4; suit++) {
+                int suitCount = bitCount(cards.suitMask(suit));
+                QCOMPARE(int((suitCounts(cards.mask()) >> (suit * 16)) & 0xffff), suitCount);
+                if (suitCount >= 5) {
+                    expected |= 1 << suit;
+                }
+            }
+            QCOMPARE(flushSuits(cards.mask()), expected);
+            QCOMPARE(hasFlush(cards.mask()), expected != 0);
+        }
+
+        QCOMPARE(flushSuits(CardSet::fullDeck().mask()), 0xf);
+        QCOMPARE(flushSuits(0), 0);
+    }
+};
+
+QTEST_MAIN(TstHandKernels)
+#include "tst_handkernels.moc"
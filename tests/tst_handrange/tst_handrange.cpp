@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+#include "logic/handrange.h"
+#include "testhelpers.h"
+
+
+class TstHandRange: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testCombos() {
+        // Each combo has its own index
+        QList<int> indexes;
+        for (int first = 0; first < PackedCard::CardCount; first++) {
+            for (int second = first + 1; second < PackedCard::CardCount; second++) {
+                CardSet cards = CardSet(PackedCard(first)) | CardSet(PackedCard(second));
+                int index = HandRange::comboIndex(cards);
+                QVERIFY(index >= 0 && index < HandRange::ComboCount);
+                QVERIFY(!indexes.contains(index));
+                QCOMPARE(HandRange::comboCards(index), cards);
+                indexes.append(index);
+            }
+        }
+        QCOMPARE(indexes.count(), HandRange::ComboCount);
+        QCOMPARE(HandRange::comboIndex(cardsFromString("Ah")), -1);
+        QCOMPARE(HandRange::comboIndex(cardsFromString("2c 3c")), 0);
+    }
+    void testParse() {
+        HandRange range;
+        QVERIFY(range.isEmpty());
+        QCOMPARE(HandRange::fullRange().comboCount(), HandRange::ComboCount);
+
+        // Pairs, suited and offsuit hands
+        QVERIFY(range.parse("AKs, QQ+, 76s"));
+        QCOMPARE(range.comboCount(), 4 + 3 * 6 + 4);
+        QCOMPARE(range.weight(HandRange::comboIndex(cardsFromString("Ah Kh"))), 1.);
+        QCOMPARE(range.weight(HandRange::comboIndex(cardsFromString("Ah Kd"))), 0.);
+        QCOMPARE(range.weight(HandRange::comboIndex(cardsFromString("Qh Qd"))), 1.);
+        QCOMPARE(range.weight(HandRange::comboIndex(cardsFromString("Jh Jd"))), 0.);
+
+        HandRange other;
+        QVERIFY(other.parse("KAs,AA-QQ,67s"));
+        QVERIFY(range == other);
+
+        range = HandRange();
+        QVERIFY(range.parse("AK"));
+        QCOMPARE(range.comboCount(), 16);
+        range = HandRange();
+        QVERIFY(range.parse("AKo"));
+        QCOMPARE(range.comboCount(), 12);
+        range = HandRange();
+        QVERIFY(range.parse("22-55"));
+        QCOMPARE(range.comboCount(), 4 * 6);
+
+        // Increasing kickers
+        range = HandRange();
+        QVERIFY(range.parse("A2s+"));
+        QCOMPARE(range.comboCount(), 12 * 4);
+        range = HandRange();
+        QVERIFY(range.parse("KTo+"));
+        QCOMPARE(range.comboCount(), 3 * 12);
+        range = HandRange();
+        QVERIFY(range.parse("A2s-A5s"));
+        QCOMPARE(range.comboCount(), 4 * 4);
+
+        // Specific combos and weights
+        range = HandRange();
+        QVERIFY(range.parse("AhKh, QQ:0.5"));
+        QCOMPARE(range.comboCount(), 7);
+        QCOMPARE(range.weight(HandRange::comboIndex(cardsFromString("Ah Kh"))), 1.);
+        QCOMPARE(range.weight(HandRange::comboIndex(cardsFromString("Qh Qs"))), 0.5);
+        QCOMPARE(range.totalWeight(), 4.);
+
+        // Invalid ranges do not modify the range
+        QVERIFY(!range.parse("AKx"));
+        QVERIFY(!range.parse("AA, ZZ"));
+        QVERIFY(!range.parse("AhAh"));
+        QVERIFY(!range.parse("AKs-QJs"));
+        QVERIFY(!range.parse("AA:x"));
+        QCOMPARE(range.comboCount(), 7);
+    }
+    void testRemoveCards() {
+        HandRange range;
+        QVERIFY(range.parse("AA, AKs"));
+        HandRange removed = range.removeCards(cardsFromString("Ah 2c"));
+        QCOMPARE(removed.comboCount(), 3 + 3);
+        QCOMPARE(range.comboCount(), 6 + 4);
+        QCOMPARE(HandRange::fromCards(cardsFromString("Ah Kh")).comboCount(), 1);
+        QVERIFY(HandRange::fromCards(cardsFromString("Ah Kh")).removeCards(cardsFromString("Kh")).isEmpty());
+    }
+};
+
+QTEST_MAIN(TstHandRange)
+#include "tst_handrange.moc"
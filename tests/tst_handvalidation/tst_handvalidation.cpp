@@ -0,0 +1,338 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+#include <QtTest/QtTest>
+#include "logic/bestfive.h"
+#include "logic/bitops.h"
+#include "logic/hand.h"
+
+/**
+ * @brief Number of 7-card hands
+ */
+static const qint64 HAND_COUNT = Q_INT64_C(133784560);
+
+/**
+ * @brief Number of 7-card hands of each category
+ */
+static const qint64 CATEGORY_COUNTS[] = {
+    Q_INT64_C(23294460), Q_INT64_C(58627800), Q_INT64_C(31433400), Q_INT64_C(6461620),
+    Q_INT64_C(6180020), Q_INT64_C(4047644), Q_INT64_C(3473184), Q_INT64_C(224848), Q_INT64_C(41584)
+};
+
+/**
+ * @brief Number of different strengths of 7-card hands
+ */
+static const int STRENGTH_COUNT = 4824;
+
+/**
+ * @brief Number of random hands compared with the reference evaluation
+ */
+static const int SAMPLE_COUNT = 200000;
+
+/**
+ * @brief Reference evaluation of a 5-card hand
+ *
+ * This simple evaluation computes a value made of the category,
+ * followed by the ranks, sorted by number of cards and rank, as
+ * digits in base 13. These values can be compared directly.
+ */
+static int referenceValue5(const PackedCard *cards)
+{
+    int counts[13] = {0};
+    bool flush = true;
+    for (int i = 0; i < 5; i++) {
+        counts[cards[i].index() >> 2]++;
+        flush = flush && cards[i].suit() == cards[0].suit();
+    }
+
+    int groups[5];
+    int groupCount = 0;
+    for (int count = 4; count >= 1; count--) {
+        for (int rank = 12; rank >= 0; rank--) {
+            if (counts[rank] == count) {
+                groups[groupCount++] = rank;
+            }
+        }
+    }
+
+    int straightHigh = -1;
+    if (groupCount == 5) {
+        if (groups[0] - groups[4] == 4) {
+            straightHigh = groups[0];
+        } else if (groups[0] == 12 && groups[1] == 3) {
+            straightHigh = 3;
+        }
+    }
+
+    int category = HandEvaluator::HighCard;
+    if (straightHigh != -1 && flush) {
+        category = HandEvaluator::StraightFlush;
+    } else if (counts[groups[0]] == 4) {
+        category = HandEvaluator::Four;
+    } else if (counts[groups[0]] == 3 && counts[groups[1]] == 2) {
+        category = HandEvaluator::FullHouse;
+    } else if (flush) {
+        category = HandEvaluator::Flush;
+    } else if (straightHigh != -1) {
+        category = HandEvaluator::Straight;
+    } else if (counts[groups[0]] == 3) {
+        category = HandEvaluator::Three;
+    } else if (counts[groups[0]] == 2 && counts[groups[1]] == 2) {
+        category = HandEvaluator::TwoPairs;
+    } else if (counts[groups[0]] == 2) {
+        category = HandEvaluator::Pair;
+    }
+
+    int value = category;
+    for (int i = 0; i < 5; i++) {
+        int rank = 0;
+        if (straightHigh != -1) {
+            rank = i == 0 ? straightHigh : 0;
+        } else if (i < groupCount) {
+            rank = groups[i];
+        }
+        value = value * 13 + rank;
+    }
+    return value;
+}
+
+/**
+ * @brief Reference evaluation of a 7-card hand
+ *
+ * Returns the best value of the 21 5-card hands.
+ */
+static int referenceValue(const PackedCard *cards)
+{
+    int best = 0;
+    for (int skip1 = 0; skip1 < 7; skip1++) {
+        for (int skip2 = skip1 + 1; skip2 < 7; skip2++) {
+            PackedCard hand[5];
+            int count = 0;
+            for (int i = 0; i < 7; i++) {
+                if (i != skip1 && i != skip2) {
+                    hand[count++] = cards[i];
+                }
+            }
+            best = qMax(best, referenceValue5(hand));
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Results of the enumeration of all the 7-card hands
+ */
+struct Enumeration
+{
+    /**
+     * @brief Default constructor
+     */
+    explicit Enumeration()
+    {
+        memset(categoryCounts, 0, sizeof(categoryCounts));
+        memset(bestFiveCounts, 0, sizeof(bestFiveCounts));
+        memset(strengths, 0, sizeof(strengths));
+    }
+    /**
+     * @brief Mutex protecting the results
+     */
+    QMutex mutex;
+    /**
+     * @brief Number of hands of each category
+     */
+    qint64 categoryCounts[HandEvaluator::StraightFlush + 1];
+    /**
+     * @brief Number of hands of each category, according to BestFive
+     */
+    qint64 bestFiveCounts[HandEvaluator::StraightFlush + 1];
+    /**
+     * @brief Strengths that were found, as a bit array
+     */
+    quint64 strengths[65536 / 64];
+};
+
+/**
+ * @brief Task enumerating the 7-card hands starting with a card
+ *
+ * The hands are enumerated as masks built incrementally, from
+ * the lowest card to the highest one, and are evaluated like
+ * Hand does, so this does not allocate anything. The category
+ * extracted by BestFive is counted too. The counts are kept by
+ * the task, and added to the results at the end.
+ */
+class EnumerationTask: public QRunnable
+{
+public:
+    /**
+     * @brief Default constructor
+     * @param first index of the lowest card of the hands.
+     * @param enumeration results of the enumeration.
+     */
+    explicit EnumerationTask(int first, Enumeration *enumeration)
+        : m_first(first), m_enumeration(enumeration)
+    {
+    }
+    /**
+     * @brief Enumerate the hands
+     */
+    void run()
+    {
+        qint64 categoryCounts[HandEvaluator::StraightFlush + 1] = {0};
+        qint64 bestFiveCounts[HandEvaluator::StraightFlush + 1] = {0};
+        quint64 strengths[65536 / 64] = {0};
+        quint64 masks[PackedCard::CardCount];
+        for (int i = 0; i < PackedCard::CardCount; i++) {
+            masks[i] = CardSet::cardMask(PackedCard(i));
+        }
+
+        const int n = PackedCard::CardCount;
+        const quint64 m1 = masks[m_first];
+        for (int c2 = m_first + 1; c2 < n - 5; c2++) {
+            const quint64 m2 = m1 | masks[c2];
+            for (int c3 = c2 + 1; c3 < n - 4; c3++) {
+                const quint64 m3 = m2 | masks[c3];
+                for (int c4 = c3 + 1; c4 < n - 3; c4++) {
+                    const quint64 m4 = m3 | masks[c4];
+                    for (int c5 = c4 + 1; c5 < n - 2; c5++) {
+                        const quint64 m5 = m4 | masks[c5];
+                        for (int c6 = c5 + 1; c6 < n - 1; c6++) {
+                            const quint64 m6 = m5 | masks[c6];
+                            for (int c7 = c6 + 1; c7 < n; c7++) {
+                                const CardSet cards (m6 | masks[c7]);
+                                quint16 strength = HandEvaluator::evaluate(cards);
+                                categoryCounts[strength >> 12]++;
+                                bestFiveCounts[BestFive(cards).category()]++;
+                                strengths[strength >> 6] |= Q_UINT64_C(1) << (strength & 63);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        QMutexLocker locker (&m_enumeration->mutex);
+        for (int i = 0; i <= HandEvaluator::StraightFlush; i++) {
+            m_enumeration->categoryCounts[i] += categoryCounts[i];
+            m_enumeration->bestFiveCounts[i] += bestFiveCounts[i];
+        }
+        for (int i = 0; i < 65536 / 64; i++) {
+            m_enumeration->strengths[i] |= strengths[i];
+        }
+    }
+private:
+    /**
+     * @brief Index of the lowest card of the hands
+     */
+    int m_first;
+    /**
+     * @brief Results of the enumeration
+     */
+    Enumeration *m_enumeration;
+};
+
+class TstHandValidation: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testAllHands() {
+        // The hands are split by their lowest card, and the tasks with
+        // the most hands are started first
+        Enumeration enumeration;
+        QThreadPool threadPool;
+        QElapsedTimer timer;
+        timer.start();
+        for (int first = 0; first <= PackedCard::CardCount - 7; first++) {
+            threadPool.start(new EnumerationTask(first, &enumeration));
+        }
+        threadPool.waitForDone();
+        qint64 elapsed = qMax<qint64>(timer.elapsed(), 1);
+
+        qint64 total = 0;
+        for (int i = 0; i <= HandEvaluator::StraightFlush; i++) {
+            QCOMPARE(enumeration.categoryCounts[i], CATEGORY_COUNTS[i]);
+            QCOMPARE(enumeration.bestFiveCounts[i], CATEGORY_COUNTS[i]);
+            total += enumeration.categoryCounts[i];
+        }
+        QCOMPARE(total, HAND_COUNT);
+
+        int strengthCount = 0;
+        for (int i = 0; i < 65536 / 64; i++) {
+            strengthCount += bitCount(enumeration.strengths[i]);
+        }
+        QCOMPARE(strengthCount, STRENGTH_COUNT);
+
+        qDebug() << HAND_COUNT << "hands in" << elapsed << "ms, with" << threadPool.maxThreadCount()
+                 << "threads:" << qint64(HAND_COUNT * 1000. / elapsed) << "hands/s";
+    }
+    void testRandomHands() {
+        // Compare random pairs of hands with the reference evaluation
+        qsrand(42);
+        Hand previous;
+        int previousValue = 0;
+        for (int i = 0; i < SAMPLE_COUNT; i++) {
+            PackedCard cards[7];
+            CardSet cardSet;
+            for (int j = 0; j < 7; j++) {
+                do {
+                    cards[j] = PackedCard(qrand() % PackedCard::CardCount);
+                } while (cardSet.contains(cards[j]));
+                cardSet.insert(cards[j]);
+            }
+
+            Hand hand;
+            for (int j = 0; j < 7; j++) {
+                hand.addCard(cards[j].toCard());
+            }
+            const int value = referenceValue(cards);
+            QCOMPARE((int) hand.bestFive().category(), value / (13 * 13 * 13 * 13 * 13));
+
+            if (!previous.isEmpty()) {
+                quint16 strength = HandEvaluator::evaluate(hand.cardSet());
+                quint16 previousStrength = HandEvaluator::evaluate(previous.cardSet());
+                QCOMPARE(strength < previousStrength, value < previousValue);
+                QCOMPARE(strength == previousStrength, value == previousValue);
+                if (value != previousValue) {
+                    QCOMPARE(hand < previous, value < previousValue);
+                }
+            }
+            previous = hand;
+            previousValue = value;
+        }
+    }
+};
+
+QTEST_MAIN(TstHandValidation)
+#include "tst_handvalidation.moc"
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+#include "logic/gamerules.h"
+#include "logic/omahaevaluator.h"
+#include "logic/showdown.h"
+#include "testhelpers.h"
+
+/**
+ * @brief Deal random cards
+ * @param cards cards already dealt, updated.
+ * @param count number of cards to deal.
+ * @param deck cards that can be dealt.
+ * @return the dealt cards.
+ */
+static CardSet deal(CardSet &cards, int count, CardSet deck)
+{
+    QList<PackedCard> available;
+    foreach (PackedCard card, deck - cards) {
+        available.append(card);
+    }
+    CardSet dealt;
+    for (int i = 0; i < count; i++) {
+        PackedCard card = available.takeAt(qrand() % available.count());
+        dealt.insert(card);
+    }
+    cards |= dealt;
+    return dealt;
+}
+
+class TstOmahaEvaluator: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testHands() {
+        QCOMPARE(OmahaEvaluator::evaluate(cardsFromString("Ah Kc Qd Js"), cardsFromString("2h 5h 7h 9h Tc")),
+                 HandEvaluator::evaluate(cardsFromString("Ah Kc 9h 7h Tc")));
+        QCOMPARE(OmahaEvaluator::evaluate(cardsFromString("Ah Kh Qd Js"), cardsFromString("2h 5h 7h 9c Tc")),
+                 HandEvaluator::evaluate(cardsFromString("Ah Kh 5h 7h 2h")));
+        QCOMPARE(OmahaEvaluator::evaluate(cardsFromString("2d 7d 3c Js"), cardsFromString("2h 2s 7h 9c Tc")),
+                 HandEvaluator::evaluate(cardsFromString("2d 7d 2h 2s 7h")));
+        // Four of a kind with a pair in the hole and on the board
+        QCOMPARE(OmahaEvaluator::evaluate(cardsFromString("9d 9s 3c Js"), cardsFromString("9h 9c Kh 2c 4c")),
+                 HandEvaluator::evaluate(cardsFromString("9d 9s 9h 9c Kh")));
+        // Straight flush on a board with four cards of the suit
+        QCOMPARE(HandEvaluator::category(OmahaEvaluator::evaluate(cardsFromString("6h 7h 3c Js"),
+                                                                  cardsFromString("8h 9h Th Jh 2c"))),
+                 HandEvaluator::StraightFlush);
+    }
+    void testSmallHands() {
+        QCOMPARE(OmahaEvaluator::evaluate(CardSet(), cardsFromString("2h 5h 7h")), quint16(0));
+        QCOMPARE(OmahaEvaluator::evaluate(cardsFromString("Ah"), cardsFromString("2h 5h 7h")), quint16(0));
+        QCOMPARE(OmahaEvaluator::evaluate(cardsFromString("Ah Ad Kc Ks"), CardSet()),
+                 HandEvaluator::evaluate(cardsFromString("Ah Ad")));
+        QCOMPARE(OmahaEvaluator::evaluate(cardsFromString("Ah 2d Kc Ks"), cardsFromString("Kh Ac")),
+                 HandEvaluator::evaluate(cardsFromString("Kh Ac Kc Ks")));
+    }
+    void testRandomHands() {
+        // Compare with the evaluation of all the hands of two hole
+        // cards and three board cards
+        qsrand(42);
+        for (int holeCount = 2; holeCount <= OmahaEvaluator::MaxHoleCardCount; holeCount++) {
+            for (int boardCount = 0; boardCount <= 5; boardCount++) {
+                for (int i = 0; i < 500; i++) {
+                    CardSet cards;
+                    CardSet holeCards = deal(cards, holeCount, CardSet::fullDeck());
+                    CardSet board = deal(cards, boardCount, CardSet::fullDeck());
+                    QCOMPARE(OmahaEvaluator::evaluate(holeCards, board),
+                             evaluateUsingHoleCards<2>(holeCards, board));
+                }
+            }
+        }
+    }
+    void testFlushes() {
+        // Only two suits, so that there are many flushes and straight flushes
+        const CardSet deck (Q_UINT64_C(0x1fff1fff00000000));
+        qsrand(1337);
+        for (int i = 0; i < 5000; i++) {
+            CardSet cards;
+            CardSet holeCards = deal(cards, 4, deck);
+            CardSet board = deal(cards, 5, deck);
+            QCOMPARE(OmahaEvaluator::evaluate(holeCards, board),
+                     evaluateUsingHoleCards<2>(holeCards, board));
+        }
+    }
+    void testShowdown() {
+        QList<CardSet> holeCards;
+        holeCards << cardsFromString("Ah Kc Qd Js") << cardsFromString("Ad Kh Qc Jd")
+                  << cardsFromString("3c 4c 5d 6d");
+        CardSet board = cardsFromString("Ac Ks 2h 7h 9s");
+
+        // In Texas Hold'em, the third player has a straight, but
+        // in Omaha, the first two players share the pot with two pairs
+        QList<QList<int> > holdem = Showdown::rank<HoldemRules>(holeCards, board);
+        QCOMPARE(holdem.count(), 2);
+        QCOMPARE(holdem.first(), QList<int>() << 2);
+
+        QList<QList<int> > omaha = Showdown::rank<OmahaRules>(holeCards, board);
+        QCOMPARE(omaha.count(), 2);
+        QCOMPARE(omaha.first(), QList<int>() << 0 << 1);
+        QCOMPARE(omaha.last(), QList<int>() << 2);
+    }
+};
+
+QTEST_MAIN(TstOmahaEvaluator)
+#include "tst_omahaevaluator.moc"
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+#include "logic/outsanalyzer.h"
+#include "testhelpers.h"
+
+class TstOutsAnalyzer: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testValidity() {
+        OutsAnalyzer analyzer;
+        QVERIFY(!analyzer.isValid());
+        QVERIFY(!analyzer.analyze());
+
+        analyzer.setHoleCards(cardsFromString("Ah Kh"));
+        analyzer.setBoard(cardsFromString("7h 2h"));
+        QVERIFY(!analyzer.isValid());
+        analyzer.setBoard(cardsFromString("7h 2h 9c"));
+        QVERIFY(analyzer.isValid());
+        analyzer.setBoard(cardsFromString("7h 2h 9c Td"));
+        QVERIFY(analyzer.isValid());
+        analyzer.setBoard(cardsFromString("7h 2h 9c Td Jd"));
+        QVERIFY(!analyzer.isValid());
+        analyzer.setBoard(cardsFromString("7h 2h Ah"));
+        QVERIFY(!analyzer.isValid());
+        analyzer.setBoard(cardsFromString("7h 2h 9c"));
+        analyzer.setDeadCards(cardsFromString("9c"));
+        QVERIFY(!analyzer.isValid());
+    }
+    void testFlushDraw() {
+        OutsAnalyzer analyzer;
+        analyzer.setHoleCards(cardsFromString("Ah Kh"));
+        analyzer.setBoard(cardsFromString("7h 2h 9c"));
+        QVERIFY(analyzer.analyze());
+
+        QCOMPARE(analyzer.category(), HandEvaluator::HighCard);
+        QCOMPARE(analyzer.unseenCards().count(), 47);
+        QCOMPARE(analyzer.outs(HandEvaluator::Flush).count(), 9);
+        // Pairing the board also gives a pair, but it is shared
+        QCOMPARE(analyzer.outs(HandEvaluator::Pair),
+                 cardsFromString("Ac Ad As Kc Kd Ks 7c 7d 7s 2c 2d 2s 9d 9s"));
+        QCOMPARE(analyzer.sharedOuts(), cardsFromString("7c 7d 7s 2c 2d 2s 9d 9s"));
+        QCOMPARE(analyzer.outs().count(), 23);
+        QCOMPARE(analyzer.improvementProbability(), 23. / 47.);
+        QVERIFY(analyzer.riverImprovementProbability() > analyzer.improvementProbability());
+        QVERIFY(analyzer.riverImprovementProbability() < 1.);
+
+        // Dead cards are not outs
+        analyzer.setDeadCards(cardsFromString("3h 4h As"));
+        QVERIFY(analyzer.analyze());
+        QCOMPARE(analyzer.unseenCards().count(), 44);
+        QCOMPARE(analyzer.outs(HandEvaluator::Flush).count(), 7);
+        QCOMPARE(analyzer.outs(HandEvaluator::Pair).count(), 13);
+        QCOMPARE(analyzer.improvementProbability(), 20. / 44.);
+    }
+    void testSharedOuts() {
+        OutsAnalyzer analyzer;
+        analyzer.setHoleCards(cardsFromString("Ah Kd"));
+        analyzer.setBoard(cardsFromString("7c 7d 2s Qc"));
+        QVERIFY(analyzer.analyze());
+
+        QCOMPARE(analyzer.category(), HandEvaluator::Pair);
+        QCOMPARE(analyzer.outs(HandEvaluator::Three), cardsFromString("7h 7s"));
+        QVERIFY(analyzer.outs(HandEvaluator::Straight).isEmpty());
+        QCOMPARE(analyzer.improvementProbability(), analyzer.riverImprovementProbability());
+
+        // Pairing the board gives two pairs to everybody, but
+        // pairing a hole card does not
+        CardSet twoPairs = analyzer.outs(HandEvaluator::TwoPairs);
+        QVERIFY(twoPairs.contains(cardsFromString("2c Qd Ac Kh")));
+        QVERIFY(analyzer.sharedOuts().contains(cardsFromString("7h 7s 2c Qd")));
+        QVERIFY(!analyzer.sharedOuts().intersects(cardsFromString("Ac Kh Tc")));
+
+        // A shared out helps more opponents than a private one
+        PackedCard sharedOut = PackedCard(Card::Club, 0);
+        PackedCard privateOut = PackedCard(Card::Club, 12);
+        QVERIFY(analyzer.opponentHitProbability(sharedOut) > analyzer.opponentHitProbability(privateOut));
+        QVERIFY(analyzer.opponentHitProbability(privateOut) > 0.);
+        QCOMPARE(analyzer.opponentHitProbability(PackedCard(Card::Club, 3)), 0.);
+    }
+    void testNoOpponent() {
+        // On the turn, with only 2 unseen cards, there is no
+        // opponent hand left once an out is dealt
+        OutsAnalyzer analyzer;
+        analyzer.setHoleCards(cardsFromString("Ah Kh"));
+        analyzer.setBoard(cardsFromString("Qh Jh 2c 3d"));
+        analyzer.setDeadCards(CardSet::fullDeck() - cardsFromString("Ah Kh Qh Jh 2c 3d Th 4s"));
+        QVERIFY(analyzer.isValid());
+        QVERIFY(analyzer.analyze());
+        QCOMPARE(analyzer.unseenCards(), cardsFromString("Th 4s"));
+        QCOMPARE(analyzer.outs(HandEvaluator::StraightFlush), cardsFromString("Th"));
+        QCOMPARE(analyzer.opponentHitProbability(PackedCard(Card::Heart, 8)), 0.);
+        QCOMPARE(analyzer.improvementProbability(), 0.5);
+    }
+    void testRiver() {
+        // Compare the probability of improving by the river with a
+        // direct enumeration
+        OutsAnalyzer analyzer;
+        analyzer.setHoleCards(cardsFromString("8s 9s"));
+        analyzer.setBoard(cardsFromString("Ts Jd 2c"));
+        QVERIFY(analyzer.analyze());
+
+        CardSet unseen = analyzer.unseenCards();
+        quint64 hand = (analyzer.holeCards() | analyzer.board()).mask();
+        int category = HandEvaluator::category(HandEvaluator::evaluate(CardSet(hand)));
+        int improved = 0;
+        int total = 0;
+        for (CardSet::const_iterator i = unseen.begin(); i != unseen.end(); ++i) {
+            for (CardSet::const_iterator j = i; j != unseen.end(); ++j) {
+                if (*i == *j) {
+                    continue;
+                }
+                CardSet cards(hand);
+                cards.insert(*i);
+                cards.insert(*j);
+                total++;
+                if (HandEvaluator::category(HandEvaluator::evaluate(cards)) > category) {
+                    improved++;
+                }
+            }
+        }
+        QCOMPARE(total, 47 * 46 / 2);
+        QCOMPARE(analyzer.riverImprovementProbability(), double(improved) / total);
+        QCOMPARE(analyzer.outs(HandEvaluator::Straight).count(), 8);
+    }
+};
+
+QTEST_MAIN(TstOutsAnalyzer)
+#include "tst_outsanalyzer.moc"
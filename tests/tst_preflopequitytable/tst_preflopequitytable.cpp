@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+#include "logic/preflopequitytable.h"
+#include "testhelpers.h"
+
+class TstPreflopEquityTable: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testClasses() {
+        QCOMPARE(PreflopEquityTable::className(PreflopEquityTable::handClass(cardsFromString("Ah Ad"))),
+                 QString("AA"));
+        QCOMPARE(PreflopEquityTable::className(PreflopEquityTable::handClass(cardsFromString("Kh Ah"))),
+                 QString("AKs"));
+        QCOMPARE(PreflopEquityTable::className(PreflopEquityTable::handClass(cardsFromString("2c 7d"))),
+                 QString("72o"));
+        QCOMPARE(PreflopEquityTable::handClass(cardsFromString("Ah")), -1);
+        QCOMPARE(PreflopEquityTable::className(PreflopEquityTable::ClassCount), QString());
+
+        // Each combo belongs to exactly one class
+        QSet<quint64> combos;
+        for (int i = 0; i < PreflopEquityTable::ClassCount; i++) {
+            QList<CardSet> classCombos = PreflopEquityTable::classCombos(i);
+            QString name = PreflopEquityTable::className(i);
+            QCOMPARE(classCombos.count(), name.length() == 2 ? 6 : (name.endsWith("s") ? 4 : 12));
+            foreach (CardSet combo, classCombos) {
+                QCOMPARE(PreflopEquityTable::handClass(combo), i);
+                combos.insert(combo.mask());
+            }
+        }
+        QCOMPARE(combos.count(), 1326);
+    }
+    void testTable() {
+        QVERIFY(PreflopEquityTable::isAvailable());
+
+        // Known equities
+        CardSet aces = cardsFromString("Ah Ad");
+        CardSet kings = cardsFromString("Ks Kc");
+        QVERIFY(qAbs(PreflopEquityTable::equity(aces, kings) - 0.8195) < 0.0001);
+        QVERIFY(qAbs(PreflopEquityTable::equityAgainstRandom(aces, 1) - 0.852) < 0.002);
+        QCOMPARE(PreflopEquityTable::equity(aces, cardsFromString("Ah Kh")), -1.);
+        QCOMPARE(PreflopEquityTable::equityAgainstRandom(aces, 0), -1.);
+        QCOMPARE(PreflopEquityTable::equityAgainstRandom(aces, PreflopEquityTable::MaximumOpponentCount + 1),
+                 -1.);
+
+        // Entries are 16-bit fixed point numbers
+        for (int i = 0; i < PreflopEquityTable::ClassCount; i++) {
+            for (int j = 0; j < PreflopEquityTable::ClassCount; j++) {
+                double sum = PreflopEquityTable::equity(i, j) + PreflopEquityTable::equity(j, i);
+                QVERIFY(qAbs(sum - 1.) < 0.0001);
+            }
+
+            // The equity decreases with the number of opponents
+            for (int j = 1; j < PreflopEquityTable::MaximumOpponentCount; j++) {
+                QVERIFY(PreflopEquityTable::equityAgainstRandom(i, j + 1)
+                        < PreflopEquityTable::equityAgainstRandom(i, j));
+            }
+        }
+
+        // Compare some entries with a computation
+        QList<QPair<int, int> > matchups;
+        matchups << qMakePair(12 * 13 + 11, 11 * 13 + 12) << qMakePair(5 * 13 + 4, 10 * 13 + 10)
+                 << qMakePair(0, 12 * 13 + 12);
+        for (int i = 0; i < matchups.count(); i++) {
+            double equity = PreflopEquityTable::calculateEquity(matchups.at(i).first,
+                                                                matchups.at(i).second);
+            QVERIFY(qAbs(PreflopEquityTable::equity(matchups.at(i).first, matchups.at(i).second)
+                         - equity) < 0.00001);
+        }
+    }
+};
+
+QTEST_MAIN(TstPreflopEquityTable)
+#include "tst_preflopequitytable.moc"
@@ -0,0 +1,34 @@
+QT += testlib
+CONFIG += c++11
+
+win32:DEFINES += POKQT_LIBRARY
+
+INCLUDEPATH=../../src/lib/ ../
+
+HEADERS += ../../src/lib/pokqt_global.h \
+    ../testhelpers.h \
+    ../../src/lib/logic/bitops.h \
+    ../../src/lib/logic/card.h \
+    ../../src/lib/logic/cardset.h \
+    ../../src/lib/logic/packedcard.h \
+    ../../src/lib/logic/gamerules.h \
+    ../../src/lib/logic/handevaluator.h \
+    ../../src/lib/logic/handkernels.h \
+    ../../src/lib/logic/omahaevaluator.h \
+    ../../src/lib/logic/ranktables.h \
+    ../../src/lib/logic/randomgenerator.h \
+    ../../src/lib/logic/equitycalculator.h \
+    ../../src/lib/logic/preflopequitytable.h
+
+SOURCES += ../../src/lib/logic/card.cpp \
+    ../../src/lib/logic/cardset.cpp \
+    ../../src/lib/logic/packedcard.cpp \
+    ../../src/lib/logic/handevaluator.cpp \
+    ../../src/lib/logic/ranktables.cpp \
+    ../../src/lib/logic/omahaevaluator.cpp \
+    ../../src/lib/logic/randomgenerator.cpp \
+    ../../src/lib/logic/equitycalculator.cpp \
+    ../../src/lib/logic/preflopequitytable.cpp \
+    tst_preflopequitytable.cpp
+
+RESOURCES += ../../src/lib/logic/logic.qrc
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtCore/QElapsedTimer>
+#include <QtTest/QtTest>
+#include "logic/chachagenerator.h"
+#include "logic/deck.h"
+#include "logic/randomgenerator.h"
+
+/**
+ * @brief Generator returning a fixed sequence of numbers
+ */
+class SequenceGenerator: public RandomGenerator
+{
+public:
+    explicit SequenceGenerator(const QList<quint64> &values)
+        : m_values(values), m_index(0)
+    {
+    }
+    quint64 next()
+    {
+        return m_values.at(m_index++ % m_values.count());
+    }
+private:
+    QList<quint64> m_values;
+    int m_index;
+};
+
+/**
+ * @brief Draw all the cards of a deck
+ */
+static QList<Card> deckCards(Deck &deck)
+{
+    QList<Card> cards;
+    while (!deck.isEmpty()) {
+        cards.append(deck.draw());
+    }
+    return cards;
+}
+
+class TstRandomGenerator: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testSequence() {
+        // First numbers of the streams, to detect changes of the
+        // generator, that would change the seeded games
+        XoshiroGenerator generator;
+        QCOMPARE(generator.next(), Q_UINT64_C(0xfb5405f7bd79c540));
+        QCOMPARE(generator.next(), Q_UINT64_C(0x780c98e26cea5883));
+        QCOMPARE(generator.next(), Q_UINT64_C(0x2a146e0980febc66));
+
+        generator.seed(42, 1);
+        QCOMPARE(generator.next(), Q_UINT64_C(0x584870a53e6ddcdf));
+        QCOMPARE(generator.next(), Q_UINT64_C(0x24862b58ab088c44));
+        QCOMPARE(generator.next(), Q_UINT64_C(0xb77af7ea4c59709e));
+    }
+    void testStreams() {
+        XoshiroGenerator generator1 (42, 0);
+        XoshiroGenerator generator2 (42, 0);
+        XoshiroGenerator generator3 (42, 1);
+        XoshiroGenerator generator4 (43, 0);
+        int sameCount = 0;
+        for (int i = 0; i < 1000; i++) {
+            quint64 value = generator1.next();
+            QCOMPARE(generator2.next(), value);
+            if (generator3.next() == value || generator4.next() == value) {
+                sameCount++;
+            }
+        }
+        QCOMPARE(sameCount, 0);
+    }
+    void testBounded() {
+        // The numbers that would introduce a bias are rejected:
+        // with a range of 3, the lowest 2^32 mod 3 = 1 product is
+        // rejected, so 0 is drawn with the second number
+        QList<quint64> values;
+        values << 0 << (Q_UINT64_C(1) << 32) << (Q_UINT64_C(0xffffffff) << 32);
+        SequenceGenerator sequence (values);
+        QCOMPARE(sequence.bounded(3), quint32(0));
+        QCOMPARE(sequence.bounded(3), quint32(2));
+        QCOMPARE(sequence.bounded(1), quint32(0));
+
+        // Numbers are in the range, and uniformly distributed
+        XoshiroGenerator generator (7);
+        const int range = 10;
+        const int drawCount = 100000;
+        int counts[range] = {0};
+        for (int i = 0; i < drawCount; i++) {
+            quint32 value = generator.bounded(range);
+            QVERIFY(value < quint32(range));
+            counts[value]++;
+        }
+        double chiSquare = 0;
+        for (int i = 0; i < range; i++) {
+            double expected = double(drawCount) / range;
+            chiSquare += (counts[i] - expected) * (counts[i] - expected) / expected;
+        }
+        // 99.9% quantile of the chi-square distribution with 9 degrees of freedom
+        QVERIFY(chiSquare < 27.88);
+    }
+    void testShuffle() {
+        Deck deck;
+        deck.reset();
+        XoshiroGenerator generator (42, 3);
+        deck.shuffle(&generator);
+        QCOMPARE(deck.count(), 52);
+        QCOMPARE(deck.cardSet(), CardSet::fullDeck());
+        QList<Card> cards = deckCards(deck);
+        QCOMPARE(CardSet(cards), CardSet::fullDeck());
+
+        // The same seed and stream give the same deck
+        Deck other;
+        other.reset();
+        XoshiroGenerator otherGenerator (42, 3);
+        other.shuffle(&otherGenerator);
+        QCOMPARE(deckCards(other), cards);
+
+        // But not another stream
+        other.reset();
+        otherGenerator.seed(42, 4);
+        other.shuffle(&otherGenerator);
+        QVERIFY(deckCards(other) != cards);
+
+        // Without a generator, the deck is not shuffled
+        Deck sorted;
+        sorted.reset();
+        other.reset();
+        other.shuffle(0);
+        QCOMPARE(deckCards(other), deckCards(sorted));
+
+        // Only the drawn cards use random numbers
+        XoshiroGenerator reference (42, 5);
+        otherGenerator.seed(42, 5);
+        other.reset();
+        other.shuffle(&otherGenerator);
+        for (int i = 0; i < 17; i++) {
+            other.draw();
+            reference.next();
+        }
+        QCOMPARE(otherGenerator.next(), reference.next());
+
+        // A rewound deck is shuffled again
+        other.rewind();
+        QCOMPARE(other.count(), 52);
+        QVERIFY(deckCards(other) != cards);
+
+        // All the orders of a small deck have the same probability
+        QHash<int, int> counts;
+        const int shuffleCount = 60000;
+        for (int i = 0; i < shuffleCount; i++) {
+            Deck small;
+            small.reset(CardSet(Q_UINT64_C(0x7)));
+            small.shuffle(&generator);
+            int order = 0;
+            foreach (const Card &card, deckCards(small)) {
+                order = order * 13 + card.rank();
+            }
+            counts[order]++;
+        }
+        QCOMPARE(counts.count(), 6);
+        double chiSquare = 0;
+        foreach (int count, counts) {
+            double expected = shuffleCount / 6.;
+            chiSquare += (count - expected) * (count - expected) / expected;
+        }
+        // 99.9% quantile of the chi-square distribution with 5 degrees of freedom
+        QVERIFY(chiSquare < 20.52);
+    }
+    void testChaCha() {
+        // Test vector of the block function, from RFC 7539, section
+        // 2.3.2. The 32-bit counter and the 96-bit nonce of the RFC
+        // are stored as a 64-bit counter and a 64-bit nonce.
+        quint32 key[8];
+        for (int i = 0; i < 8; i++) {
+            key[i] = quint32(4 * i) | quint32(4 * i + 1) << 8 | quint32(4 * i + 2) << 16
+                     | quint32(4 * i + 3) << 24;
+        }
+        ChaChaGenerator generator (key, Q_UINT64_C(0x4a000000), Q_UINT64_C(0x0900000000000001));
+        QCOMPARE(generator.next(), Q_UINT64_C(0x15593bd1e4e7f110));
+        QCOMPARE(generator.next(), Q_UINT64_C(0xc47120a31fdd0f50));
+        QCOMPARE(generator.next(), Q_UINT64_C(0x0368c033c7f4d1c7));
+        QCOMPARE(generator.next(), Q_UINT64_C(0x4e6cd4c39aaa2204));
+        QCOMPARE(generator.next(), Q_UINT64_C(0x09aa9f07466482d2));
+        QCOMPARE(generator.next(), Q_UINT64_C(0xa2028bd905d7c214));
+        QCOMPARE(generator.next(), Q_UINT64_C(0xb94e16ded19c12b5));
+        QCOMPARE(generator.next(), Q_UINT64_C(0x4e3c50a2e883d0cb));
+
+        // Generators seeded by the system are different
+        ChaChaGenerator generator1;
+        ChaChaGenerator generator2;
+        QVERIFY(generator1.next() != generator2.next());
+
+        // Reseeding changes the stream, including across buffers
+        ChaChaGenerator generator3 (key, 0);
+        ChaChaGenerator generator4 (key, 0);
+        for (int i = 0; i < ChaChaGenerator::BufferSize + 1; i++) {
+            QCOMPARE(generator3.next(), generator4.next());
+        }
+        generator4.reseed();
+        QVERIFY(generator3.next() != generator4.next());
+
+        // A given key is not reseeded automatically: the keystream
+        // after ReseedInterval buffers continues from the counter.
+        // A block of the keystream contains 8 numbers.
+        const int count = ChaChaGenerator::BufferSize * ChaChaGenerator::ReseedInterval;
+        ChaChaGenerator generator5 (key, 0);
+        for (int i = 0; i < count; i++) {
+            generator5.next();
+        }
+        ChaChaGenerator generator6 (key, 0, count / 8);
+        for (int i = 0; i < ChaChaGenerator::BufferSize + 1; i++) {
+            QCOMPARE(generator5.next(), generator6.next());
+        }
+
+        QVERIFY(ChaChaGenerator::threadGenerator() != 0);
+        QCOMPARE(ChaChaGenerator::threadGenerator(), ChaChaGenerator::threadGenerator());
+    }
+    void testSecureShuffle() {
+        Deck deck;
+        QCOMPARE(deck.shuffleMode(), Deck::SeededShuffle);
+        deck.setShuffleMode(Deck::SecureShuffle);
+        QCOMPARE(deck.shuffleMode(), Deck::SecureShuffle);
+        deck.reset();
+        QCOMPARE(deck.shuffleMode(), Deck::SecureShuffle);
+
+        // The given generator is not used
+        XoshiroGenerator generator (42);
+        deck.shuffle(&generator);
+        QCOMPARE(deck.cardSet(), CardSet::fullDeck());
+        QList<Card> cards = deckCards(deck);
+        QCOMPARE(CardSet(cards), CardSet::fullDeck());
+        Deck other;
+        other.setShuffleMode(Deck::SecureShuffle);
+        other.reset();
+        generator.seed(42);
+        other.shuffle(&generator);
+        QVERIFY(deckCards(other) != cards);
+    }
+    void testShuffleThroughput() {
+        // Shuffle 52-card decks with both modes, and deal 17 cards,
+        // as in a 6-player hand, or the whole deck
+        const int shuffleCount = 100000;
+        const int dealtCounts[] = {17, 52};
+        XoshiroGenerator generator (42);
+        Card cards[52];
+        for (int mode = Deck::SeededShuffle; mode <= Deck::SecureShuffle; mode++) {
+            for (int j = 0; j < 2; j++) {
+                Deck deck;
+                deck.setShuffleMode(Deck::ShuffleMode(mode));
+                deck.reset();
+                QElapsedTimer timer;
+                timer.start();
+                for (int i = 0; i < shuffleCount; i++) {
+                    deck.rewind();
+                    deck.shuffle(&generator);
+                    QCOMPARE(deck.draw(cards, dealtCounts[j]), dealtCounts[j]);
+                }
+                qint64 elapsed = qMax<qint64>(timer.elapsed(), 1);
+                qDebug() << (mode == Deck::SecureShuffle ? "Secure" : "Seeded") << "shuffles, dealing"
+                         << dealtCounts[j] << "cards:" << qint64(shuffleCount * 1000. / elapsed) << "decks/s";
+            }
+        }
+    }
+};
+
+QTEST_MAIN(TstRandomGenerator)
+#include "tst_randomgenerator.moc"
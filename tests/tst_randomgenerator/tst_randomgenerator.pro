@@ -0,0 +1,24 @@
+QT += testlib
+CONFIG += c++11
+
+win32:DEFINES += POKQT_LIBRARY
+
+INCLUDEPATH=../../src/lib/
+
+HEADERS += ../../src/lib/pokqt_global.h \
+    ../../src/lib/logic/card.h \
+    ../../src/lib/logic/cardset.h \
+    ../../src/lib/logic/packedcard.h \
+    ../../src/lib/logic/chachagenerator.h \
+    ../../src/lib/logic/dealrecord.h \
+    ../../src/lib/logic/deck.h \
+    ../../src/lib/logic/randomgenerator.h
+
+SOURCES += ../../src/lib/logic/card.cpp \
+    ../../src/lib/logic/cardset.cpp \
+    ../../src/lib/logic/packedcard.cpp \
+    ../../src/lib/logic/chachagenerator.cpp \
+    ../../src/lib/logic/dealrecord.cpp \
+    ../../src/lib/logic/deck.cpp \
+    ../../src/lib/logic/randomgenerator.cpp \
+    tst_randomgenerator.cpp
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+#include <QtTest/QtTest>
+#include "logic/resultcache.h"
+
+/**
+ * @brief Value made of several words
+ */
+struct Value
+{
+    quint64 words[3];
+};
+
+/**
+ * @brief Task that uses a cache concurrently with other tasks
+ *
+ * The value of a key is the key repeated, so that values that
+ * are read while they are written are detected.
+ */
+class CacheTask: public QRunnable
+{
+public:
+    explicit CacheTask(ResultCache<Value> *cache, int seed)
+        : m_cache(cache), m_seed(seed), m_errorCount(0)
+    {
+        setAutoDelete(false);
+    }
+    void run()
+    {
+        quint64 state = m_seed;
+        for (int i = 0; i < 200000; i++) {
+            state = state * Q_UINT64_C(6364136223846793005) + 1;
+            quint64 key = (state >> 33) % 512;
+            Value value;
+            if (m_cache->find(key, &value)) {
+                for (int j = 0; j < 3; j++) {
+                    if (value.words[j] != key * (j + 1)) {
+                        m_errorCount++;
+                    }
+                }
+            } else {
+                for (int j = 0; j < 3; j++) {
+                    value.words[j] = key * (j + 1);
+                }
+                m_cache->insert(key, value);
+            }
+        }
+    }
+    int errorCount() const
+    {
+        return m_errorCount;
+    }
+private:
+    ResultCache<Value> *m_cache;
+    int m_seed;
+    int m_errorCount;
+};
+
+class TstResultCache: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testFindInsert() {
+        ResultCache<quint16> cache;
+        QVERIFY(cache.byteSize() <= ResultCache<quint16>::DefaultByteBudget);
+        QVERIFY(cache.byteSize() > ResultCache<quint16>::DefaultByteBudget / 2);
+
+        quint16 value = 0;
+        QVERIFY(!cache.find(42, &value));
+        cache.insert(42, 1234);
+        QVERIFY(cache.find(42, &value));
+        QCOMPARE(value, quint16(1234));
+        cache.insert(42, 4321);
+        QVERIFY(cache.find(42, &value));
+        QCOMPARE(value, quint16(4321));
+
+        // The key 0 is a valid key
+        QVERIFY(!cache.find(0, &value));
+        cache.insert(0, 7);
+        QVERIFY(cache.find(0, &value));
+        QCOMPARE(value, quint16(7));
+        QCOMPARE(cache.hitCount(), quint64(3));
+        QCOMPARE(cache.missCount(), quint64(2));
+
+        cache.clear();
+        QVERIFY(!cache.find(42, &value));
+        QCOMPARE(cache.hitCount(), quint64(0));
+        QCOMPARE(cache.missCount(), quint64(1));
+    }
+    void testEviction() {
+        // The smallest cache has a single bucket
+        ResultCache<quint16> cache (0);
+        QCOMPARE(cache.capacity(), ResultCache<quint16>::WayCount);
+        for (int i = 0; i < cache.capacity(); i++) {
+            cache.insert(i, i);
+        }
+
+        // An entry that was found is kept
+        quint16 value = 0;
+        QVERIFY(cache.find(0, &value));
+        cache.insert(100, 100);
+        QVERIFY(cache.find(0, &value));
+        QVERIFY(cache.find(100, &value));
+        int count = 0;
+        for (int i = 0; i < cache.capacity(); i++) {
+            count += cache.find(i, &value) ? 1 : 0;
+        }
+        QCOMPARE(count, cache.capacity() - 1);
+
+        // The size is bounded
+        ResultCache<quint16> bigCache (1 << 16);
+        for (int i = 0; i < 100000; i++) {
+            bigCache.insert(i, i);
+        }
+        count = 0;
+        for (int i = 0; i < 100000; i++) {
+            if (bigCache.find(i, &value)) {
+                QCOMPARE(value, quint16(i));
+                count++;
+            }
+        }
+        QVERIFY(count <= bigCache.capacity());
+        QVERIFY(count > bigCache.capacity() / 2);
+    }
+    void testThreads() {
+        ResultCache<Value> cache (1 << 12);
+        QThreadPool pool;
+        pool.setMaxThreadCount(4);
+        QList<CacheTask *> tasks;
+        for (int i = 0; i < 4; i++) {
+            tasks.append(new CacheTask(&cache, i));
+            pool.start(tasks.last());
+        }
+        pool.waitForDone();
+
+        foreach (CacheTask *task, tasks) {
+            QCOMPARE(task->errorCount(), 0);
+            delete task;
+        }
+        QCOMPARE(cache.hitCount() + cache.missCount(), quint64(4 * 200000));
+        QVERIFY(cache.hitCount() > 0);
+    }
+};
+
+QTEST_MAIN(TstResultCache)
+#include "tst_resultcache.moc"
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtCore/QElapsedTimer>
+#include <QtTest/QtTest>
+#include "logic/bitops.h"
+#include "logic/randomgenerator.h"
+#include "logic/samplingdeck.h"
+
+/**
+ * @brief Reference implementation of the bit selection
+ */
+static int referenceSelectBit(quint64 mask, int n)
+{
+    for (int bit = 0; bit < 64; bit++) {
+        if (mask & (Q_UINT64_C(1) << bit)) {
+            if (n == 0) {
+                return bit;
+            }
+            n--;
+        }
+    }
+    return -1;
+}
+
+class TstSamplingDeck: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testSelectBit() {
+        XoshiroGenerator generator (42);
+        QList<quint64> masks;
+        masks << 1 << ~Q_UINT64_C(0) << (Q_UINT64_C(1) << 63) << CardSet::FullMask;
+        for (int i = 0; i < 1000; i++) {
+            masks << (generator.next() & generator.next());
+        }
+
+        foreach (quint64 mask, masks) {
+            for (int n = 0; n < bitCount(mask); n++) {
+                const int bit = referenceSelectBit(mask, n);
+                QCOMPARE(selectBit(mask, n), bit);
+                QCOMPARE(SamplingDeck::selectBit(mask, n), bit);
+            }
+        }
+    }
+    void testDraw() {
+        CardSet excluded;
+        excluded.insert(PackedCard(Card::Heart, 12));
+        excluded.insert(PackedCard(Card::Spade, 12));
+        SamplingDeck deck (excluded);
+        QCOMPARE(deck.excludedCards(), excluded);
+        QCOMPARE(deck.count(), 50);
+        QCOMPARE(deck.cardSet(), CardSet::fullDeck() - excluded);
+
+        // Cards are distinct, and not excluded
+        XoshiroGenerator generator (7);
+        CardSet drawn;
+        while (!deck.isEmpty()) {
+            PackedCard card = deck.draw(generator);
+            QVERIFY(!excluded.contains(card));
+            QVERIFY(!drawn.contains(card));
+            drawn.insert(card);
+        }
+        QCOMPARE(drawn, CardSet::fullDeck() - excluded);
+
+        deck.reset();
+        QCOMPARE(deck.count(), 50);
+        CardSet cards = deck.draw(generator, 5);
+        QCOMPARE(cards.count(), 5);
+        QVERIFY(!cards.intersects(excluded));
+        QCOMPARE(deck.cardSet(), CardSet::fullDeck() - excluded - cards);
+        QCOMPARE(deck.draw(generator, 100).count(), 45);
+        QVERIFY(deck.isEmpty());
+
+        deck.setExcludedCards(CardSet::fullDeck() - excluded);
+        QCOMPARE(deck.cardSet(), excluded);
+    }
+    void testUniformity() {
+        // Each card that is not excluded has the same probability
+        CardSet excluded (Q_UINT64_C(0x00ff00ff00ff00ff));
+        SamplingDeck deck (excluded);
+        const int cardCount = deck.count();
+        const int drawCount = 200000;
+        QHash<int, int> counts;
+        XoshiroGenerator generator (11);
+        for (int i = 0; i < drawCount; i++) {
+            deck.reset();
+            counts[deck.draw(generator).index()]++;
+        }
+        QCOMPARE(counts.count(), cardCount);
+
+        double chiSquare = 0;
+        foreach (int count, counts) {
+            double expected = double(drawCount) / cardCount;
+            chiSquare += (count - expected) * (count - expected) / expected;
+        }
+        // 99.9% quantile of the chi-square distribution with 19 degrees of freedom
+        QVERIFY(chiSquare < 43.82);
+    }
+    void testThroughput() {
+        // Deal the board and the cards of an opponent, as in the
+        // trials of a simulation
+        SamplingDeck deck (CardSet(Q_UINT64_C(0x3)));
+        XoshiroGenerator generator (42);
+        const int trialCount = 1000000;
+        quint64 total = 0;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < trialCount; i++) {
+            deck.reset();
+            total += deck.draw(generator, 7).mask();
+        }
+        qint64 elapsed = qMax<qint64>(timer.elapsed(), 1);
+        QVERIFY(total != 0);
+        qDebug() << "Drawing 7 cards:" << qint64(trialCount * 1000. / elapsed) << "trials/s, PDEP"
+                 << (SamplingDeck::isBitSelectAccelerated() ? "used" : "not used");
+    }
+};
+
+QTEST_MAIN(TstSamplingDeck)
+#include "tst_samplingdeck.moc"
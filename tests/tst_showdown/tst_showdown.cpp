@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+#include "logic/showdown.h"
+#include "testhelpers.h"
+
+class TstShowdown: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testRank() {
+        QVERIFY(Showdown::rank(QList<CardSet>()).isEmpty());
+
+        // The board is shared, and two players have the same straight,
+        // with a different suit
+        QList<CardSet> hands;
+        hands << cardsFromString("2c 2d 9h Th Jc Qd 3s")
+              << cardsFromString("Kh 4c 9h Th Jc Qd 3s")
+              << cardsFromString("Ah Ac 9h Th Jc Qd 3s")
+              << cardsFromString("Ks 5d 9h Th Jc Qd 3s")
+              << cardsFromString("8s 8d 9h Th Jc Qd 3s");
+
+        QList<QList<int> > ranking = Showdown::rank(hands);
+        QCOMPARE(ranking.count(), 4);
+        QCOMPARE(ranking.at(0), QList<int>() << 1 << 3);
+        QCOMPARE(ranking.at(1), QList<int>() << 4);
+        QCOMPARE(ranking.at(2), QList<int>() << 2);
+        QCOMPARE(ranking.at(3), QList<int>() << 0);
+
+        // Everybody plays the board
+        hands.clear();
+        hands << cardsFromString("2c 3d As Ks Qs Js Ts")
+              << cardsFromString("4c 5d As Ks Qs Js Ts")
+              << cardsFromString("6c 7d As Ks Qs Js Ts");
+        ranking = Showdown::rank(hands);
+        QCOMPARE(ranking.count(), 1);
+        QCOMPARE(ranking.at(0), QList<int>() << 0 << 1 << 2);
+    }
+    void testSplitPot() {
+        QVERIFY(Showdown::splitPot(100, 0).isEmpty());
+        QCOMPARE(Showdown::splitPot(100, 1), QList<int>() << 100);
+        QCOMPARE(Showdown::splitPot(100, 2), QList<int>() << 50 << 50);
+        QCOMPARE(Showdown::splitPot(100, 3), QList<int>() << 34 << 33 << 33);
+        QCOMPARE(Showdown::splitPot(2, 4), QList<int>() << 1 << 1 << 0 << 0);
+
+        // No token is lost
+        for (int pot = 0; pot < 100; pot++) {
+            for (int winnerCount = 1; winnerCount < 10; winnerCount++) {
+                int total = 0;
+                foreach (int share, Showdown::splitPot(pot, winnerCount)) {
+                    total += share;
+                }
+                QCOMPARE(total, pot);
+            }
+        }
+    }
+};
+
+QTEST_MAIN(TstShowdown)
+#include "tst_showdown.moc"
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2013 Lucien XU <sfietkonstantin@free.fr>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * "Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * The names of its contributors may not be used to endorse or promote
+ *     products derived from this software without specific prior written
+ *     permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+ */
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+#include "logic/tableevaluator.h"
+#include "testhelpers.h"
+
+class TstTableEvaluator: public QObject
+{
+    Q_OBJECT
+private slots:
+    void testStreets() {
+        TableEvaluator evaluator;
+        QCOMPARE(evaluator.seatCount(), 0);
+
+        evaluator.reset(3);
+        QCOMPARE(evaluator.seatCount(), 3);
+        evaluator.setHoleCards(0, cardsFromString("Ah Ad"));
+        evaluator.setHoleCards(1, cardsFromString("7c 8c"));
+        evaluator.setHoleCards(2, cardsFromString("Ks Qh"));
+        QCOMPARE(evaluator.category(0), HandEvaluator::Pair);
+        QCOMPARE(evaluator.category(1), HandEvaluator::HighCard);
+        QCOMPARE(evaluator.category(2), HandEvaluator::HighCard);
+
+        // Flop
+        evaluator.addBoardCards(cardsFromString("9c Tc 2h"));
+        QCOMPARE(evaluator.board(), cardsFromString("9c Tc 2h"));
+        QCOMPARE(evaluator.category(0), HandEvaluator::Pair);
+        QCOMPARE(evaluator.category(1), HandEvaluator::HighCard);
+        QCOMPARE(evaluator.category(2), HandEvaluator::HighCard);
+
+        // Turn
+        evaluator.addBoardCards(cardsFromString("Jd"));
+        QCOMPARE(evaluator.category(0), HandEvaluator::Pair);
+        QCOMPARE(evaluator.category(1), HandEvaluator::Straight);
+        QCOMPARE(evaluator.category(2), HandEvaluator::Straight);
+        QVERIFY(evaluator.strength(1) < evaluator.strength(2));
+
+        // River
+        evaluator.addBoardCards(cardsFromString("6c"));
+        QCOMPARE(evaluator.category(0), HandEvaluator::Pair);
+        QCOMPARE(evaluator.category(1), HandEvaluator::StraightFlush);
+        QCOMPARE(evaluator.category(2), HandEvaluator::Straight);
+
+        // The strengths are the same than a full evaluation
+        for (int i = 0; i < evaluator.seatCount(); i++) {
+            QCOMPARE(evaluator.cards(i), evaluator.holeCards(i) | evaluator.board());
+            QCOMPARE(evaluator.strength(i), HandEvaluator::evaluate(evaluator.cards(i)));
+            QCOMPARE(evaluator.strengths().at(i), evaluator.strength(i));
+        }
+
+        // A new round
+        evaluator.reset(2);
+        QCOMPARE(evaluator.seatCount(), 2);
+        QVERIFY(evaluator.board().isEmpty());
+        QVERIFY(evaluator.cards(1).isEmpty());
+    }
+    void testCache() {
+        // Two tables with the same cards share the strengths
+        EvaluationCache cache;
+        TableEvaluator first;
+        TableEvaluator second;
+        first.setCache(&cache);
+        second.setCache(&cache);
+        QCOMPARE(first.cache(), &cache);
+
+        QList<TableEvaluator *> evaluators;
+        evaluators << &first << &second;
+        foreach (TableEvaluator *evaluator, evaluators) {
+            evaluator->reset(3);
+            evaluator->setHoleCards(0, cardsFromString("Ah Ad"));
+            evaluator->setHoleCards(1, cardsFromString("7h 8h"));
+            evaluator->setHoleCards(2, cardsFromString("9s Ts"));
+            evaluator->addBoardCards(cardsFromString("Ac 5h 6h"));
+            evaluator->addBoardCards(cardsFromString("Jd"));
+            evaluator->addBoardCards(cardsFromString("9h"));
+        }
+        // Each table looks up the 3 seats after the reset, after
+        // setting the hole cards, and at each street
+        QCOMPARE(cache.missCount(), quint64(3 * 5));
+        QCOMPARE(cache.hitCount(), quint64(3 * 5));
+
+        for (int i = 0; i < second.seatCount(); i++) {
+            QCOMPARE(second.strength(i), HandEvaluator::evaluate(second.cards(i)));
+            QCOMPARE(second.strength(i), first.strength(i));
+        }
+    }
+};
+
+QTEST_MAIN(TstTableEvaluator)
+#include "tst_tableevaluator.moc"